@@ -0,0 +1,382 @@
+/*
+ * 带访问模式提示的只读文件层实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/unistd.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "diskio_sdmmc.h"
+#include "sd_advise.h"
+#include "sd_bench.h"
+
+#define ADVISE_RA_NORMAL (8 * 1024)      // NORMAL/NOREUSE的预读深度
+#define ADVISE_RA_SEQUENTIAL (64 * 1024) // SEQUENTIAL的预读深度，也是WILLNEED的上限
+#define ADVISE_CLMT_INIT 64              // 簇链映射表的初始长度（DWORD数）
+#define ADVISE_BENCH_RANDOM_OPS 256      // 随机读取测试的读取次数
+
+static const char *TAG = "sd_advise";
+
+static const char *const s_advice_names[] = {
+    "NORMAL", "SEQUENTIAL", "RANDOM", "WILLNEED", "DONTNEED", "NOREUSE",
+};
+
+static size_t ra_depth(const sd_afile_t *af)
+{
+    switch (af->pattern)
+    {
+    case SD_ADVICE_SEQUENTIAL:
+        return ADVISE_RA_SEQUENTIAL;
+    case SD_ADVICE_RANDOM:
+        return 0;
+    default:
+        return ADVISE_RA_NORMAL;
+    }
+}
+
+static void drop_buffer(sd_afile_t *af)
+{
+    free(af->ra_buf);
+    af->ra_buf = NULL;
+    af->ra_cap = 0;
+    af->ra_len = 0;
+}
+
+static FRESULT card_read(sd_afile_t *af, uint32_t offset, void *buf, size_t len, UINT *br)
+{
+    *br = 0;
+    FRESULT res = FR_OK;
+    if (f_tell(&af->fil) != offset)
+    {
+        res = f_lseek(&af->fil, offset);
+    }
+    if (res == FR_OK)
+    {
+        res = f_read(&af->fil, buf, len, br);
+    }
+    if (res == FR_OK)
+    {
+        af->card_reads++;
+        af->card_bytes += *br;
+    }
+    return res;
+}
+
+/**
+ * @brief 从offset开始读取len字节到预读缓冲区，缓冲区不够大时重新分配
+ */
+static esp_err_t fill(sd_afile_t *af, uint32_t offset, size_t len)
+{
+    if (af->ra_cap < len)
+    {
+        drop_buffer(af);
+        af->ra_buf = heap_caps_malloc(len, MALLOC_CAP_DMA);
+        if (af->ra_buf == NULL)
+        {
+            ESP_LOGE(TAG, "Failed to allocate %u-byte read-ahead buffer", (unsigned)len);
+            return ESP_ERR_NO_MEM;
+        }
+        af->ra_cap = len;
+    }
+    af->ra_len = 0;
+    UINT br;
+    if (card_read(af, offset, af->ra_buf, len, &br) != FR_OK)
+    {
+        return ESP_FAIL;
+    }
+    af->ra_off = offset;
+    af->ra_len = br;
+    return ESP_OK;
+}
+
+/**
+ * @brief 构建快速定位用的簇链映射表
+ */
+static esp_err_t build_linkmap(sd_afile_t *af)
+{
+#if FF_USE_FASTSEEK
+    DWORD size = ADVISE_CLMT_INIT;
+    while (af->clmt == NULL)
+    {
+        DWORD *tbl = malloc(size * sizeof(DWORD));
+        if (tbl == NULL)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+        tbl[0] = size;
+        af->fil.cltbl = tbl;
+        FRESULT res = f_lseek(&af->fil, CREATE_LINKMAP);
+        if (res == FR_OK)
+        {
+            af->clmt = tbl;
+            break;
+        }
+        // 表太小时FatFs在tbl[0]中返回需要的长度
+        af->fil.cltbl = NULL;
+        size = tbl[0];
+        free(tbl);
+        if (res != FR_NOT_ENOUGH_CORE)
+        {
+            return ESP_FAIL;
+        }
+    }
+#endif
+    return ESP_OK;
+}
+
+esp_err_t sd_afile_open(sd_afile_t *af, sdmmc_card_t *card, const char *name)
+{
+    memset(af, 0, sizeof(*af));
+    BYTE pdrv = ff_diskio_get_pdrv_card(card);
+    if (pdrv == 0xFF)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    char path[24];
+    snprintf(path, sizeof(path), "%d:/%s", pdrv, name);
+    FRESULT res = f_open(&af->fil, path, FA_READ);
+    if (res != FR_OK)
+    {
+        ESP_LOGE(TAG, "Failed to open %s (%d)", path, res);
+        return res == FR_NO_FILE ? ESP_ERR_NOT_FOUND : ESP_FAIL;
+    }
+    af->pattern = SD_ADVICE_NORMAL;
+    return ESP_OK;
+}
+
+esp_err_t sd_afile_advise(sd_afile_t *af, uint32_t offset, uint32_t len, sd_advice_t advice)
+{
+    uint32_t size = f_size(&af->fil);
+    if (offset > size)
+    {
+        offset = size;
+    }
+    if (len == 0 || len > size - offset)
+    {
+        len = size - offset;
+    }
+
+    switch (advice)
+    {
+    case SD_ADVICE_NORMAL:
+    case SD_ADVICE_SEQUENTIAL:
+    case SD_ADVICE_NOREUSE:
+        af->pattern = advice;
+        return ESP_OK;
+    case SD_ADVICE_RANDOM:
+        // 随机读取不会用到预读数据，释放缓冲区
+        af->pattern = advice;
+        drop_buffer(af);
+        return build_linkmap(af);
+    case SD_ADVICE_WILLNEED:
+        if (len == 0)
+        {
+            return ESP_OK;
+        }
+        return fill(af, offset, len < ADVISE_RA_SEQUENTIAL ? len : ADVISE_RA_SEQUENTIAL);
+    case SD_ADVICE_DONTNEED:
+        if (af->ra_len == 0 || (offset < af->ra_off + af->ra_len && af->ra_off < offset + len))
+        {
+            drop_buffer(af);
+        }
+        return ESP_OK;
+    default:
+        return ESP_ERR_INVALID_ARG;
+    }
+}
+
+size_t sd_afile_read(sd_afile_t *af, void *buf, size_t len)
+{
+    uint8_t *dst = buf;
+    size_t done = 0;
+    while (done < len)
+    {
+        size_t want = len - done;
+        if (af->ra_len > 0 && af->pos >= af->ra_off && af->pos < af->ra_off + af->ra_len)
+        {
+            size_t n = af->ra_off + af->ra_len - af->pos;
+            n = n < want ? n : want;
+            memcpy(dst + done, af->ra_buf + (af->pos - af->ra_off), n);
+            af->pos += n;
+            done += n;
+            af->hit_bytes += n;
+            if (af->pattern == SD_ADVICE_NOREUSE && af->pos == af->ra_off + af->ra_len)
+            {
+                af->ra_len = 0;
+            }
+            continue;
+        }
+
+        size_t depth = ra_depth(af);
+        if (depth == 0 || want >= depth)
+        {
+            // 不预读或请求本身已经足够大：直接读入调用者缓冲区
+            UINT br;
+            if (card_read(af, af->pos, dst + done, want, &br) != FR_OK)
+            {
+                break;
+            }
+            af->pos += br;
+            done += br;
+            if (br < want)
+            {
+                break; // 文件末尾
+            }
+            continue;
+        }
+        if (fill(af, af->pos, depth) != ESP_OK || af->ra_len == 0)
+        {
+            break;
+        }
+    }
+    af->user_bytes += done;
+    return done;
+}
+
+esp_err_t sd_afile_seek(sd_afile_t *af, uint32_t offset)
+{
+    if (offset > f_size(&af->fil))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // 只移动逻辑位置，真正读取时才定位FatFs文件
+    af->pos = offset;
+    return ESP_OK;
+}
+
+esp_err_t sd_afile_close(sd_afile_t *af)
+{
+    FRESULT res = f_close(&af->fil);
+    drop_buffer(af);
+    free(af->clmt);
+    af->clmt = NULL;
+    return res == FR_OK ? ESP_OK : ESP_FAIL;
+}
+
+/**
+ * @brief 测试中的访问方式
+ */
+typedef enum
+{
+    ACCESS_SEQUENTIAL, // 从头到尾顺序读取
+    ACCESS_RANDOM,     // 随机位置读取
+    ACCESS_RANGE,      // 读取文件末尾的64KB
+} access_t;
+
+static esp_err_t bench_case(sdmmc_card_t *card, const char *name, access_t access, size_t req,
+                            sd_advice_t advice, uint8_t *buf)
+{
+    // 文件对象包含FIL，放在堆上以免占用主任务的栈
+    sd_afile_t *af = calloc(1, sizeof(sd_afile_t));
+    if (af == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = sd_afile_open(af, card, name);
+    if (ret != ESP_OK)
+    {
+        free(af);
+        return ret;
+    }
+    uint32_t size = f_size(&af->fil);
+    uint32_t range_off = size > ADVISE_RA_SEQUENTIAL ? size - ADVISE_RA_SEQUENTIAL : 0;
+    uint32_t rng = 0x9E3779B9;
+    int64_t start = esp_timer_get_time();
+
+    // WILLNEED作用于即将读取的范围，其余提示作用于整个文件
+    ret = sd_afile_advise(af, access == ACCESS_RANGE ? range_off : 0, 0, advice);
+    if (ret == ESP_OK)
+    {
+        switch (access)
+        {
+        case ACCESS_SEQUENTIAL:
+            while (sd_afile_read(af, buf, req) == req)
+            {
+            }
+            break;
+        case ACCESS_RANDOM:
+            for (int i = 0; i < ADVISE_BENCH_RANDOM_OPS && ret == ESP_OK; i++)
+            {
+                rng ^= rng << 13;
+                rng ^= rng >> 17;
+                rng ^= rng << 5;
+                sd_afile_seek(af, (rng % (size / req)) * req);
+                ret = sd_afile_read(af, buf, req) == req ? ESP_OK : ESP_FAIL;
+            }
+            break;
+        case ACCESS_RANGE:
+            sd_afile_seek(af, range_off);
+            while (sd_afile_read(af, buf, req) == req)
+            {
+            }
+            break;
+        }
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+
+    if (ret == ESP_OK)
+    {
+        printf("  %-12s %-10s %8.2f %10u %6.1f%% %7u\n", access == ACCESS_SEQUENTIAL ? "sequential" :
+               (access == ACCESS_RANDOM ? "random" : "tail 64K"), s_advice_names[advice],
+               (af->user_bytes / (1024.0 * 1024.0)) / (elapsed / 1000000.0), (unsigned)af->card_reads,
+               af->user_bytes ? af->hit_bytes * 100.0 / af->user_bytes : 0.0, (unsigned)(af->ra_cap / 1024));
+    }
+    sd_afile_close(af);
+    free(af);
+    return ret;
+}
+
+void sd_advise_bench_run(sdmmc_card_t *card)
+{
+    sd_bench_params_t params = SD_BENCH_PARAMS_DEFAULT();
+    params.cold_read = false;
+    sd_bench_result_t result;
+    if (sd_bench_write(&params, &result) != ESP_OK)
+    {
+        return;
+    }
+    const char *name = strrchr(params.path, '/') + 1;
+
+    static const struct
+    {
+        access_t access;
+        size_t req;
+        sd_advice_t advice;
+    } cases[] = {
+        {ACCESS_SEQUENTIAL, 4096, SD_ADVICE_NORMAL},
+        {ACCESS_SEQUENTIAL, 4096, SD_ADVICE_SEQUENTIAL},
+        {ACCESS_SEQUENTIAL, 4096, SD_ADVICE_NOREUSE},
+        {ACCESS_SEQUENTIAL, 4096, SD_ADVICE_RANDOM},
+        {ACCESS_RANDOM, 4096, SD_ADVICE_NORMAL},
+        {ACCESS_RANDOM, 4096, SD_ADVICE_RANDOM},
+        {ACCESS_RANGE, 512, SD_ADVICE_NORMAL},
+        {ACCESS_RANGE, 512, SD_ADVICE_WILLNEED},
+    };
+    uint8_t *buf = heap_caps_malloc(4096, MALLOC_CAP_DMA);
+    if (buf == NULL)
+    {
+        unlink(params.path);
+        return;
+    }
+
+    printf("\nAccess pattern hints (%u KB file, fast seek %s):\n", (unsigned)(params.file_size / 1024),
+           FF_USE_FASTSEEK ? "available" : "not compiled in");
+    printf("  %-12s %-10s %8s %10s %7s %7s\n", "access", "advice", "MB/s", "card reads", "hit%", "buf KB");
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        esp_err_t ret = bench_case(card, name, cases[i].access, cases[i].req, cases[i].advice, buf);
+        if (ret != ESP_OK)
+        {
+            printf("  case %u failed (%s)\n", (unsigned)i, esp_err_to_name(ret));
+        }
+    }
+    printf("  buf KB: read-ahead memory held at the end of the run\n\n");
+
+    free(buf);
+    unlink(params.path);
+}
@@ -0,0 +1,112 @@
+/*
+ * 带访问模式提示的只读文件层
+ *
+ * 类似posix_fadvise：调用者告诉文件层接下来如何读取文件，文件层据此调整
+ * 预读深度、预读缓冲区的保留方式和快速定位表（FatFs的fast seek）。
+ *
+ * - SD_ADVICE_NORMAL：8KB预读，不小于预读深度的请求直接读入调用者缓冲区
+ * - SD_ADVICE_SEQUENTIAL：64KB预读，小块顺序读取合并为大块读卡
+ * - SD_ADVICE_RANDOM：关闭预读，请求直接读入调用者缓冲区；构建簇链映射表，
+ *   向后定位时不必从文件开头遍历FAT链
+ * - SD_ADVICE_WILLNEED：立即把指定范围（最多64KB）读入预读缓冲区
+ * - SD_ADVICE_DONTNEED：丢弃并释放预读缓冲区
+ * - SD_ADVICE_NOREUSE：数据只读一次，预读缓冲区中的数据读完即丢弃
+ *
+ * 文件层直接使用FatFs（与VFS共享同一个卷），只支持读取。
+ * ESP-IDF v4.4的FatFs编译时关闭了FF_USE_FASTSEEK，此时RANDOM只关闭预读。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdmmc_cmd.h"
+#include "ff.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 访问模式提示
+ */
+typedef enum
+{
+    SD_ADVICE_NORMAL = 0,
+    SD_ADVICE_SEQUENTIAL,
+    SD_ADVICE_RANDOM,
+    SD_ADVICE_WILLNEED,
+    SD_ADVICE_DONTNEED,
+    SD_ADVICE_NOREUSE,
+} sd_advice_t;
+
+/**
+ * @brief 文件句柄
+ */
+typedef struct
+{
+    FIL fil;             // FatFs文件对象
+    sd_advice_t pattern; // 当前访问模式（NORMAL/SEQUENTIAL/RANDOM/NOREUSE）
+    uint32_t pos;        // 当前读取位置
+    uint8_t *ra_buf;     // 预读缓冲区（DMA可用，按需分配）
+    size_t ra_cap;       // 预读缓冲区容量
+    uint32_t ra_off;     // 缓冲区数据对应的文件偏移
+    size_t ra_len;       // 缓冲区中的有效字节数
+    DWORD *clmt;         // 快速定位的簇链映射表（仅FF_USE_FASTSEEK）
+
+    // 统计信息
+    uint32_t card_reads;  // f_read调用次数
+    uint64_t card_bytes;  // 从卡上读取的字节数
+    uint64_t hit_bytes;   // 由预读缓冲区提供的字节数
+    uint64_t user_bytes;  // 返回给调用者的字节数
+} sd_afile_t;
+
+/**
+ * @brief 以只读方式打开卡根目录下的文件，访问模式为NORMAL
+ *
+ * @param af   句柄
+ * @param card 已通过sd_mount挂载的SD卡
+ * @param name 文件名（相对根目录）
+ * @return ESP_OK 成功，ESP_ERR_NOT_FOUND 卡未挂载到FATFS或文件不存在，ESP_FAIL 其他错误
+ */
+esp_err_t sd_afile_open(sd_afile_t *af, sdmmc_card_t *card, const char *name);
+
+/**
+ * @brief 给出访问模式提示
+ *
+ * NORMAL、SEQUENTIAL、RANDOM、NOREUSE改变之后所有读取的行为，offset和len被忽略；
+ * WILLNEED和DONTNEED作用于[offset, offset + len)，len为0表示到文件末尾。
+ *
+ * @return ESP_OK 成功，ESP_ERR_NO_MEM 内存不足，ESP_FAIL 读取失败
+ */
+esp_err_t sd_afile_advise(sd_afile_t *af, uint32_t offset, uint32_t len, sd_advice_t advice);
+
+/**
+ * @brief 从当前位置读取
+ *
+ * @return 实际读取的字节数，到达文件末尾或出错时小于len
+ */
+size_t sd_afile_read(sd_afile_t *af, void *buf, size_t len);
+
+/**
+ * @brief 设置读取位置
+ */
+esp_err_t sd_afile_seek(sd_afile_t *af, uint32_t offset);
+
+/**
+ * @brief 关闭文件并释放缓冲区
+ */
+esp_err_t sd_afile_close(sd_afile_t *af);
+
+/**
+ * @brief 对不同的访问模式分别使用各种提示读取测试文件，输出吞吐量、读卡次数和缓冲区命中率
+ *
+ * @param card 已通过sd_mount挂载的SD卡
+ */
+void sd_advise_bench_run(sdmmc_card_t *card);
+
+#ifdef __cplusplus
+}
+#endif
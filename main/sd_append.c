@@ -0,0 +1,286 @@
+/*
+ * 延迟目录项更新的追加写文件层实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/unistd.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "diskio.h"
+#include "diskio_sdmmc.h"
+#include "sd_append.h"
+#include "sd_bench.h"
+
+// ff.c内部的文件状态标志：文件对象的扇区缓冲区中有未写出的数据。
+// 它不属于FatFs的公开接口，只在核对过取值的版本（R0.14、R0.14b）上使用，其他版本退回完整的f_sync
+#if FF_DEFINED == 86606 || FF_DEFINED == 86631
+#define APPEND_FA_DIRTY 0x80
+#endif
+
+#define APPEND_BENCH_RECORD 256   // 测试中每条记录的大小
+#define APPEND_BENCH_RECORDS 1000 // 测试中的记录数（每条记录后同步一次）
+#define APPEND_BENCH_NAME "APPEND.LOG"
+
+static const char *TAG = "sd_append";
+
+esp_err_t sd_append_open(sd_append_t *a, sdmmc_card_t *card, const char *name, const sd_append_config_t *config)
+{
+    memset(a, 0, sizeof(*a));
+    BYTE pdrv = ff_diskio_get_pdrv_card(card);
+    if (pdrv == 0xFF)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    char path[24];
+    snprintf(path, sizeof(path), "%d:/%s", pdrv, name);
+    FRESULT res = f_open(&a->fil, path, FA_OPEN_APPEND | FA_WRITE);
+    if (res != FR_OK)
+    {
+        ESP_LOGE(TAG, "Failed to open %s (%d)", path, res);
+        return ESP_FAIL;
+    }
+    if (config != NULL)
+    {
+        a->config = *config;
+    }
+    else
+    {
+        a->config = (sd_append_config_t)SD_APPEND_CONFIG_DEFAULT();
+    }
+    a->checkpoint_us = esp_timer_get_time();
+    return ESP_OK;
+}
+
+/**
+ * @brief 是否已超出陈旧界限，需要做检查点
+ */
+static bool stale(const sd_append_t *a)
+{
+    if (a->stale_bytes == 0)
+    {
+        return false;
+    }
+    return a->stale_bytes >= a->config.max_stale_bytes ||
+           esp_timer_get_time() - a->checkpoint_us >= (int64_t)a->config.max_stale_ms * 1000;
+}
+
+esp_err_t sd_append_checkpoint(sd_append_t *a)
+{
+    FRESULT res = f_sync(&a->fil);
+    if (res != FR_OK)
+    {
+        ESP_LOGE(TAG, "f_sync failed (%d)", res);
+        return ESP_FAIL;
+    }
+    a->checkpoints++;
+    a->stale_bytes = 0;
+    a->checkpoint_us = esp_timer_get_time();
+    return ESP_OK;
+}
+
+/**
+ * @brief 只把数据写到卡上，不改写目录项和FAT扇区
+ *
+ * 整扇区的数据f_write已经直接写到卡上，剩下的只有文件对象缓冲区中不满一个扇区的尾部。
+ */
+static esp_err_t flush_data(sd_append_t *a)
+{
+#if FF_FS_TINY || !defined(APPEND_FA_DIRTY)
+    // 数据缓冲区与卷的窗口共用，或无法确定文件缓冲区的状态标志，不能单独写出
+    return sd_append_checkpoint(a);
+#else
+    BYTE pdrv = a->fil.obj.fs->pdrv;
+    if (a->fil.flag & APPEND_FA_DIRTY)
+    {
+        if (disk_write(pdrv, a->fil.buf, a->fil.sect, 1) != RES_OK)
+        {
+            ESP_LOGE(TAG, "Failed to write sector %u", (unsigned)a->fil.sect);
+            return ESP_FAIL;
+        }
+        a->fil.flag &= (BYTE)~APPEND_FA_DIRTY;
+    }
+    if (disk_ioctl(pdrv, CTRL_SYNC, NULL) != RES_OK)
+    {
+        return ESP_FAIL;
+    }
+    a->data_flushes++;
+    return ESP_OK;
+#endif
+}
+
+esp_err_t sd_append_write(sd_append_t *a, const void *buf, size_t len)
+{
+    UINT written = 0;
+    FRESULT res = f_write(&a->fil, buf, len, &written);
+    a->stale_bytes += written;
+    if (res != FR_OK || written != len)
+    {
+        ESP_LOGE(TAG, "f_write failed (%d, %u of %u bytes)", res, (unsigned)written, (unsigned)len);
+        return ESP_FAIL;
+    }
+    if (a->config.lazy && stale(a))
+    {
+        return sd_append_checkpoint(a);
+    }
+    return ESP_OK;
+}
+
+esp_err_t sd_append_sync(sd_append_t *a)
+{
+    a->syncs++;
+    if (!a->config.lazy || stale(a))
+    {
+        return sd_append_checkpoint(a);
+    }
+    return flush_data(a);
+}
+
+esp_err_t sd_append_close(sd_append_t *a)
+{
+    FRESULT res = f_close(&a->fil);
+    if (res != FR_OK)
+    {
+        ESP_LOGE(TAG, "f_close failed (%d)", res);
+        return ESP_FAIL;
+    }
+    a->checkpoints++;
+    a->stale_bytes = 0;
+    return ESP_OK;
+}
+
+/**
+ * @brief 测试结果
+ */
+typedef struct
+{
+    int64_t elapsed_us;   // 总耗时
+    int64_t sync_us;      // 同步的累计耗时
+    uint32_t max_sync_us; // 单次同步的最长耗时
+    uint32_t checkpoints; // 检查点次数
+} append_result_t;
+
+static void sync_done(append_result_t *r, int64_t start)
+{
+    int64_t t = esp_timer_get_time() - start;
+    r->sync_us += t;
+    if (t > r->max_sync_us)
+    {
+        r->max_sync_us = t;
+    }
+}
+
+/**
+ * @brief 通过VFS写入，每条记录后fflush+fsync（应用目前的做法）
+ */
+static esp_err_t bench_vfs(const char *path, const uint8_t *record, append_result_t *r)
+{
+    FILE *f = fopen(path, "a");
+    if (f == NULL)
+    {
+        return ESP_FAIL;
+    }
+    esp_err_t ret = ESP_OK;
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < APPEND_BENCH_RECORDS && ret == ESP_OK; i++)
+    {
+        if (fwrite(record, 1, APPEND_BENCH_RECORD, f) != APPEND_BENCH_RECORD)
+        {
+            ret = ESP_FAIL;
+            break;
+        }
+        int64_t t = esp_timer_get_time();
+        ret = fflush(f) == 0 && fsync(fileno(f)) == 0 ? ESP_OK : ESP_FAIL;
+        sync_done(r, t);
+    }
+    if (fclose(f) != 0)
+    {
+        ret = ESP_FAIL;
+    }
+    r->elapsed_us = esp_timer_get_time() - start;
+    r->checkpoints = APPEND_BENCH_RECORDS;
+    return ret;
+}
+
+static esp_err_t bench_append(sdmmc_card_t *card, const sd_append_config_t *config, const uint8_t *record,
+                              append_result_t *r)
+{
+    // 文件层包含FIL，放在堆上以免占用主任务的栈
+    sd_append_t *a = calloc(1, sizeof(sd_append_t));
+    if (a == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = sd_append_open(a, card, APPEND_BENCH_NAME, config);
+    if (ret != ESP_OK)
+    {
+        free(a);
+        return ret;
+    }
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < APPEND_BENCH_RECORDS && ret == ESP_OK; i++)
+    {
+        ret = sd_append_write(a, record, APPEND_BENCH_RECORD);
+        if (ret == ESP_OK)
+        {
+            int64_t t = esp_timer_get_time();
+            ret = sd_append_sync(a);
+            sync_done(r, t);
+        }
+    }
+    if (sd_append_close(a) != ESP_OK)
+    {
+        ret = ESP_FAIL;
+    }
+    r->elapsed_us = esp_timer_get_time() - start;
+    r->checkpoints = a->checkpoints;
+    free(a);
+    return ret;
+}
+
+void sd_append_bench_run(sdmmc_card_t *card)
+{
+    static const struct
+    {
+        const char *label;
+        bool vfs;
+        sd_append_config_t config;
+    } cases[] = {
+        {"vfs fsync", true, {0}},
+        {"f_sync", false, {.lazy = false}},
+        {"lazy 16K/1s", false, {.lazy = true, .max_stale_bytes = 16 * 1024, .max_stale_ms = 1000}},
+        {"lazy 64K/1s", false, SD_APPEND_CONFIG_DEFAULT()},
+        {"lazy 256K/5s", false, {.lazy = true, .max_stale_bytes = 256 * 1024, .max_stale_ms = 5000}},
+    };
+    const char *path = MOUNT_POINT "/" APPEND_BENCH_NAME;
+    uint8_t record[APPEND_BENCH_RECORD];
+    for (int i = 0; i < APPEND_BENCH_RECORD; i++)
+    {
+        record[i] = (i % 64 == 63) ? '\n' : 'a' + i % 26;
+    }
+
+    printf("\nFsync-heavy appends (%d x %d B records, sync after each):\n", APPEND_BENCH_RECORDS,
+           APPEND_BENCH_RECORD);
+    printf("  %-14s %9s %10s %12s %12s %12s\n", "mode", "KB/s", "records/s", "avg sync ms", "max sync ms",
+           "checkpoints");
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        unlink(path);
+        append_result_t r = {0};
+        esp_err_t ret = cases[i].vfs ? bench_vfs(path, record, &r) : bench_append(card, &cases[i].config, record, &r);
+        if (ret != ESP_OK)
+        {
+            printf("  %-14s failed\n", cases[i].label);
+            continue;
+        }
+        double seconds = r.elapsed_us / 1000000.0;
+        printf("  %-14s %9.1f %10.0f %12.2f %12.2f %12u\n", cases[i].label,
+               APPEND_BENCH_RECORDS * APPEND_BENCH_RECORD / 1024.0 / seconds, APPEND_BENCH_RECORDS / seconds,
+               r.sync_us / 1000.0 / APPEND_BENCH_RECORDS, r.max_sync_us / 1000.0, (unsigned)r.checkpoints);
+    }
+    printf("\n");
+    unlink(path);
+}
@@ -0,0 +1,110 @@
+/*
+ * 延迟目录项更新的追加写文件层
+ *
+ * FatFs的f_sync（VFS的fsync）除了写出数据扇区，还要改写文件的目录项（大小、起始簇、
+ * 修改时间）、写出缓存中被修改的FAT扇区，FAT32上还要更新FSINFO扇区。追加写时每次同步
+ * 都多出几次单扇区写入，而单扇区写在SD卡上的代价与写一大块相近。
+ *
+ * 延迟模式下sd_append_sync只把数据扇区写到卡上，目录项和FAT扇区留到检查点再写：
+ * - 距上一个检查点追加的数据达到max_stale_bytes，或时间超过max_stale_ms时，下一次
+ *   sd_append_write/sd_append_sync自动做一次检查点（完整的f_sync）
+ * - sd_append_checkpoint和sd_append_close总是做检查点
+ *
+ * 掉电后文件内容与最后一个检查点一致：目录项中的大小最多落后max_stale_bytes字节
+ * 或max_stale_ms毫秒的数据（以调用者持续写入或同步为前提，本层没有后台定时器）。
+ * 检查点之后同步过的数据已经在卡上，但不在文件大小范围内，恢复时需要调用者自行扫描。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "sdmmc_cmd.h"
+#include "ff.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 追加写配置
+ */
+typedef struct
+{
+    bool lazy;                // 延迟目录项更新；false时每次sd_append_sync都是完整的f_sync
+    uint32_t max_stale_bytes; // 两个检查点之间最多追加的字节数
+    uint32_t max_stale_ms;    // 两个检查点之间的最长时间
+} sd_append_config_t;
+
+// 默认配置：延迟模式，最多落后64KB或1秒
+#define SD_APPEND_CONFIG_DEFAULT()       \
+    {                                    \
+        .lazy = true,                    \
+        .max_stale_bytes = 64 * 1024,    \
+        .max_stale_ms = 1000,            \
+    }
+
+/**
+ * @brief 追加写句柄
+ */
+typedef struct
+{
+    FIL fil;                   // FatFs文件对象
+    sd_append_config_t config; // 配置
+    uint32_t stale_bytes;      // 上一个检查点之后追加的字节数
+    int64_t checkpoint_us;     // 上一个检查点的时间
+
+    // 统计信息
+    uint32_t syncs;         // sd_append_sync调用次数
+    uint32_t checkpoints;   // 检查点（完整f_sync）次数
+    uint32_t data_flushes;  // 只写数据扇区的同步次数
+} sd_append_t;
+
+/**
+ * @brief 打开卡根目录下的文件用于追加写，文件不存在时创建
+ *
+ * @param a    句柄
+ * @param card 已通过sd_mount挂载的SD卡
+ * @param name 文件名（相对根目录）
+ * @param config 配置，NULL表示使用SD_APPEND_CONFIG_DEFAULT
+ * @return ESP_OK 成功，ESP_ERR_NOT_FOUND 卡未挂载到FATFS，ESP_FAIL 打开失败
+ */
+esp_err_t sd_append_open(sd_append_t *a, sdmmc_card_t *card, const char *name, const sd_append_config_t *config);
+
+/**
+ * @brief 在文件末尾追加数据
+ *
+ * @return ESP_OK 成功，ESP_FAIL 写入失败或卡已满
+ */
+esp_err_t sd_append_write(sd_append_t *a, const void *buf, size_t len);
+
+/**
+ * @brief 把已追加的数据写到卡上
+ *
+ * 延迟模式下只写数据扇区，超出陈旧界限时做检查点；非延迟模式下等同于f_sync。
+ */
+esp_err_t sd_append_sync(sd_append_t *a);
+
+/**
+ * @brief 立即做检查点：写出数据、目录项和FAT扇区
+ */
+esp_err_t sd_append_checkpoint(sd_append_t *a);
+
+/**
+ * @brief 做检查点并关闭文件
+ */
+esp_err_t sd_append_close(sd_append_t *a);
+
+/**
+ * @brief 以每条记录后同步一次的方式追加写，对比VFS fsync、完整f_sync和延迟目录项更新的吞吐量与同步延迟
+ *
+ * @param card 已通过sd_mount挂载的SD卡
+ */
+void sd_append_bench_run(sdmmc_card_t *card);
+
+#ifdef __cplusplus
+}
+#endif
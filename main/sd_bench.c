@@ -0,0 +1,411 @@
+/*
+ * SD卡读写速度测试套件实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <sys/unistd.h>
+#include <sys/stat.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_system.h"
+#include "sd_bench.h"
+#include "sd_trace.h"
+
+static const char *TAG = "example";
+
+/**
+ * @brief 根据起止时间填写测试结果
+ */
+static void fill_result(sd_bench_result_t *result, size_t bytes, int64_t start_time, int64_t end_time)
+{
+    result->bytes = bytes;
+    result->seconds = (end_time - start_time) / 1000000.0;
+    result->speed_mb = (bytes / (1024.0 * 1024.0)) / result->seconds;
+    result->valid = true;
+}
+
+/**
+ * @brief 在计时区间内采样一次内存使用，采样（遍历堆）的耗时从计时中扣除
+ */
+static void sample_untimed(sd_bench_result_t *result, int64_t *start_time)
+{
+    int64_t t = esp_timer_get_time();
+    sd_mem_track_sample(&result->mem);
+    *start_time += esp_timer_get_time() - t;
+}
+
+/**
+ * @brief 按指定模式填充写入缓冲区
+ */
+static void fill_pattern(uint8_t *buffer, size_t size, sd_bench_pattern_t pattern)
+{
+    switch (pattern)
+    {
+    case SD_BENCH_PATTERN_ZERO:
+        memset(buffer, 0, size);
+        break;
+    case SD_BENCH_PATTERN_RANDOM:
+        esp_fill_random(buffer, size);
+        break;
+    default:
+        for (size_t i = 0; i < size; i++)
+        {
+            buffer[i] = i & 0xFF;
+        }
+        break;
+    }
+}
+
+/**
+ * @brief SD卡写入速度测试函数
+ *
+ * 该函数通过以下步骤测试SD卡的写入速度：
+ * 1. 创建一个指定大小(buf_size)的DMA兼容缓冲区
+ * 2. 按params->pattern填充缓冲区（默认为规律数据）
+ * 3. 创建测试文件并打开
+ * 4. 通过多次写入缓冲区数据，直到达到指定的测试文件大小(file_size)
+ * 5. 使用高精度计时器计算写入速度
+ *
+ * 注意：
+ * - 函数会先检查并删除已存在的测试文件；params->preallocated时保留预分配的文件并覆盖写入
+ * - 写入完成后会执行fsync确保数据真正写入到SD卡
+ * - 缓冲区使用DMA兼容内存，SDMMC和SDSPI均可直接DMA传输而无需中转拷贝
+ * - 如果分配缓冲区失败或文件操作失败，函数会提前返回
+ */
+esp_err_t sd_bench_write(const sd_bench_params_t *params, sd_bench_result_t *result)
+{
+    memset(result, 0, sizeof(*result));
+    ESP_LOGI(TAG, "Testing write speed...");
+    sd_mem_track_begin(&result->mem);
+
+    // 检查并删除可能存在的旧测试文件
+    struct stat st;
+    if (!params->preallocated && stat(params->path, &st) == 0)
+    {
+        unlink(params->path);
+    }
+
+    // 创建DMA兼容的测试数据缓冲区
+    uint8_t *buffer = heap_caps_malloc(params->buf_size, MALLOC_CAP_DMA);
+    if (buffer == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate buffer");
+        sd_mem_track_end(&result->mem);
+        return ESP_ERR_NO_MEM;
+    }
+    // 填充缓冲区
+    fill_pattern(buffer, params->buf_size, params->pattern);
+
+    // 创建测试文件
+    ESP_LOGI(TAG, "Opening file for writing: %s", params->path);
+    // 预分配的文件不能用"w"打开，否则会被截断为0
+    FILE *f = fopen(params->path, params->preallocated ? "r+" : "w");
+    if (f == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to open file for writing (errno: %d, path: %s)", errno, params->path);
+        free(buffer);
+        sd_mem_track_end(&result->mem);
+        return ESP_FAIL;
+    }
+
+    // 开始计时
+    int64_t start_time = esp_timer_get_time();
+
+    // 写入测试数据
+    esp_err_t ret = ESP_OK;
+    size_t bytes_written = 0;
+    while (bytes_written < params->file_size)
+    {
+        size_t to_write = params->file_size - bytes_written;
+        if (to_write > params->buf_size)
+        {
+            to_write = params->buf_size;
+        }
+        int64_t op_start = esp_timer_get_time();
+        size_t written = fwrite(buffer, 1, to_write, f);
+        uint32_t op_us = esp_timer_get_time() - op_start;
+        result->max_op_us = op_us > result->max_op_us ? op_us : result->max_op_us;
+        if (written != to_write)
+        {
+            ESP_LOGE(TAG, "Write failed");
+            ret = ESP_FAIL;
+            break;
+        }
+        SD_TRACE(BENCH, TAG, "Wrote %d bytes, total %d/%d", (int)written, (int)(bytes_written + written), (int)params->file_size);
+        if (bytes_written == 0)
+        {
+            // 第一次写入后stdio缓冲区已分配
+            sample_untimed(result, &start_time);
+        }
+        bytes_written += written;
+    }
+
+    // 确保数据写入到卡上
+    fflush(f);
+    fsync(fileno(f));
+    fclose(f);
+
+    // 计算写入速度
+    int64_t end_time = esp_timer_get_time();
+    fill_result(result, bytes_written, start_time, end_time);
+    result->valid = (ret == ESP_OK);
+
+    ESP_LOGI(TAG, "Write speed: %.2f MB/s (%.2f seconds for %d bytes)",
+             result->speed_mb, result->seconds, (int)bytes_written);
+
+    free(buffer);
+    sd_mem_track_end(&result->mem);
+    return ret;
+}
+
+/**
+ * @brief SD卡读取速度测试函数
+ *
+ * 该函数通过以下步骤测试SD卡的读取速度：
+ * 1. 创建一个指定大小(buf_size)的DMA兼容缓冲区
+ * 2. 打开由写入测试创建的文件
+ * 3. 循环读取文件内容到缓冲区，直到读取完整个文件(file_size)
+ * 4. 使用高精度计时器计算读取速度
+ *
+ * 注意：
+ * - 测试文件不会被删除，由调用者决定何时删除
+ * - 如果分配缓冲区失败或文件操作失败，函数会提前返回
+ * - 此函数应该在sd_bench_write之后调用
+ */
+esp_err_t sd_bench_read(const sd_bench_params_t *params, sd_bench_result_t *result)
+{
+    memset(result, 0, sizeof(*result));
+    ESP_LOGI(TAG, "Testing read speed...");
+    sd_mem_track_begin(&result->mem);
+
+    // 创建DMA兼容的读取缓冲区
+    uint8_t *buffer = heap_caps_malloc(params->buf_size, MALLOC_CAP_DMA);
+    if (buffer == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate buffer");
+        sd_mem_track_end(&result->mem);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // 打开测试文件
+    ESP_LOGI(TAG, "Opening file for reading: %s", params->path);
+    FILE *f = fopen(params->path, "r");
+    if (f == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to open file for reading (errno: %d, path: %s)", errno, params->path);
+        free(buffer);
+        sd_mem_track_end(&result->mem);
+        return ESP_FAIL;
+    }
+
+    // 开始计时
+    int64_t start_time = esp_timer_get_time();
+
+    // 读取测试数据
+    esp_err_t ret = ESP_OK;
+    size_t bytes_read = 0;
+    while (bytes_read < params->file_size)
+    {
+        size_t to_read = params->file_size - bytes_read;
+        if (to_read > params->buf_size)
+        {
+            to_read = params->buf_size;
+        }
+
+        int64_t op_start = esp_timer_get_time();
+        size_t read = fread(buffer, 1, to_read, f);
+        uint32_t op_us = esp_timer_get_time() - op_start;
+        result->max_op_us = op_us > result->max_op_us ? op_us : result->max_op_us;
+        if (read != to_read)
+        {
+            ESP_LOGE(TAG, "Read partial/failed: read=%d, expected=%d, bytes_read_total=%d, ferror=%d, feof=%d",
+                     (int)read, (int)to_read, (int)bytes_read, ferror(f), feof(f));
+            if (ferror(f))
+            {
+                ESP_LOGE(TAG, "Read failed with error %d", errno);
+            }
+            else
+            {
+                ESP_LOGW(TAG, "Unexpected EOF at %d bytes", (int)bytes_read);
+            }
+            ret = ESP_FAIL;
+            break;
+        }
+        // 每次成功读取后，打印进度（仅在启用EXAMPLE_TRACE_BENCH时编译）
+        SD_TRACE(BENCH, TAG, "Read %d bytes, total %d/%d", (int)read, (int)bytes_read + (int)read, (int)params->file_size);
+        if (bytes_read == 0)
+        {
+            // 第一次读取后stdio缓冲区已分配
+            sample_untimed(result, &start_time);
+        }
+        bytes_read += read;
+    }
+    fclose(f);
+
+    // 计算读取速度
+    int64_t end_time = esp_timer_get_time();
+    fill_result(result, bytes_read, start_time, end_time);
+    result->valid = (ret == ESP_OK);
+
+    ESP_LOGI(TAG, "Read speed: %.2f MB/s (%.2f seconds for %d bytes)",
+             result->speed_mb, result->seconds, (int)bytes_read);
+
+    free(buffer);
+    sd_mem_track_end(&result->mem);
+    return ret;
+}
+
+esp_err_t sd_bench_random(const sd_bench_params_t *params, size_t block_size, int count, bool write,
+                          sd_bench_result_t *result)
+{
+    memset(result, 0, sizeof(*result));
+    size_t blocks = block_size ? params->file_size / block_size : 0;
+    if (blocks == 0 || count <= 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ESP_LOGI(TAG, "Testing random %s: %d x %d bytes...", write ? "write" : "read", count, (int)block_size);
+    sd_mem_track_begin(&result->mem);
+
+    uint8_t *buffer = heap_caps_malloc(block_size, MALLOC_CAP_DMA);
+    if (buffer == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate buffer");
+        sd_mem_track_end(&result->mem);
+        return ESP_ERR_NO_MEM;
+    }
+    fill_pattern(buffer, block_size, params->pattern);
+
+    FILE *f = fopen(params->path, write ? "r+" : "r");
+    if (f == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to open file (errno: %d, path: %s)", errno, params->path);
+        free(buffer);
+        sd_mem_track_end(&result->mem);
+        return ESP_FAIL;
+    }
+    // 随机访问时stdio缓冲没有意义，直接把请求交给FATFS
+    setvbuf(f, NULL, _IONBF, 0);
+
+    int64_t start_time = esp_timer_get_time();
+    esp_err_t ret = ESP_OK;
+    int done = 0;
+    for (; done < count; done++)
+    {
+        long offset = (long)(esp_random() % blocks) * block_size;
+        size_t n = 0;
+        if (fseek(f, offset, SEEK_SET) == 0)
+        {
+            n = write ? fwrite(buffer, 1, block_size, f) : fread(buffer, 1, block_size, f);
+        }
+        if (n != block_size)
+        {
+            ESP_LOGE(TAG, "Random %s failed at offset %ld", write ? "write" : "read", offset);
+            ret = ESP_FAIL;
+            break;
+        }
+        if (done == 0)
+        {
+            sample_untimed(result, &start_time);
+        }
+    }
+    if (write)
+    {
+        fsync(fileno(f));
+    }
+    fclose(f);
+
+    int64_t end_time = esp_timer_get_time();
+    fill_result(result, (size_t)done * block_size, start_time, end_time);
+    result->valid = (ret == ESP_OK);
+
+    ESP_LOGI(TAG, "Random %s: %.1f IOPS, %.2f MB/s",
+             write ? "write" : "read", done / result->seconds, result->speed_mb);
+
+    free(buffer);
+    sd_mem_track_end(&result->mem);
+    return ret;
+}
+
+void sd_bench_run_suite(sd_mount_t *mnt, const sd_bench_params_t *params, sd_bench_report_t *report)
+{
+    memset(report, 0, sizeof(*report));
+    strlcpy(report->label, sd_mount_bus_name(&mnt->params), sizeof(report->label));
+    report->freq_khz = mnt->card ? mnt->card->max_freq_khz : 0;
+
+    if (sd_bench_write(params, &report->write) == ESP_OK)
+    {
+        if (params->cold_read)
+        {
+            // 卸载后重新挂载：SD卡重新初始化（CMD0复位），
+            // FATFS窗口、FAT缓存和每文件缓存全部丢弃，模拟开机后的首次读取
+            ESP_LOGI(TAG, "Remounting card for cold read");
+            sd_mount_params_t mount_params = mnt->params;
+            sd_unmount(mnt);
+            if (sd_mount(&mount_params, mnt) != ESP_OK)
+            {
+                ESP_LOGE(TAG, "Remount failed, skipping read tests");
+                return;
+            }
+            sd_bench_read(params, &report->read_cold);
+        }
+        sd_bench_read(params, &report->read_warm);
+    }
+
+    // 删除测试文件
+    unlink(params->path);
+}
+
+/**
+ * @brief 格式化速度，无效结果显示为"-"
+ */
+static void format_speed(const sd_bench_result_t *result, char *buf, size_t size)
+{
+    if (result->valid)
+    {
+        snprintf(buf, size, "%.2f", result->speed_mb);
+    }
+    else
+    {
+        strlcpy(buf, "-", size);
+    }
+}
+
+void sd_bench_print_reports(const sd_bench_report_t *reports, size_t count)
+{
+    printf("\n%-14s %9s %12s %12s %12s\n", "Bus", "Clock", "Write MB/s", "Cold read", "Warm read");
+    for (size_t i = 0; i < count; i++)
+    {
+        const sd_bench_report_t *r = &reports[i];
+        char write_str[16];
+        char cold_str[16];
+        char warm_str[16];
+        format_speed(&r->write, write_str, sizeof(write_str));
+        format_speed(&r->read_cold, cold_str, sizeof(cold_str));
+        format_speed(&r->read_warm, warm_str, sizeof(warm_str));
+        printf("%-14s %6d kHz %12s %12s %12s\n", r->label, r->freq_khz, write_str, cold_str, warm_str);
+    }
+    printf("\n");
+
+    // 内存使用情况：before为分配缓冲区前，during为测试过程中的最小值，after为释放缓冲区后
+    char label[40];
+    for (size_t i = 0; i < count; i++)
+    {
+        const sd_bench_report_t *r = &reports[i];
+        snprintf(label, sizeof(label), "%s write", r->label);
+        sd_mem_print(label, &r->write.mem);
+        if (r->read_cold.valid)
+        {
+            snprintf(label, sizeof(label), "%s cold read", r->label);
+            sd_mem_print(label, &r->read_cold.mem);
+        }
+        snprintf(label, sizeof(label), "%s warm read", r->label);
+        sd_mem_print(label, &r->read_warm.mem);
+    }
+    printf("\n");
+}
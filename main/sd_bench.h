@@ -0,0 +1,149 @@
+/*
+ * SD卡读写速度测试套件
+ *
+ * 测试函数与挂载方式无关，SDMMC和SDSPI共用同一套测试，
+ * 便于在同一张卡上对比不同总线的读写速度。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "sd_mount.h"
+#include "sd_mem_stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 定义SD卡读写速度测试相关参数
+#define TEST_BUFFER_SIZE (128 * 1024)          // 每次读写的缓冲区大小：128KB（提升读写性能）
+#define TEST_FILE_SIZE (4 * 1024 * 1024)       // 测试文件总大小：4MB（增大文件以获得更准确的速度测试）
+#define TEST_FILE_PATH MOUNT_POINT "/test.txt" // 测试文件路径（使用.txt扩展名避免兼容性问题）
+
+#ifdef CONFIG_EXAMPLE_BENCH_COLD_READ
+#define SD_BENCH_COLD_READ true
+#else
+#define SD_BENCH_COLD_READ false
+#endif
+
+/**
+ * @brief 写入测试使用的数据
+ */
+typedef enum
+{
+    SD_BENCH_PATTERN_SEQ = 0, // 0x00~0xFF循环（默认）
+    SD_BENCH_PATTERN_ZERO,    // 全0
+    SD_BENCH_PATTERN_RANDOM,  // 随机数据（每次测试重新生成一个缓冲区）
+} sd_bench_pattern_t;
+
+/**
+ * @brief 测试参数
+ */
+typedef struct
+{
+    const char *path;           // 测试文件路径
+    size_t buf_size;            // 每次读写的缓冲区大小
+    size_t file_size;           // 测试文件总大小
+    bool cold_read;             // 写入后卸载并重新挂载，再测冷缓存读取速度
+    sd_bench_pattern_t pattern; // 写入数据
+    bool preallocated;          // 测试文件已由调用者预分配：写入测试不删除文件，以"r+"打开覆盖写入
+} sd_bench_params_t;
+
+// 默认测试参数
+#define SD_BENCH_PARAMS_DEFAULT()        \
+    {                                    \
+        .path = TEST_FILE_PATH,          \
+        .buf_size = TEST_BUFFER_SIZE,    \
+        .file_size = TEST_FILE_SIZE,     \
+        .cold_read = SD_BENCH_COLD_READ, \
+        .pattern = SD_BENCH_PATTERN_SEQ, \
+        .preallocated = false,           \
+    }
+
+/**
+ * @brief 单项测试结果
+ */
+typedef struct
+{
+    bool valid;         // 测试是否成功完成
+    size_t bytes;       // 实际读写的字节数
+    float seconds;      // 耗时（秒）
+    float speed_mb;     // 速度（MB/s）
+    uint32_t max_op_us; // 单次fwrite/fread的最长耗时（微秒）
+    sd_mem_usage_t mem; // 测试前、中、后的堆和栈使用情况
+} sd_bench_result_t;
+
+/**
+ * @brief 一种总线配置下的完整测试结果
+ */
+typedef struct
+{
+    char label[24];          // 总线名称，例如"SDMMC 4-bit"
+    int freq_khz;            // 实际工作频率（kHz）
+    sd_bench_result_t write;     // 写入测试结果
+    sd_bench_result_t read_cold; // 重新挂载后的首次读取（仅cold_read时有效）
+    sd_bench_result_t read_warm; // 同一挂载下的读取（cold_read时为第二次读取）
+} sd_bench_report_t;
+
+/**
+ * @brief SD卡写入速度测试
+ *
+ * @param params 测试参数
+ * @param result 输出的测试结果
+ * @return ESP_OK 成功，ESP_ERR_NO_MEM 缓冲区分配失败，ESP_FAIL 文件操作失败
+ */
+esp_err_t sd_bench_write(const sd_bench_params_t *params, sd_bench_result_t *result);
+
+/**
+ * @brief SD卡读取速度测试，需在sd_bench_write之后调用
+ *
+ * @param params 测试参数（应与写入测试相同）
+ * @param result 输出的测试结果
+ * @return ESP_OK 成功，ESP_ERR_NO_MEM 缓冲区分配失败，ESP_FAIL 文件操作失败
+ */
+esp_err_t sd_bench_read(const sd_bench_params_t *params, sd_bench_result_t *result);
+
+/**
+ * @brief 随机读写测试：在params->path的前params->file_size字节内，
+ *        以block_size对齐的随机偏移读取（或覆盖写入）count次
+ *
+ * 测试文件必须已存在且不小于file_size（例如先调用sd_bench_write并保留文件）。
+ * 结果中的speed_mb为有效数据吞吐量，IOPS为count / seconds。
+ *
+ * @param params     测试参数（使用path和file_size）
+ * @param block_size 每次读写的大小
+ * @param count      读写次数
+ * @param write      true为随机覆盖写入，false为随机读取
+ * @param result     输出的测试结果
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数错误，ESP_ERR_NO_MEM 缓冲区分配失败，ESP_FAIL 文件操作失败
+ */
+esp_err_t sd_bench_random(const sd_bench_params_t *params, size_t block_size, int count, bool write,
+                          sd_bench_result_t *result);
+
+/**
+ * @brief 在当前已挂载的卡上运行完整测试套件（写入+读取），结束后删除测试文件
+ *
+ * 如果params->cold_read为true，写入完成后卸载并以相同参数重新挂载
+ * （SD卡重新初始化，FATFS窗口和文件缓存全部丢弃），先测冷缓存读取，
+ * 再在同一挂载下测热缓存读取。否则只在写入后直接读取一次（热缓存）。
+ *
+ * @param mnt    当前挂载状态；重新挂载时会被更新，失败时mnt->card为NULL
+ * @param params 测试参数
+ * @param report 输出的测试报告
+ */
+void sd_bench_run_suite(sd_mount_t *mnt, const sd_bench_params_t *params, sd_bench_report_t *report);
+
+/**
+ * @brief 以表格形式并排打印多种总线配置的测试结果，随后打印各项测试的内存使用情况
+ *
+ * @param reports 测试报告数组
+ * @param count   报告数量
+ */
+void sd_bench_print_reports(const sd_bench_report_t *reports, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
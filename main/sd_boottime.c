@@ -0,0 +1,367 @@
+/*
+ * SD卡初始化与挂载的分阶段计时实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include "esp_rom_sys.h"
+#include "driver/sdmmc_defs.h"
+#include "sd_boottime.h"
+
+#define BOOT_POLL_US 1000          // 快速初始化时ACMD41的重试间隔
+#define BOOT_POLL_MAX_US 1000000   // 快速初始化最多轮询的时间，超时后交回驱动处理
+#define BOOT_KNOWN_MAGIC 0x5DB0071Eu
+#define BOOT_BENCH_RUNS 3          // 测试中每种方式的挂载次数
+
+static const char *TAG = "sd_boottime";
+
+typedef esp_err_t (*do_transaction_fn)(int slot, sdmmc_command_t *cmd);
+typedef esp_err_t (*set_card_clk_fn)(int slot, uint32_t freq_khz);
+typedef esp_err_t (*set_bus_width_fn)(int slot, size_t width);
+
+/**
+ * @brief 上次成功初始化的卡，放在RTC_NOINIT内存中，软件复位后仍保留
+ */
+typedef struct
+{
+    uint32_t magic;   // BOOT_KNOWN_MAGIC表示记录有效
+    sdmmc_cid_t cid;  // 卡的CID
+    bool sdio;        // 是否为SDIO卡
+    uint32_t check;   // magic和CID的校验值，上电后内容随机
+} known_card_t;
+
+static RTC_NOINIT_ATTR known_card_t s_known;
+
+static do_transaction_fn s_orig_transaction;
+static set_card_clk_fn s_orig_set_clk;
+static set_bus_width_fn s_orig_set_width;
+static bool s_spi;         // 主机为SDSPI
+static bool s_app;         // 上一条命令是CMD55，当前命令是应用命令
+static sd_boot_stage_t s_stage;
+static int64_t s_begin_us;
+static int64_t s_stage_start_us;
+static sd_boottime_t s_cur;
+static sd_boottime_t s_last;
+
+static const char *const s_stage_names[SD_BOOT_STAGE_MAX] = {
+    "host init", "CMD0 reset", "CMD8 if cond", "SDIO probe", "ACMD41 ready", "CID/RCA",
+    "CSD", "select/SCR", "bus width", "high speed", "FS mount",
+};
+
+static uint32_t known_checksum(const known_card_t *k)
+{
+    uint32_t sum = k->magic ^ (k->sdio ? 0xA5A5A5A5u : 0);
+    const uint8_t *p = (const uint8_t *)&k->cid;
+    for (size_t i = 0; i < sizeof(k->cid); i++)
+    {
+        sum = (sum << 5 | sum >> 27) ^ p[i];
+    }
+    return sum;
+}
+
+static bool known_valid(void)
+{
+    return s_known.magic == BOOT_KNOWN_MAGIC && s_known.check == known_checksum(&s_known);
+}
+
+/**
+ * @brief 切换到新阶段，把从上一阶段开始到现在的时间计入上一阶段
+ */
+static void enter_stage(sd_boot_stage_t stage)
+{
+    int64_t now = esp_timer_get_time();
+    if (stage == s_stage)
+    {
+        return;
+    }
+    s_cur.stage_us[s_stage] += now - s_stage_start_us;
+    s_stage = stage;
+    s_stage_start_us = now;
+}
+
+/**
+ * @brief 命令所属的阶段，SD_BOOT_STAGE_MAX表示不改变阶段（CMD55、CMD13、CMD16等）
+ */
+static sd_boot_stage_t stage_of(const sdmmc_command_t *cmd, bool app)
+{
+    switch (cmd->opcode)
+    {
+    case MMC_GO_IDLE_STATE:
+        return SD_BOOT_RESET;
+    case SD_SEND_IF_COND:
+        return SD_BOOT_IF_COND;
+    case SD_IO_SEND_OP_COND:
+    case SD_IO_RW_DIRECT:
+        return SD_BOOT_SDIO_PROBE;
+    case SD_APP_OP_COND:
+    case MMC_SEND_OP_COND:
+    case SD_READ_OCR:
+    case SD_CRC_ON_OFF:
+        return SD_BOOT_OP_COND;
+    case MMC_ALL_SEND_CID:
+    case SD_SEND_RELATIVE_ADDR:
+    case MMC_SEND_CID:
+        return SD_BOOT_CID;
+    case MMC_SEND_CSD:
+        return SD_BOOT_CSD;
+    case MMC_SELECT_CARD:
+    case SD_APP_SEND_SCR:
+        return SD_BOOT_SELECT;
+    case SD_SEND_SWITCH_FUNC: // 与SD_APP_SET_BUS_WIDTH同为6
+        return app ? SD_BOOT_BUS_WIDTH : SD_BOOT_HIGH_SPEED;
+    case MMC_READ_BLOCK_SINGLE:
+    case MMC_READ_BLOCK_MULTIPLE:
+        return SD_BOOT_FS;
+    default:
+        return SD_BOOT_STAGE_MAX;
+    }
+}
+
+static bool op_cond_ready(const sdmmc_command_t *cmd)
+{
+    if (s_spi)
+    {
+        return (SD_SPI_R1(cmd->response) & SD_SPI_R1_IDLE_STATE) == 0;
+    }
+    return (MMC_R3(cmd->response) & MMC_OCR_MEM_READY) != 0;
+}
+
+/**
+ * @brief ACMD41报告卡忙时以较短的间隔重发CMD55+ACMD41，直到卡就绪或超时
+ *
+ * 就绪后把响应写回cmd，驱动看到的是一次成功的ACMD41，不再进入10ms的重试等待。
+ */
+static esp_err_t poll_op_cond(int slot, sdmmc_command_t *cmd)
+{
+    int64_t deadline = esp_timer_get_time() + BOOT_POLL_MAX_US;
+    while (esp_timer_get_time() < deadline)
+    {
+        esp_rom_delay_us(BOOT_POLL_US);
+        // 初始化阶段还没有分配RCA，CMD55的参数为0
+        sdmmc_command_t app_cmd = {
+            .opcode = MMC_APP_CMD,
+            .flags = s_spi ? SCF_RSP_R1 : (SCF_CMD_AC | SCF_RSP_R1),
+            .timeout_ms = cmd->timeout_ms,
+        };
+        esp_err_t ret = s_orig_transaction(slot, &app_cmd);
+        if (ret != ESP_OK || app_cmd.error != ESP_OK)
+        {
+            return ret;
+        }
+        sdmmc_command_t retry = *cmd;
+        ret = s_orig_transaction(slot, &retry);
+        s_cur.extra_polls++;
+        if (ret != ESP_OK || retry.error != ESP_OK)
+        {
+            return ret;
+        }
+        memcpy(cmd->response, retry.response, sizeof(cmd->response));
+        if (op_cond_ready(cmd))
+        {
+            break;
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t boot_transaction(int slot, sdmmc_command_t *cmd)
+{
+    bool app = s_app;
+    s_app = false;
+    sd_boot_stage_t stage = stage_of(cmd, app);
+    if (stage != SD_BOOT_STAGE_MAX)
+    {
+        enter_stage(stage);
+    }
+    s_cur.commands++;
+
+    if (s_cur.probe_skipped && (cmd->opcode == SD_IO_SEND_OP_COND || cmd->opcode == SD_IO_RW_DIRECT))
+    {
+        // 已知的存储卡不会响应SDIO复位（CMD52）和CMD5，直接按无响应处理
+        cmd->error = ESP_ERR_TIMEOUT;
+        return ESP_ERR_TIMEOUT;
+    }
+
+    esp_err_t ret = s_orig_transaction(slot, cmd);
+    if (ret != ESP_OK || cmd->error != ESP_OK)
+    {
+        return ret;
+    }
+    if (cmd->opcode == MMC_APP_CMD)
+    {
+        s_app = true;
+    }
+    // 只处理带电压范围的ACMD41；SD模式下参数为0的ACMD41只是查询OCR
+    else if (s_cur.fast && app && cmd->opcode == SD_APP_OP_COND && (s_spi || (cmd->arg & 0x00FFFFFF) != 0) &&
+             !op_cond_ready(cmd))
+    {
+        poll_op_cond(slot, cmd);
+    }
+    return ret;
+}
+
+static esp_err_t boot_set_card_clk(int slot, uint32_t freq_khz)
+{
+    enter_stage(SD_BOOT_HIGH_SPEED);
+    return s_orig_set_clk(slot, freq_khz);
+}
+
+static esp_err_t boot_set_bus_width(int slot, size_t width)
+{
+    enter_stage(SD_BOOT_BUS_WIDTH);
+    return s_orig_set_width(slot, width);
+}
+
+void sd_boottime_begin(bool fast)
+{
+    memset(&s_cur, 0, sizeof(s_cur));
+    s_cur.fast = fast;
+    s_cur.probe_skipped = fast && known_valid() && !s_known.sdio;
+    s_app = false;
+    s_stage = SD_BOOT_HOST;
+    s_begin_us = esp_timer_get_time();
+    s_stage_start_us = s_begin_us;
+}
+
+void sd_boottime_hook(sdmmc_host_t *host)
+{
+    s_spi = (host->flags & SDMMC_HOST_FLAG_SPI) != 0;
+    s_orig_transaction = host->do_transaction;
+    host->do_transaction = &boot_transaction;
+    s_orig_set_clk = host->set_card_clk;
+    if (host->set_card_clk != NULL)
+    {
+        host->set_card_clk = &boot_set_card_clk;
+    }
+    s_orig_set_width = host->set_bus_width;
+    if (host->set_bus_width != NULL)
+    {
+        host->set_bus_width = &boot_set_bus_width;
+    }
+}
+
+void sd_boottime_end(sdmmc_card_t *card)
+{
+    int64_t now = esp_timer_get_time();
+    s_cur.stage_us[s_stage] += now - s_stage_start_us;
+    s_cur.total_us = now - s_begin_us;
+
+    if (card != NULL)
+    {
+        // 卡保存的是主机配置的副本，恢复其中的驱动函数
+        card->host.do_transaction = s_orig_transaction;
+        card->host.set_card_clk = s_orig_set_clk;
+        card->host.set_bus_width = s_orig_set_width;
+
+        if (known_valid() && memcmp(&s_known.cid, &card->cid, sizeof(card->cid)) != 0)
+        {
+            s_cur.card_changed = true;
+            ESP_LOGW(TAG, "Card changed since the last init");
+        }
+        memset(&s_known, 0, sizeof(s_known));
+        s_known.magic = BOOT_KNOWN_MAGIC;
+        s_known.cid = card->cid;
+        s_known.sdio = card->is_sdio;
+        s_known.check = known_checksum(&s_known);
+    }
+    else if (s_cur.probe_skipped)
+    {
+        // 跳过探测后初始化失败，可能换成了SDIO卡等：清除记录，下次挂载正常探测
+        ESP_LOGW(TAG, "Init failed with the SDIO probe skipped, forgetting the known card");
+        sd_boottime_forget();
+    }
+    s_last = s_cur;
+}
+
+void sd_boottime_get(sd_boottime_t *out)
+{
+    *out = s_last;
+}
+
+void sd_boottime_forget(void)
+{
+    s_known.magic = 0;
+}
+
+void sd_boottime_print(const char *const *labels, const sd_boottime_t *runs, size_t count)
+{
+    printf("Card init breakdown (ms):\n");
+    printf("  %-14s", "stage");
+    for (size_t i = 0; i < count; i++)
+    {
+        printf(" %10s", labels[i]);
+    }
+    printf("\n");
+    for (int s = 0; s < SD_BOOT_STAGE_MAX; s++)
+    {
+        printf("  %-14s", s_stage_names[s]);
+        for (size_t i = 0; i < count; i++)
+        {
+            printf(" %10.2f", runs[i].stage_us[s] / 1000.0);
+        }
+        printf("\n");
+    }
+    printf("  %-14s", "total");
+    for (size_t i = 0; i < count; i++)
+    {
+        printf(" %10.2f", runs[i].total_us / 1000.0);
+    }
+    printf("\n  %-14s", "commands");
+    for (size_t i = 0; i < count; i++)
+    {
+        printf(" %10u", (unsigned)runs[i].commands);
+    }
+    printf("\n");
+}
+
+/**
+ * @brief 以fast_init挂载runs次，返回各阶段的平均耗时
+ */
+static bool bench_mode(const sd_mount_params_t *params, bool fast, sd_boottime_t *avg)
+{
+    sd_mount_params_t p = *params;
+    p.fast_init = fast;
+    memset(avg, 0, sizeof(*avg));
+    avg->fast = fast;
+    for (int r = 0; r < BOOT_BENCH_RUNS; r++)
+    {
+        sd_mount_t mnt;
+        if (sd_mount(&p, &mnt) != ESP_OK)
+        {
+            return false;
+        }
+        sd_boottime_t bt;
+        sd_boottime_get(&bt);
+        sd_unmount(&mnt);
+        for (int s = 0; s < SD_BOOT_STAGE_MAX; s++)
+        {
+            avg->stage_us[s] += bt.stage_us[s] / BOOT_BENCH_RUNS;
+        }
+        avg->total_us += bt.total_us / BOOT_BENCH_RUNS;
+        avg->commands += bt.commands;
+        avg->extra_polls += bt.extra_polls;
+        avg->probe_skipped |= bt.probe_skipped;
+    }
+    avg->commands /= BOOT_BENCH_RUNS;
+    return true;
+}
+
+void sd_boottime_bench_run(const sd_mount_params_t *params)
+{
+    sd_boottime_t runs[2];
+    if (!bench_mode(params, false, &runs[0]) || !bench_mode(params, true, &runs[1]))
+    {
+        ESP_LOGE(TAG, "Mount failed, init timing aborted");
+        return;
+    }
+    static const char *const labels[] = {"normal", "fast"};
+    printf("\nMount timing, average of %d mounts (%s):\n", BOOT_BENCH_RUNS, sd_mount_bus_name(params));
+    sd_boottime_print(labels, runs, 2);
+    printf("  fast init: %u extra ACMD41 polls, SDIO probe %s\n\n", (unsigned)runs[1].extra_polls,
+           runs[1].probe_skipped ? "skipped" : "sent");
+}
@@ -0,0 +1,115 @@
+/*
+ * SD卡初始化与挂载的分阶段计时
+ *
+ * 挂载时替换主机驱动的do_transaction、set_card_clk和set_bus_width，按命令划分阶段：
+ * 主机初始化（第一条命令之前）、CMD0、CMD8、SDIO探测（CMD5）、ACMD41轮询、
+ * CID/RCA、CSD、选卡和SCR、总线宽度、高速模式和时钟切换、文件系统挂载（第一次读扇区之后）。
+ * 每个阶段从该阶段的第一条命令开始，到下一阶段的第一条命令为止，
+ * 因此包含驱动在命令之间的等待（例如CMD0之后的20ms和ACMD41每次重试之间的10ms）。
+ * 挂载完成后恢复原来的函数，不影响之后的读写。
+ *
+ * 快速初始化（sd_mount_params_t的fast_init）：
+ * 1. ACMD41报告卡忙时，不返回给驱动等待10ms再重试，而是每1ms重发一次直到卡就绪
+ * 2. 上次启动成功初始化的卡记录在RTC_NOINIT内存中（软件复位后仍保留），
+ *    已知是存储卡时跳过SDIO探测（CMD52复位和CMD5直接按无响应处理）。初始化完成后比较CID，
+ *    换卡时更新记录
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sdmmc_cmd.h"
+#include "sd_mount.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 初始化阶段
+ */
+typedef enum
+{
+    SD_BOOT_HOST = 0,   // 主机、插槽和总线初始化
+    SD_BOOT_RESET,      // CMD0
+    SD_BOOT_IF_COND,    // CMD8
+    SD_BOOT_SDIO_PROBE, // CMD5/CMD52
+    SD_BOOT_OP_COND,    // ACMD41轮询（SPI模式还有CMD58/CMD59）
+    SD_BOOT_CID,        // CMD2/CMD3（SPI模式为CMD10）
+    SD_BOOT_CSD,        // CMD9
+    SD_BOOT_SELECT,     // CMD7、ACMD51（SCR）
+    SD_BOOT_BUS_WIDTH,  // ACMD6及主机总线宽度切换
+    SD_BOOT_HIGH_SPEED, // CMD6切换高速模式及主机时钟切换
+    SD_BOOT_FS,         // 读取分区表和引导扇区、注册VFS
+    SD_BOOT_STAGE_MAX,
+} sd_boot_stage_t;
+
+/**
+ * @brief 一次挂载的计时结果
+ */
+typedef struct
+{
+    int64_t stage_us[SD_BOOT_STAGE_MAX]; // 各阶段耗时
+    int64_t total_us;                    // 挂载总耗时
+    uint32_t commands;                   // 驱动发出的命令数
+    uint32_t extra_polls;                // 快速初始化额外发出的ACMD41次数
+    bool fast;                           // 是否启用快速初始化
+    bool probe_skipped;                  // 是否跳过了SDIO探测
+    bool card_changed;                   // 卡与上次记录的不同
+} sd_boottime_t;
+
+/**
+ * @brief 开始一次挂载计时（由sd_mount调用）
+ *
+ * @param fast 是否启用快速初始化
+ */
+void sd_boottime_begin(bool fast);
+
+/**
+ * @brief 替换主机配置中的驱动函数（由sd_mount在初始化主机前调用）
+ */
+void sd_boottime_hook(sdmmc_host_t *host);
+
+/**
+ * @brief 结束计时并恢复驱动函数，成功时记录卡信息（由sd_mount调用）
+ *
+ * 跳过了SDIO探测而初始化失败时清除记录的卡信息，下一次挂载重新探测。
+ *
+ * @param card 初始化成功的SD卡，失败时为NULL
+ */
+void sd_boottime_end(sdmmc_card_t *card);
+
+/**
+ * @brief 获取最近一次挂载的计时结果
+ */
+void sd_boottime_get(sd_boottime_t *out);
+
+/**
+ * @brief 清除已知卡记录，下次挂载按未知卡处理
+ */
+void sd_boottime_forget(void);
+
+/**
+ * @brief 并排打印若干次挂载的各阶段耗时
+ *
+ * @param labels 每列的标题
+ * @param runs   计时结果
+ * @param count  列数
+ */
+void sd_boottime_print(const char *const *labels, const sd_boottime_t *runs, size_t count);
+
+/**
+ * @brief 分别以普通初始化和快速初始化重复挂载，输出各阶段平均耗时
+ *
+ * 需要反复挂载，必须在主挂载卸载后调用。
+ *
+ * @param params 挂载参数（fast_init由测试设置）
+ */
+void sd_boottime_bench_run(const sd_mount_params_t *params);
+
+#ifdef __cplusplus
+}
+#endif
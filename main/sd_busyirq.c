@@ -0,0 +1,304 @@
+/*
+ * 中断驱动的写入忙检测实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <sys/unistd.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "driver/gpio.h"
+#include "driver/sdmmc_defs.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sd_busyirq.h"
+#include "sd_bench.h"
+
+// 等待DAT0释放的超时时间，超时后交给驱动继续轮询
+#define BUSY_IRQ_TIMEOUT_MS 500
+#define SPIN_STACK_SIZE 2048
+#define SPIN_CALIBRATE_MS 500
+
+static const char *TAG = "sd_busyirq";
+
+typedef esp_err_t (*do_transaction_fn)(int slot, sdmmc_command_t *cmd);
+
+static sdmmc_card_t *s_card;
+static do_transaction_fn s_orig;
+static gpio_num_t s_pin;
+static SemaphoreHandle_t s_ready;
+static volatile bool s_enabled;
+static volatile int64_t s_isr_us;
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static sd_busyirq_stats_t s_stats;
+static bool s_busy_pending;
+static bool s_first_poll;
+static int64_t s_write_end_us;
+
+static void IRAM_ATTR dat0_isr(void *arg)
+{
+    // 高电平中断在DAT0保持高电平时会持续触发，进入一次后立即关闭
+    gpio_intr_disable(s_pin);
+    s_isr_us = esp_timer_get_time();
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(s_ready, &woken);
+    if (woken)
+    {
+        portYIELD_FROM_ISR();
+    }
+}
+
+/**
+ * @brief 阻塞直到DAT0变为高电平（卡不再忙）或超时
+ */
+static void wait_dat0_release(void)
+{
+    // 清除上一次超时后可能迟到的信号
+    xSemaphoreTake(s_ready, 0);
+    // 使用高电平而不是上升沿触发：如果DAT0在此之前已经释放，中断会立即进入，不会错过
+    gpio_intr_enable(s_pin);
+    bool woke = xSemaphoreTake(s_ready, pdMS_TO_TICKS(BUSY_IRQ_TIMEOUT_MS)) == pdTRUE;
+    int64_t now = esp_timer_get_time();
+    if (!woke)
+    {
+        gpio_intr_disable(s_pin);
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    if (woke)
+    {
+        s_stats.irq_waits++;
+        s_stats.wake_us += now - s_isr_us;
+    }
+    else
+    {
+        s_stats.timeouts++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+static esp_err_t busy_transaction(int slot, sdmmc_command_t *cmd)
+{
+    bool status_poll = cmd->opcode == MMC_SEND_STATUS && s_busy_pending;
+    if (status_poll)
+    {
+        // 只在写入后的第一条CMD13之前等待，之后的轮询说明卡仍未就绪，照常发送
+        if (s_enabled && s_first_poll)
+        {
+            wait_dat0_release();
+        }
+        portENTER_CRITICAL(&s_lock);
+        s_first_poll = false;
+        s_stats.polls++;
+        portEXIT_CRITICAL(&s_lock);
+    }
+
+    esp_err_t ret = s_orig(slot, cmd);
+    esp_err_t err = ret == ESP_OK ? cmd->error : ret;
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_lock);
+    if (status_poll)
+    {
+        if (err != ESP_OK || (MMC_R1(cmd->response) & MMC_R1_READY_FOR_DATA))
+        {
+            s_stats.busy_us += now - s_write_end_us;
+            s_busy_pending = false;
+        }
+    }
+    else
+    {
+        bool write = cmd->data != NULL && cmd->datalen > 0 && !(cmd->flags & SCF_CMD_READ);
+        if (write)
+        {
+            s_stats.writes++;
+        }
+        s_busy_pending = write && err == ESP_OK;
+        s_first_poll = s_busy_pending;
+        s_write_end_us = now;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return ret;
+}
+
+esp_err_t sd_busyirq_attach(sdmmc_card_t *card, int d0_pin)
+{
+    if (card->host.flags & SDMMC_HOST_FLAG_SPI)
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (s_card != NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_ready = xSemaphoreCreateBinary();
+    if (s_ready == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    // 中断服务可能已由应用的其他部分安装
+    esp_err_t ret = gpio_install_isr_service(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE)
+    {
+        vSemaphoreDelete(s_ready);
+        return ret;
+    }
+    // 不调用gpio_config，以免改变引脚的SDMMC外设功能
+    s_pin = (gpio_num_t)d0_pin;
+    gpio_intr_disable(s_pin);
+    gpio_set_intr_type(s_pin, GPIO_INTR_HIGH_LEVEL);
+    ret = gpio_isr_handler_add(s_pin, dat0_isr, NULL);
+    if (ret != ESP_OK)
+    {
+        gpio_set_intr_type(s_pin, GPIO_INTR_DISABLE);
+        vSemaphoreDelete(s_ready);
+        return ret;
+    }
+
+    sd_busyirq_take_stats(NULL);
+    s_busy_pending = false;
+    s_enabled = true;
+    s_card = card;
+    s_orig = card->host.do_transaction;
+    card->host.do_transaction = busy_transaction;
+    return ESP_OK;
+}
+
+void sd_busyirq_detach(sdmmc_card_t *card)
+{
+    if (s_card != card)
+    {
+        return;
+    }
+    card->host.do_transaction = s_orig;
+    s_card = NULL;
+    gpio_intr_disable(s_pin);
+    gpio_isr_handler_remove(s_pin);
+    gpio_set_intr_type(s_pin, GPIO_INTR_DISABLE);
+    vSemaphoreDelete(s_ready);
+    s_ready = NULL;
+}
+
+void sd_busyirq_enable(bool enable)
+{
+    s_enabled = enable;
+}
+
+void sd_busyirq_take_stats(sd_busyirq_stats_t *stats)
+{
+    portENTER_CRITICAL(&s_lock);
+    if (stats != NULL)
+    {
+        *stats = s_stats;
+    }
+    memset(&s_stats, 0, sizeof(s_stats));
+    portEXIT_CRITICAL(&s_lock);
+}
+
+/**
+ * @brief 最低优先级的计数任务，只在同核没有其他任务就绪时运行
+ */
+typedef struct
+{
+    volatile bool run;
+    volatile uint32_t count;
+    SemaphoreHandle_t done;
+} spinner_t;
+
+static void spin_task(void *arg)
+{
+    spinner_t *s = (spinner_t *)arg;
+    while (s->run)
+    {
+        s->count++;
+    }
+    xSemaphoreGive(s->done);
+    vTaskDelete(NULL);
+}
+
+static bool spinner_start(spinner_t *s)
+{
+    s->run = true;
+    s->count = 0;
+    return xTaskCreatePinnedToCore(spin_task, "sd_busy_spin", SPIN_STACK_SIZE, s, tskIDLE_PRIORITY,
+                                   NULL, xPortGetCoreID()) == pdPASS;
+}
+
+static uint32_t spinner_stop(spinner_t *s)
+{
+    s->run = false;
+    xSemaphoreTake(s->done, portMAX_DELAY);
+    return s->count;
+}
+
+void sd_busyirq_bench_run(sdmmc_card_t *card, int d0_pin)
+{
+    esp_err_t ret = sd_busyirq_attach(card, d0_pin);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Busy interrupt not available (%s)", esp_err_to_name(ret));
+        return;
+    }
+    ESP_LOGI(TAG, "Comparing CMD13 polling and DAT0 interrupt during sustained writes");
+
+    spinner_t spinner = {.done = xSemaphoreCreateBinary()};
+    if (spinner.done == NULL)
+    {
+        sd_busyirq_detach(card);
+        return;
+    }
+
+    // 计数任务在空闲时的速度作为100%空闲的参考
+    float idle_rate = 0;
+    if (spinner_start(&spinner))
+    {
+        int64_t start = esp_timer_get_time();
+        vTaskDelay(pdMS_TO_TICKS(SPIN_CALIBRATE_MS));
+        uint32_t count = spinner_stop(&spinner);
+        idle_rate = count / (float)(esp_timer_get_time() - start);
+    }
+
+    sd_bench_params_t params = SD_BENCH_PARAMS_DEFAULT();
+    params.cold_read = false;
+    printf("\nWrite busy wait (%u KB writes, %u KB file):\n", (unsigned)(params.buf_size / 1024),
+           (unsigned)(params.file_size / 1024));
+    printf("  %-9s %8s %6s %7s %11s %10s %8s %8s\n", "mode", "MB/s", "CPU%", "writes", "CMD13/write",
+           "busy us", "wake us", "timeouts");
+    static const char *const modes[] = {"polling", "interrupt"};
+    for (int m = 0; m < 2; m++)
+    {
+        sd_busyirq_enable(m == 1);
+        sd_busyirq_take_stats(NULL);
+        bool spinning = idle_rate > 0 && spinner_start(&spinner);
+        int64_t start = esp_timer_get_time();
+
+        sd_bench_result_t result;
+        ret = sd_bench_write(&params, &result);
+
+        int64_t elapsed = esp_timer_get_time() - start;
+        uint32_t count = spinning ? spinner_stop(&spinner) : 0;
+        sd_busyirq_stats_t stats;
+        sd_busyirq_take_stats(&stats);
+        unlink(params.path);
+        if (ret != ESP_OK)
+        {
+            printf("  %-9s failed (%s)\n", modes[m], esp_err_to_name(ret));
+            continue;
+        }
+
+        float cpu = spinning ? 100.0f * (1.0f - count / (idle_rate * elapsed)) : -1;
+        uint32_t writes = stats.writes > 0 ? stats.writes : 1;
+        printf("  %-9s %8.2f %6.1f %7u %11.2f %10.0f %8.1f %8u\n", modes[m], result.speed_mb,
+               cpu < 0 ? 0 : cpu, (unsigned)stats.writes, (float)stats.polls / writes,
+               (double)stats.busy_us / writes,
+               stats.irq_waits ? (double)stats.wake_us / stats.irq_waits : 0.0, (unsigned)stats.timeouts);
+    }
+    printf("  CPU%%: share of this core taken from the lowest-priority task while writing\n\n");
+
+    vSemaphoreDelete(spinner.done);
+    sd_busyirq_detach(card);
+}
@@ -0,0 +1,87 @@
+/*
+ * 中断驱动的写入忙检测
+ *
+ * 写命令结束后卡把DAT0拉低直到编程完成。IDF主机驱动在写入后循环发送CMD13，
+ * 直到卡报告READY_FOR_DATA，期间写任务一直占用CPU和总线。
+ *
+ * 本模块替换card->host.do_transaction：写命令之后的第一条CMD13发出前，
+ * 在DAT0引脚上打开高电平中断，写任务阻塞在信号量上，卡释放DAT0后由中断唤醒，
+ * 再发出CMD13确认状态。这样驱动的轮询循环通常只需一条CMD13即可退出。
+ *
+ * 注意：
+ * - 只支持SDMMC模式；SDSPI模式下主机驱动在写命令内部等待忙信号
+ * - 引脚的外设功能保持不变，只使用GPIO的输入中断，因此DAT0必须经GPIO矩阵或IO MUX可读
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdmmc_cmd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 忙等待统计
+ */
+typedef struct
+{
+    uint32_t writes;    // 写数据命令数
+    uint32_t polls;     // 写入后发出的CMD13数
+    uint32_t irq_waits; // 等待中断的次数
+    uint32_t timeouts;  // 等待中断超时的次数（超时后退回轮询）
+    int64_t busy_us;    // 写命令结束到READY_FOR_DATA的累计时间
+    int64_t wake_us;    // 中断触发到写任务恢复运行的累计时间
+} sd_busyirq_stats_t;
+
+/**
+ * @brief 替换card->host.do_transaction并在DAT0上注册中断处理
+ *
+ * 挂接后默认使用中断等待，可用sd_busyirq_enable切换回轮询（仍然统计）。
+ * 同一时间只能挂接一张卡，卸载SD卡前必须先调用sd_busyirq_detach。
+ *
+ * @param card   SDMMC模式挂载的SD卡
+ * @param d0_pin DAT0的GPIO编号
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_NOT_SUPPORTED SDSPI模式
+ *  - ESP_ERR_INVALID_STATE 已挂接
+ *  - ESP_ERR_NO_MEM 内存不足
+ *  - 其他错误码来自GPIO驱动
+ */
+esp_err_t sd_busyirq_attach(sdmmc_card_t *card, int d0_pin);
+
+/**
+ * @brief 恢复原来的do_transaction并移除中断处理
+ */
+void sd_busyirq_detach(sdmmc_card_t *card);
+
+/**
+ * @brief 选择写入后用中断等待（true）还是保持驱动原来的CMD13轮询（false）
+ */
+void sd_busyirq_enable(bool enable);
+
+/**
+ * @brief 获取并清零统计
+ *
+ * @param stats 输出统计，可为NULL（仅清零）
+ */
+void sd_busyirq_take_stats(sd_busyirq_stats_t *stats);
+
+/**
+ * @brief 持续写入时对比CMD13轮询与中断等待的速度、CPU占用和忙等待延迟
+ *
+ * CPU占用通过与写任务同核的最低优先级计数任务估算：写入期间计数速度相对空闲时下降的比例。
+ *
+ * @param card   SDMMC模式挂载的SD卡
+ * @param d0_pin DAT0的GPIO编号
+ */
+void sd_busyirq_bench_run(sdmmc_card_t *card, int d0_pin);
+
+#ifdef __cplusplus
+}
+#endif
@@ -20,7 +20,7 @@
  * 不附带任何明示或暗示的担保或条件。
  */
 
-// 本示例使用SDMMC外设与SD卡通信，支持标准SD卡和SDHC/SDXC卡
+// 本示例使用SDMMC外设或SPI外设（SDSPI）与SD卡通信，支持标准SD卡和SDHC/SDXC卡
 
 // 包含字符串操作相关函数
 #include <string.h>
@@ -28,207 +28,179 @@
 #include <sys/unistd.h>
 // 包含文件状态相关结构和函数
 #include <sys/stat.h>
-// 包含ESP32 FAT文件系统相关函数
-#include "esp_vfs_fat.h"
+// 包含日志输出相关函数
+#include "esp_log.h"
 // 包含SD/MMC卡命令相关函数
 #include "sdmmc_cmd.h"
-// 包含SD/MMC主机驱动相关函数
-#include "driver/sdmmc_host.h"
-// 包含高精度计时器相关函数
-#include "esp_timer.h"
 // 包含FreeRTOS相关函数
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include <errno.h>
-
-// 定义SD卡在虚拟文件系统中的挂载点
-#define MOUNT_POINT "/sdcard"
-
-// 定义SD卡读写速度测试相关参数
-#define TEST_BUFFER_SIZE (128 * 1024)          // 每次读写的缓冲区大小：128KB（提升读写性能）
-#define TEST_FILE_SIZE (4 * 1024 * 1024)       // 测试文件总大小：4MB（增大文件以获得更准确的速度测试）
-#define TEST_FILE_PATH MOUNT_POINT "/test.txt" // 测试文件路径（使用.txt扩展名避免兼容性问题）
+// 包含SD卡挂载接口（SDMMC/SDSPI）
+#include "sd_mount.h"
+// 包含SD卡读写速度测试套件
+#include "sd_bench.h"
+// 包含热路径跟踪宏和日志开销测试
+#include "sd_trace.h"
+// 包含写入路径SHA-256校验
+#include "sd_hash.h"
+// 包含AES-CTR加密文件层
+#include "sd_crypt.h"
+// 包含单卡多分区挂载
+#include "sd_partition.h"
+// 包含运行时测试控制台
+#include "sd_console.h"
+// 包含卡上测试历史记录
+#include "sd_history.h"
+// 包含命令级原始读写
+#include "sd_raw.h"
+// 包含命令级延迟分解
+#include "sd_cmdtrace.h"
+// 包含中断驱动的写入忙检测
+#include "sd_busyirq.h"
+// 包含流式写入会话
+#include "sd_stream.h"
+// 包含分页文件视图
+#include "sd_view.h"
+// 包含带访问模式提示的文件层
+#include "sd_advise.h"
+// 包含文件空间预分配
+#include "sd_prealloc.h"
+// 包含延迟目录项更新的追加写文件层
+#include "sd_append.h"
+// 包含目录路径解析缓存
+#include "sd_dircache.h"
+// 包含FATFS内存占用统计
+#include "sd_lowram.h"
+// 包含挂载分阶段计时
+#include "sd_boottime.h"
+// 包含扇区擦除
+#include "sd_erase.h"
+// 包含增量检查点
+#include "sd_ckpt.h"
+// 包含循环日志
+#include "sd_ringlog.h"
+// 包含多通道扇出日志
+#include "sd_fanout.h"
+// 包含多路复用流容器
+#include "sd_mux.h"
 
 // 定义日志标签
 static const char *TAG = "example";
 
 /**
- * @brief SD卡写入速度测试函数
- *
- * 该函数通过以下步骤测试SD卡的写入速度：
- * 1. 创建一个指定大小(TEST_BUFFER_SIZE)的缓冲区
- * 2. 使用规律数据填充缓冲区
- * 3. 创建测试文件并打开
- * 4. 通过多次写入缓冲区数据，直到达到指定的测试文件大小(TEST_FILE_SIZE)
- * 5. 使用高精度计时器计算写入速度
+ * @brief 在主挂载点上运行menuconfig中启用的附加测试
  *
- * 注意：
- * - 函数会先检查并删除已存在的测试文件
- * - 写入完成后会执行fsync确保数据真正写入到SD卡
- * - 如果分配缓冲区失败或文件操作失败，函数会提前返回
+ * @param mnt 当前挂载状态
  */
-static void test_write_speed(void)
+static void run_feature_benchmarks(const sd_mount_t *mnt)
 {
-    ESP_LOGI(TAG, "Testing write speed...");
-
-    // 检查并删除可能存在的旧测试文件
-    struct stat st;
-    if (stat(TEST_FILE_PATH, &st) == 0)
-    {
-        unlink(TEST_FILE_PATH);
-    }
-
-    // 创建测试数据缓冲区
-    uint8_t *buffer = malloc(TEST_BUFFER_SIZE);
-    if (buffer == NULL)
-    {
-        ESP_LOGE(TAG, "Failed to allocate buffer");
-        return;
-    }
-    // 填充缓冲区
-    for (int i = 0; i < TEST_BUFFER_SIZE; i++)
-    {
-        buffer[i] = i & 0xFF;
-    }
-
-    // 创建测试文件
-    ESP_LOGI(TAG, "Opening file for writing: %s", TEST_FILE_PATH);
-    FILE *f = fopen(TEST_FILE_PATH, "w");
-    if (f == NULL)
-    {
-        ESP_LOGE(TAG, "Failed to open file for writing (errno: %d, path: %s)", errno, TEST_FILE_PATH);
-        free(buffer);
-        return;
-    }
-
-    // 开始计时
-    int64_t start_time = esp_timer_get_time();
-
-    // 写入测试数据
-    size_t bytes_written = 0;
-    while (bytes_written < TEST_FILE_SIZE)
-    {
-        size_t to_write = TEST_FILE_SIZE - bytes_written;
-        if (to_write > TEST_BUFFER_SIZE)
-        {
-            to_write = TEST_BUFFER_SIZE;
-        }
-        size_t written = fwrite(buffer, 1, to_write, f);
-        if (written != to_write)
-        {
-            ESP_LOGE(TAG, "Write failed");
-            break;
-        }
-        bytes_written += written;
-    }
-
-    // 确保数据写入到卡上
-    fflush(f);
-    fsync(fileno(f));
-    fclose(f);
-
-    // 计算写入速度
-    int64_t end_time = esp_timer_get_time();
-    float time_s = (end_time - start_time) / 1000000.0;
-    float speed_mb = (TEST_FILE_SIZE / (1024.0 * 1024.0)) / time_s;
-
-    ESP_LOGI(TAG, "Write speed: %.2f MB/s (%.2f seconds for %d bytes)",
-             speed_mb, time_s, TEST_FILE_SIZE);
-
-    free(buffer);
+#ifdef CONFIG_EXAMPLE_BENCH_SHA256
+    sd_hash_bench_run(TEST_BUFFER_SIZE, TEST_FILE_SIZE);
+#endif
+#ifdef CONFIG_EXAMPLE_BENCH_AES
+    // 流水线需要两个缓冲区，使用较小的块以节省DMA内存
+    sd_crypt_bench_run(32 * 1024, TEST_FILE_SIZE);
+#endif
+#ifdef CONFIG_EXAMPLE_BENCH_RAW_SWEEP
+    sd_raw_bench_run(mnt->card);
+#endif
+#ifdef CONFIG_EXAMPLE_BENCH_CMD_TRACE
+    sd_cmdtrace_bench_run(mnt->card);
+#endif
+#ifdef CONFIG_EXAMPLE_BENCH_BUSY_IRQ
+    sd_busyirq_bench_run(mnt->card, CONFIG_EXAMPLE_PIN_D0);
+#endif
+#ifdef CONFIG_EXAMPLE_BENCH_STREAM
+    sd_stream_bench_run(mnt->card);
+#endif
+#ifdef CONFIG_EXAMPLE_BENCH_PAGED_VIEW
+    sd_view_bench_run();
+#endif
+#ifdef CONFIG_EXAMPLE_BENCH_ADVISE
+    sd_advise_bench_run(mnt->card);
+#endif
+#ifdef CONFIG_EXAMPLE_BENCH_PREALLOC
+    sd_prealloc_bench_run(mnt->card);
+#endif
+#ifdef CONFIG_EXAMPLE_BENCH_LAZY_DIRENT
+    sd_append_bench_run(mnt->card);
+#endif
+#ifdef CONFIG_EXAMPLE_BENCH_DIR_CACHE
+    sd_dircache_bench_run(mnt->card);
+#endif
+#ifdef CONFIG_EXAMPLE_BENCH_ERASE
+    sd_erase_bench_run(mnt->card);
+#endif
+#ifdef CONFIG_EXAMPLE_BENCH_CHECKPOINT
+    sd_ckpt_bench_run(mnt->card);
+#endif
+#ifdef CONFIG_EXAMPLE_BENCH_RING_LOG
+    sd_ringlog_bench_run(mnt->card);
+#endif
+#ifdef CONFIG_EXAMPLE_BENCH_MUX
+    sd_mux_bench_run(mnt->card);
+#endif
+#ifdef CONFIG_EXAMPLE_BENCH_HISTORY
+    sd_history_bench_run(mnt->card, CONFIG_EXAMPLE_BENCH_HISTORY_RUNS);
+#endif
 }
 
+#ifdef CONFIG_EXAMPLE_BENCH_COMPARE_BUSES
 /**
- * @brief SD卡读取速度测试函数
- *
- * 该函数通过以下步骤测试SD卡的读取速度：
- * 1. 创建一个指定大小(TEST_BUFFER_SIZE)的缓冲区
- * 2. 打开由写入测试创建的文件
- * 3. 循环读取文件内容到缓冲区，直到读取完整个文件(TEST_FILE_SIZE)
- * 4. 使用高精度计时器计算读取速度
+ * @brief 依次在SDMMC 1线、SDMMC 4线和SDSPI下运行同一套速度测试并并排输出结果
  *
  * 注意：
- * - 读取完成后会删除测试文件
- * - 如果分配缓冲区失败或文件操作失败，函数会提前返回
- * - 此函数应该在test_write_speed之后调用
+ * - SD卡进入SPI模式后只能通过重新上电回到SD模式，因此SDSPI放在最后
+ * - 4线模式需要在menuconfig中选择4线总线宽度以配置D1~D3引脚，否则跳过
+ * - 调用前必须先卸载主挂载点
  */
-static void test_read_speed(void)
+static void run_bus_comparison(void)
 {
-    ESP_LOGI(TAG, "Testing read speed...");
-
-    // 创建DMA兼容的读取缓冲区
-    uint8_t *buffer = heap_caps_malloc(TEST_BUFFER_SIZE, MALLOC_CAP_DMA);
-    if (buffer == NULL)
-    {
-        ESP_LOGE(TAG, "Failed to allocate buffer");
-        return;
-    }
-
-    // 打开测试文件
-    ESP_LOGI(TAG, "Opening file for reading: %s", TEST_FILE_PATH);
-    FILE *f = fopen(TEST_FILE_PATH, "r");
-    if (f == NULL)
-    {
-        ESP_LOGE(TAG, "Failed to open file for reading (errno: %d, path: %s)", errno, TEST_FILE_PATH);
-        free(buffer);
-        return;
-    }
-
-    // 开始计时
-    int64_t start_time = esp_timer_get_time();
-
-    // 读取测试数据
-    size_t bytes_read = 0;
-    while (bytes_read < TEST_FILE_SIZE)
+    sd_bench_params_t bench_params = SD_BENCH_PARAMS_DEFAULT();
+    sd_bench_report_t reports[3];
+    size_t count = 0;
+
+    sd_mount_params_t configs[3];
+    sd_mount_default_params(&configs[0]);
+    configs[0].bus = SD_BUS_SDMMC;
+    configs[0].width = 1;
+    configs[0].max_freq_khz = CONFIG_EXAMPLE_SDMMC_MAX_FREQ_KHZ;
+    configs[1] = configs[0];
+    configs[1].width = 4;
+    configs[2] = configs[0];
+    configs[2].bus = SD_BUS_SDSPI;
+    configs[2].max_freq_khz = CONFIG_EXAMPLE_SDSPI_MAX_FREQ_KHZ;
+
+    for (size_t i = 0; i < sizeof(configs) / sizeof(configs[0]); i++)
     {
-        size_t to_read = TEST_FILE_SIZE - bytes_read;
-        if (to_read > TEST_BUFFER_SIZE)
+#ifndef CONFIG_EXAMPLE_SDMMC_BUS_WIDTH_4
+        if (configs[i].bus == SD_BUS_SDMMC && configs[i].width == 4)
         {
-            to_read = TEST_BUFFER_SIZE;
+            ESP_LOGW(TAG, "Skipping SDMMC 4-bit: D1-D3 pins are not configured");
+            continue;
         }
-
-        size_t read = fread(buffer, 1, to_read, f);
-        if (read != to_read)
+#endif
+        ESP_LOGI(TAG, "Benchmarking %s", sd_mount_bus_name(&configs[i]));
+        sd_mount_t mnt;
+        if (sd_mount(&configs[i], &mnt) != ESP_OK)
         {
-            ESP_LOGE(TAG, "Read partial/failed: read=%d, expected=%d, bytes_read_total=%d, ferror=%d, feof=%d",
-                     (int)read, (int)to_read, (int)bytes_read, ferror(f), feof(f));
-            if (ferror(f))
-            {
-                ESP_LOGE(TAG, "Read failed with error %d", errno);
-            }
-            else
-            {
-                ESP_LOGW(TAG, "Unexpected EOF at %d bytes", (int)bytes_read);
-            }
-            break;
+            continue;
         }
-        // 每次成功读取后，打印进度
-        ESP_LOGD(TAG, "Read %d bytes, total %d/%d", (int)read, (int)bytes_read + (int)read, (int)TEST_FILE_SIZE);
-        bytes_read += read;
+        sd_bench_run_suite(&mnt, &bench_params, &reports[count++]);
+        sd_unmount(&mnt);
     }
-    fclose(f);
-
-    // 计算读取速度
-    int64_t end_time = esp_timer_get_time();
-    float time_s = (end_time - start_time) / 1000000.0;
-    float speed_mb = (TEST_FILE_SIZE / (1024.0 * 1024.0)) / time_s;
-
-    ESP_LOGI(TAG, "Read speed: %.2f MB/s (%.2f seconds for %d bytes)",
-             speed_mb, time_s, TEST_FILE_SIZE);
-
-    free(buffer);
 
-    // 删除测试文件
-    unlink(TEST_FILE_PATH);
+    sd_bench_print_reports(reports, count);
 }
+#endif // CONFIG_EXAMPLE_BENCH_COMPARE_BUSES
 
 /**
  * @brief 主程序入口函数
  *
  * 程序主要流程：
  * 1. 配置并初始化SD卡
- *    - 设置FAT文件系统参数
- *    - 配置SDMMC主机和GPIO
+ *    - 根据menuconfig选择SDMMC或SDSPI挂载路径
  *    - 挂载文件系统
  *
  * 2. 执行基本文件操作测试
@@ -239,102 +211,64 @@ static void test_read_speed(void)
  * 3. 执行SD卡速度测试
  *    - 写入速度测试
  *    - 读取速度测试
+ *    - menuconfig中启用的附加测试（如SHA-256校验写入）
+ *    - 如果启用了EXAMPLE_BENCH_COMPARE_BUSES，则卸载后依次在
+ *      SDMMC 1线、SDMMC 4线和SDSPI下重复测试并并排输出结果
  *
  * 4. 清理并卸载
  *    - 删除测试文件
  *    - 卸载文件系统
  *
+ * 5. 如果启用了EXAMPLE_BENCH_PARTITIONS，把卡的两个分区挂载为两个卷，
+ *    对比两个写任务在同一个卷和不同卷上的吞吐量
+ *
+ * 6. 如果启用了EXAMPLE_BENCH_LOG_OVERHEAD，测量热路径日志的单块开销
+ *
+ * 7. 如果启用了EXAMPLE_CONSOLE，重新挂载SD卡并启动测试控制台
+ *
  * 注意：函数会自动处理各种错误情况，
  * 如挂载失败、文件操作失败等，并通过
  * ESP_LOG宏输出详细的错误信息。
  */
 void app_main(void)
 {
-    // 用于存储函数返回值的错误码
-    esp_err_t ret;
-
-    // 文件系统挂载配置选项
-    // 如果format_if_mount_failed设置为true，则在挂载失败时
-    // 会对SD卡进行分区和格式化操作
-    esp_vfs_fat_sdmmc_mount_config_t mount_config = {
-#ifdef CONFIG_EXAMPLE_FORMAT_IF_MOUNT_FAILED
-        .format_if_mount_failed = true, // 挂载失败时格式化SD卡
-#else
-        .format_if_mount_failed = false, // 挂载失败时不格式化SD卡
-#endif                                      // EXAMPLE_FORMAT_IF_MOUNT_FAILED
-        .max_files = 5,                     // 最大同时打开文件数
-        .allocation_unit_size = 32 * 1024}; // FAT文件系统分配单元大小(32KB，优化文件系统性能)
-
-    // SD卡信息结构体指针
-    sdmmc_card_t *card;
-    // 文件系统挂载点
-    const char mount_point[] = MOUNT_POINT;
+    // 挂载参数（总线类型、总线宽度、时钟频率等来自menuconfig）
+    sd_mount_params_t mount_params;
+    sd_mount_default_params(&mount_params);
+    // 挂载状态
+    sd_mount_t mnt;
     // 输出日志：开始初始化SD卡
     ESP_LOGI(TAG, "Initializing SD card");
 
-    // 使用上面定义的设置来初始化SD卡并挂载FAT文件系统
-    // 注意：esp_vfs_fat_sdmmc/sdspi_mount是集成了所有功能的便捷函数
-    // 在开发生产应用时，请查看其源代码并实现错误恢复机制
-
-    // 输出日志：使用SDMMC外设
-    ESP_LOGI(TAG, "Using SDMMC peripheral");
-    // 获取SDMMC主机默认配置
-    sdmmc_host_t host = SDMMC_HOST_DEFAULT();
-    // 设置SDMMC时钟频率为40MHz以提高性能
-    host.max_freq_khz = 40000;
-
-    // 初始化SD卡插槽配置，这里不使用卡检测(CD)和写保护(WP)信号
-    // 如果您的开发板上有这些信号，请修改slot_config.gpio_cd和slot_config.gpio_wp
-    sdmmc_slot_config_t slot_config = SDMMC_SLOT_CONFIG_DEFAULT();
-
-    // 设置SD卡为1线模式，因为硬件只支持1线
-    slot_config.width = 1; // 1线模式 (仅使用DAT0)
-
-    // 在支持配置SD卡GPIO的芯片上（如ESP32S3），
-    // 在slot_config结构体中设置这些引脚：
-#ifdef CONFIG_IDF_TARGET_ESP32S3
-    slot_config.clk = CONFIG_EXAMPLE_PIN_CLK; // 时钟信号引脚
-    slot_config.cmd = CONFIG_EXAMPLE_PIN_CMD; // 命令信号引脚
-    slot_config.d0 = CONFIG_EXAMPLE_PIN_D0;   // 数据线0引脚
-#ifdef CONFIG_EXAMPLE_SDMMC_BUS_WIDTH_4
-    slot_config.d1 = CONFIG_EXAMPLE_PIN_D1; // 数据线1引脚
-    slot_config.d2 = CONFIG_EXAMPLE_PIN_D2; // 数据线2引脚
-    slot_config.d3 = CONFIG_EXAMPLE_PIN_D3; // 数据线3引脚
-#endif                                      // CONFIG_EXAMPLE_SDMMC_BUS_WIDTH_4
-#endif                                      // CONFIG_IDF_TARGET_ESP32S3
-
-    // 在使能的引脚上启用内部上拉电阻
-    // 但是内部上拉电阻的强度不够，请确保在总线上
-    // 连接10k的外部上拉电阻。这仅用于调试/示例目的。
-    slot_config.flags |= SDMMC_SLOT_FLAG_INTERNAL_PULLUP;
+    if (mount_params.bus == SD_BUS_SDSPI)
+    {
+        ESP_LOGI(TAG, "Using SPI peripheral");
+    }
+    else
+    {
+        ESP_LOGI(TAG, "Using SDMMC peripheral");
+    }
 
     // 输出日志：开始挂载文件系统
     ESP_LOGI(TAG, "Mounting filesystem");
-    // 调用esp_vfs_fat_sdmmc_mount函数挂载SD卡
-    ret = esp_vfs_fat_sdmmc_mount(mount_point, &host, &slot_config, &mount_config, &card);
-
-    if (ret != ESP_OK) // 如果挂载失败
+    if (sd_mount(&mount_params, &mnt) != ESP_OK)
     {
-        if (ret == ESP_FAIL) // 如果是文件系统挂载失败
-        {
-            ESP_LOGE(TAG, "Failed to mount filesystem. "
-                          "If you want the card to be formatted, set the EXAMPLE_FORMAT_IF_MOUNT_FAILED menuconfig option.");
-            // 输出错误日志：文件系统挂载失败。如果要格式化卡，请设置EXAMPLE_FORMAT_IF_MOUNT_FAILED菜单选项
-        }
-        else // 如果是其他错误（如硬件初始化失败）
-        {
-            ESP_LOGE(TAG, "Failed to initialize the card (%s). "
-                          "Make sure SD card lines have pull-up resistors in place.",
-                     esp_err_to_name(ret));
-            // 输出错误日志：卡初始化失败。请确保SD卡信号线上有上拉电阻
-        }
-        return; // 发生错误，退出函数
+        return; // 发生错误，退出函数（错误信息已由sd_mount输出）
     }
     // 输出日志：文件系统挂载成功
     ESP_LOGI(TAG, "Filesystem mounted");
+    // 打印本次挂载各初始化阶段的耗时
+    sd_boottime_t boot_time;
+    sd_boottime_get(&boot_time);
+    const char *boot_label = mount_params.fast_init ? "fast" : "normal";
+    sd_boottime_print(&boot_label, &boot_time, 1);
 
+    // SD卡信息结构体指针
+    sdmmc_card_t *card = mnt.card;
     // SD卡已初始化，打印其属性信息（如容量、制造商等）
     sdmmc_card_print_info(stdout, card);
+    // 打印FATFS在当前配置下的内存占用（每次挂载和每个文件槽位）
+    sd_lowram_print_footprint(mount_params.max_files);
 
     // 使用POSIX和C标准库函数操作文件：
 
@@ -397,10 +331,56 @@ void app_main(void)
     // 输出日志：显示从文件读取的内容
     ESP_LOGI(TAG, "Read from file: '%s'", line);
 
+#ifdef CONFIG_EXAMPLE_BENCH_COMPARE_BUSES
+    run_feature_benchmarks(&mnt);
+    // 多总线对比测试需要反复挂载，先卸载主挂载点
+    sd_unmount(&mnt);
+    ESP_LOGI(TAG, "Card unmounted");
+    run_bus_comparison();
+#else
     // 执行SD卡速度测试
-    test_write_speed();
-    test_read_speed();
-    esp_vfs_fat_sdcard_unmount(mount_point, card);
+    sd_bench_params_t bench_params = SD_BENCH_PARAMS_DEFAULT();
+    sd_bench_report_t report;
+    sd_bench_run_suite(&mnt, &bench_params, &report);
+    sd_bench_print_reports(&report, 1);
+    // 冷读测试中重新挂载失败时mnt.card为NULL
+    if (mnt.card == NULL)
+    {
+        return;
+    }
+    run_feature_benchmarks(&mnt);
+    sd_unmount(&mnt);
     // 输出日志：SD卡已卸载
     ESP_LOGI(TAG, "Card unmounted");
+#endif // CONFIG_EXAMPLE_BENCH_COMPARE_BUSES
+
+#ifdef CONFIG_EXAMPLE_BENCH_PARTITIONS
+    // 多分区测试自行初始化SD卡并占用全部FATFS驱动器号，必须在主挂载卸载后运行
+    sd_part_bench_run(&mnt.params, 32 * 1024, TEST_FILE_SIZE / 2);
+#endif
+
+#ifdef CONFIG_EXAMPLE_BENCH_FANOUT
+    // 扇出日志测试以足够同时打开所有通道文件的max_files重新挂载，必须在主挂载卸载后运行
+    sd_fanout_bench_run(&mnt.params);
+#endif
+
+#ifdef CONFIG_EXAMPLE_BENCH_LOW_RAM
+    // 内存占用测试需要以不同的max_files反复挂载，必须在主挂载卸载后运行
+    sd_lowram_bench_run(&mnt.params);
+#endif
+
+#ifdef CONFIG_EXAMPLE_BENCH_INIT_TIMING
+    // 初始化计时测试需要反复挂载，必须在主挂载卸载后运行
+    sd_boottime_bench_run(&mnt.params);
+#endif
+
+#ifdef CONFIG_EXAMPLE_BENCH_LOG_OVERHEAD
+    // 日志开销测试不访问SD卡，放在卸载之后运行
+    sd_trace_bench_run();
+#endif
+
+#ifdef CONFIG_EXAMPLE_CONSOLE
+    // 控制台以menuconfig默认参数重新挂载SD卡，之后可用mount命令修改总线参数
+    sd_console_start(NULL);
+#endif
 }
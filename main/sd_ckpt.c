@@ -0,0 +1,639 @@
+/*
+ * 增量应用状态检查点实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <sys/unistd.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+#include "esp_rom_crc.h"
+#include "diskio_sdmmc.h"
+#include "sd_ckpt.h"
+#include "sd_mount.h"
+
+#define CKPT_MAGIC 0x54504B43u                    // "CKPT"
+#define CKPT_BENCH_NAME "CKPT.BIN"                // 测试检查点文件
+#define CKPT_BENCH_DUMP MOUNT_POINT "/CKDUMP.BIN" // 整体转储文件
+#define CKPT_BENCH_MODEL_SIZE (192 * 1024)        // 测试区域1（模拟模型参数）
+#define CKPT_BENCH_BUFFER_SIZE (64 * 1024)        // 测试区域2（模拟缓冲区）
+
+static const char *TAG = "sd_ckpt";
+
+/**
+ * @brief 检查点文件头，两份交替写入
+ */
+struct sd_ckpt_header
+{
+    uint32_t magic;      // CKPT_MAGIC
+    uint32_t seq;        // 提交序号，写在文件的第(seq % 2)个头位置
+    uint32_t page_size;  // SD_CKPT_PAGE_SIZE
+    uint32_t area_count; // 区域数
+    uint32_t pages;      // 总页数
+    struct
+    {
+        uint32_t id;
+        uint32_t size;
+    } areas[SD_CKPT_MAX_AREAS];          // 区域的标识和大小，恢复时与注册的区域比较
+    uint8_t slot[SD_CKPT_MAX_PAGES / 8]; // 每页当前所在的槽
+    uint32_t crc[SD_CKPT_MAX_PAGES];     // 每页的CRC32
+    uint32_t hdr_crc;                    // 以上字段的CRC32
+};
+
+_Static_assert(sizeof(struct sd_ckpt_header) <= SD_CKPT_PAGE_SIZE, "checkpoint header must fit in a page");
+
+static inline bool bit_get(const uint8_t *bits, uint32_t i)
+{
+    return (bits[i / 8] >> (i % 8)) & 1;
+}
+
+static inline void bit_set(uint8_t *bits, uint32_t i, bool value)
+{
+    if (value)
+    {
+        bits[i / 8] |= 1 << (i % 8);
+    }
+    else
+    {
+        bits[i / 8] &= ~(1 << (i % 8));
+    }
+}
+
+static uint32_t header_crc(const struct sd_ckpt_header *hdr)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)hdr, offsetof(struct sd_ckpt_header, hdr_crc));
+}
+
+static FSIZE_t header_offset(uint32_t seq)
+{
+    return (FSIZE_t)(seq & 1) * SD_CKPT_PAGE_SIZE;
+}
+
+/**
+ * @brief 第page页在槽slot中的文件偏移（同一个槽中的页连续存放）
+ */
+static FSIZE_t page_offset(const sd_ckpt_t *ck, uint32_t page, int slot)
+{
+    return (FSIZE_t)(2 + (uint32_t)slot * ck->pages + page) * SD_CKPT_PAGE_SIZE;
+}
+
+static FSIZE_t file_size(const sd_ckpt_t *ck)
+{
+    return (FSIZE_t)(2 + 2 * ck->pages) * SD_CKPT_PAGE_SIZE;
+}
+
+/**
+ * @brief 区域内第i页的有效字节数
+ */
+static size_t page_len(const sd_ckpt_area_t *area, uint32_t i)
+{
+    size_t offset = (size_t)i * SD_CKPT_PAGE_SIZE;
+    return area->size - offset < SD_CKPT_PAGE_SIZE ? area->size - offset : SD_CKPT_PAGE_SIZE;
+}
+
+static uint32_t page_crc(const sd_ckpt_area_t *area, uint32_t i)
+{
+    return esp_rom_crc32_le(0, area->addr + (size_t)i * SD_CKPT_PAGE_SIZE, page_len(area, i));
+}
+
+/**
+ * @brief 头是否有效且布局与注册的区域一致
+ */
+static bool header_matches(const sd_ckpt_t *ck, const struct sd_ckpt_header *hdr)
+{
+    if (hdr->magic != CKPT_MAGIC || hdr->hdr_crc != header_crc(hdr) || hdr->page_size != SD_CKPT_PAGE_SIZE ||
+        hdr->area_count != ck->area_count || hdr->pages != ck->pages)
+    {
+        return false;
+    }
+    for (uint32_t a = 0; a < ck->area_count; a++)
+    {
+        if (hdr->areas[a].id != ck->areas[a].id || hdr->areas[a].size != ck->areas[a].size)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 读取文件中的第index个头
+ */
+static bool read_header(sd_ckpt_t *ck, int index, struct sd_ckpt_header *hdr)
+{
+    UINT br;
+    return f_lseek(&ck->fil, header_offset(index)) == FR_OK &&
+           f_read(&ck->fil, hdr, SD_CKPT_PAGE_SIZE, &br) == FR_OK && br == SD_CKPT_PAGE_SIZE &&
+           header_matches(ck, hdr);
+}
+
+/**
+ * @brief 用当前注册的区域初始化一个空的头（所有页在槽0）
+ */
+static void header_reset(sd_ckpt_t *ck)
+{
+    memset(ck->hdr, 0, SD_CKPT_PAGE_SIZE);
+    ck->hdr->magic = CKPT_MAGIC;
+    ck->hdr->page_size = SD_CKPT_PAGE_SIZE;
+    ck->hdr->area_count = ck->area_count;
+    ck->hdr->pages = ck->pages;
+    for (uint32_t a = 0; a < ck->area_count; a++)
+    {
+        ck->hdr->areas[a].id = ck->areas[a].id;
+        ck->hdr->areas[a].size = ck->areas[a].size;
+    }
+}
+
+void sd_ckpt_init(sd_ckpt_t *ck)
+{
+    memset(ck, 0, sizeof(*ck));
+}
+
+esp_err_t sd_ckpt_register(sd_ckpt_t *ck, uint32_t id, void *addr, size_t size)
+{
+    if (ck->open)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    uint32_t pages = (size + SD_CKPT_PAGE_SIZE - 1) / SD_CKPT_PAGE_SIZE;
+    if (size == 0 || ck->area_count >= SD_CKPT_MAX_AREAS || ck->pages + pages > SD_CKPT_MAX_PAGES)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    sd_ckpt_area_t *area = &ck->areas[ck->area_count++];
+    area->id = id;
+    area->addr = addr;
+    area->size = size;
+    area->first_page = ck->pages;
+    area->pages = pages;
+    ck->pages += pages;
+    return ESP_OK;
+}
+
+esp_err_t sd_ckpt_open(sd_ckpt_t *ck, sdmmc_card_t *card, const char *name)
+{
+    BYTE pdrv = ff_diskio_get_pdrv_card(card);
+    if (pdrv == 0xFF)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    char path[24];
+    snprintf(path, sizeof(path), "%d:/%s", pdrv, name);
+
+    ck->hdr = calloc(1, SD_CKPT_PAGE_SIZE);
+    ck->prev = calloc(1, SD_CKPT_PAGE_SIZE);
+    if (ck->hdr == NULL || ck->prev == NULL)
+    {
+        free(ck->hdr);
+        free(ck->prev);
+        ck->hdr = NULL;
+        ck->prev = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    FRESULT res = f_open(&ck->fil, path, FA_OPEN_ALWAYS | FA_READ | FA_WRITE);
+    if (res != FR_OK)
+    {
+        ESP_LOGE(TAG, "Failed to open %s (%d)", path, res);
+        free(ck->hdr);
+        free(ck->prev);
+        ck->hdr = NULL;
+        ck->prev = NULL;
+        return ESP_FAIL;
+    }
+    ck->open = true;
+    ck->has_image = false;
+    ck->has_prev = false;
+
+    if (f_size(&ck->fil) == file_size(ck))
+    {
+        // 有效且序号较大的头作为当前的头，另一个有效的头保留用于恢复失败时回退
+        bool a = read_header(ck, 0, ck->hdr);
+        bool b = read_header(ck, 1, ck->prev);
+        if (b && (!a || ck->prev->seq > ck->hdr->seq))
+        {
+            struct sd_ckpt_header *tmp = ck->hdr;
+            ck->hdr = ck->prev;
+            ck->prev = tmp;
+        }
+        ck->has_image = a || b;
+        ck->has_prev = a && b;
+    }
+    else
+    {
+        // 布局改变或新文件：按新的大小分配空间（不写入数据）
+        res = f_lseek(&ck->fil, file_size(ck));
+        if (res == FR_OK && f_tell(&ck->fil) != file_size(ck))
+        {
+            res = FR_DENIED; // 空间不足
+        }
+        if (res == FR_OK)
+        {
+            res = f_truncate(&ck->fil);
+        }
+        if (res == FR_OK)
+        {
+            res = f_sync(&ck->fil);
+        }
+        if (res != FR_OK)
+        {
+            ESP_LOGE(TAG, "Failed to allocate %u bytes for %s (%d)", (unsigned)file_size(ck), path, res);
+            sd_ckpt_close(ck);
+            return res == FR_DENIED ? ESP_ERR_NO_MEM : ESP_FAIL;
+        }
+    }
+    if (!ck->has_image)
+    {
+        header_reset(ck);
+    }
+    // 内存中的内容与检查点的关系未知，恢复之前所有页都需要写入
+    memset(ck->dirty, 0xFF, sizeof(ck->dirty));
+    return ESP_OK;
+}
+
+/**
+ * @brief 按头hdr把检查点读回注册的区域
+ */
+static esp_err_t restore_from(sd_ckpt_t *ck, const struct sd_ckpt_header *hdr)
+{
+    for (uint32_t a = 0; a < ck->area_count; a++)
+    {
+        const sd_ckpt_area_t *area = &ck->areas[a];
+        uint32_t i = 0;
+        while (i < area->pages)
+        {
+            // 同一个槽中连续的页在文件中也连续，合并为一次读取
+            int slot = bit_get(hdr->slot, area->first_page + i);
+            uint32_t n = 1;
+            while (i + n < area->pages && bit_get(hdr->slot, area->first_page + i + n) == slot)
+            {
+                n++;
+            }
+            size_t offset = (size_t)i * SD_CKPT_PAGE_SIZE;
+            UINT len = (UINT)((size_t)(n - 1) * SD_CKPT_PAGE_SIZE + page_len(area, i + n - 1));
+            UINT br;
+            if (f_lseek(&ck->fil, page_offset(ck, area->first_page + i, slot)) != FR_OK ||
+                f_read(&ck->fil, area->addr + offset, len, &br) != FR_OK || br != len)
+            {
+                return ESP_FAIL;
+            }
+            for (uint32_t k = i; k < i + n; k++)
+            {
+                if (page_crc(area, k) != hdr->crc[area->first_page + k])
+                {
+                    ESP_LOGE(TAG, "Checkpoint %u: area %u page %u failed CRC check", (unsigned)hdr->seq,
+                             (unsigned)area->id, (unsigned)k);
+                    return ESP_ERR_INVALID_CRC;
+                }
+            }
+            i += n;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t sd_ckpt_restore(sd_ckpt_t *ck)
+{
+    if (!ck->open || !ck->has_image)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    esp_err_t ret = restore_from(ck, ck->hdr);
+    if (ret == ESP_ERR_INVALID_CRC && ck->has_prev)
+    {
+        ESP_LOGW(TAG, "Falling back to previous checkpoint %u", (unsigned)ck->prev->seq);
+        ret = restore_from(ck, ck->prev);
+        if (ret == ESP_OK)
+        {
+            // 上一次的检查点成为当前的，下次提交的头覆盖损坏的检查点的头
+            struct sd_ckpt_header *tmp = ck->hdr;
+            ck->hdr = ck->prev;
+            ck->prev = tmp;
+            ck->has_prev = false;
+        }
+    }
+    if (ret == ESP_OK)
+    {
+        memset(ck->dirty, 0, sizeof(ck->dirty));
+    }
+    return ret;
+}
+
+void sd_ckpt_mark_dirty(sd_ckpt_t *ck, const void *addr, size_t len)
+{
+    const uint8_t *lo = addr;
+    const uint8_t *hi = lo + len;
+    for (uint32_t a = 0; a < ck->area_count && len > 0; a++)
+    {
+        const sd_ckpt_area_t *area = &ck->areas[a];
+        const uint8_t *start = lo > area->addr ? lo : area->addr;
+        const uint8_t *end = hi < area->addr + area->size ? hi : area->addr + area->size;
+        if (start >= end)
+        {
+            continue;
+        }
+        uint32_t first = (start - area->addr) / SD_CKPT_PAGE_SIZE;
+        uint32_t last = (end - 1 - area->addr) / SD_CKPT_PAGE_SIZE;
+        for (uint32_t i = first; i <= last; i++)
+        {
+            bit_set(ck->dirty, area->first_page + i, true);
+        }
+    }
+}
+
+size_t sd_ckpt_scan(sd_ckpt_t *ck)
+{
+    size_t found = 0;
+    for (uint32_t a = 0; a < ck->area_count; a++)
+    {
+        const sd_ckpt_area_t *area = &ck->areas[a];
+        for (uint32_t i = 0; i < area->pages; i++)
+        {
+            uint32_t page = area->first_page + i;
+            if (!bit_get(ck->dirty, page) && page_crc(area, i) != ck->hdr->crc[page])
+            {
+                bit_set(ck->dirty, page, true);
+                found++;
+            }
+        }
+    }
+    return found;
+}
+
+esp_err_t sd_ckpt_commit(sd_ckpt_t *ck)
+{
+    if (!ck->open)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    uint32_t written = 0;
+    esp_err_t ret = ESP_OK;
+
+    // 改变的页会覆盖较旧的检查点的页，较旧的头从此不再可用；prev改为保存提交前的头，失败时用于还原
+    memcpy(ck->prev, ck->hdr, SD_CKPT_PAGE_SIZE);
+    ck->has_prev = false;
+
+    // 1. 改变的页写到各自未使用的槽，同一区域内目标槽相同的连续页合并为一次写入
+    for (uint32_t a = 0; a < ck->area_count && ret == ESP_OK; a++)
+    {
+        const sd_ckpt_area_t *area = &ck->areas[a];
+        uint32_t i = 0;
+        while (i < area->pages && ret == ESP_OK)
+        {
+            uint32_t page = area->first_page + i;
+            if (!bit_get(ck->dirty, page))
+            {
+                i++;
+                continue;
+            }
+            int slot = !bit_get(ck->hdr->slot, page);
+            uint32_t n = 1;
+            while (i + n < area->pages && bit_get(ck->dirty, page + n) && bit_get(ck->hdr->slot, page + n) != slot)
+            {
+                n++;
+            }
+            UINT len = (UINT)((size_t)(n - 1) * SD_CKPT_PAGE_SIZE + page_len(area, i + n - 1));
+            UINT bw;
+            if (f_lseek(&ck->fil, page_offset(ck, page, slot)) != FR_OK ||
+                f_write(&ck->fil, area->addr + (size_t)i * SD_CKPT_PAGE_SIZE, len, &bw) != FR_OK || bw != len)
+            {
+                ret = ESP_FAIL;
+                break;
+            }
+            for (uint32_t k = 0; k < n; k++)
+            {
+                bit_set(ck->hdr->slot, page + k, slot);
+                ck->hdr->crc[page + k] = page_crc(area, i + k);
+            }
+            written += n;
+            i += n;
+        }
+    }
+    if (ret == ESP_OK && f_sync(&ck->fil) != FR_OK)
+    {
+        ret = ESP_FAIL;
+    }
+
+    // 2. 新的头写到较旧的头的位置，写入并同步后新检查点才生效
+    if (ret == ESP_OK)
+    {
+        ck->hdr->seq++;
+        ck->hdr->hdr_crc = header_crc(ck->hdr);
+        UINT bw;
+        if (f_lseek(&ck->fil, header_offset(ck->hdr->seq)) != FR_OK ||
+            f_write(&ck->fil, ck->hdr, SD_CKPT_PAGE_SIZE, &bw) != FR_OK || bw != SD_CKPT_PAGE_SIZE ||
+            f_sync(&ck->fil) != FR_OK)
+        {
+            // 头可能已经到达卡上而未确认：改写为无效的头，以免之后打开时使用它
+            ck->hdr->magic = 0;
+            if (f_lseek(&ck->fil, header_offset(ck->hdr->seq)) != FR_OK ||
+                f_write(&ck->fil, ck->hdr, SD_CKPT_PAGE_SIZE, &bw) != FR_OK || bw != SD_CKPT_PAGE_SIZE ||
+                f_sync(&ck->fil) != FR_OK)
+            {
+                ESP_LOGE(TAG, "Failed to invalidate checkpoint header %u", (unsigned)ck->hdr->seq);
+            }
+            ret = ESP_FAIL;
+        }
+    }
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Checkpoint commit failed, previous checkpoint kept");
+        memcpy(ck->hdr, ck->prev, SD_CKPT_PAGE_SIZE);
+        return ret;
+    }
+    memset(ck->dirty, 0, sizeof(ck->dirty));
+    ck->has_prev = ck->has_image;
+    ck->has_image = true;
+    ck->pages_written = written;
+    ck->commits++;
+    return ESP_OK;
+}
+
+esp_err_t sd_ckpt_close(sd_ckpt_t *ck)
+{
+    if (!ck->open)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    FRESULT res = f_close(&ck->fil);
+    free(ck->hdr);
+    free(ck->prev);
+    ck->hdr = NULL;
+    ck->prev = NULL;
+    ck->open = false;
+    return res == FR_OK ? ESP_OK : ESP_FAIL;
+}
+
+/**
+ * @brief 整体转储：把所有区域顺序写入一个文件并同步，即改用增量检查点之前的做法
+ */
+static esp_err_t full_dump(const sd_ckpt_t *ck)
+{
+    FILE *f = fopen(CKPT_BENCH_DUMP, "w");
+    if (f == NULL)
+    {
+        return ESP_FAIL;
+    }
+    esp_err_t ret = ESP_OK;
+    for (uint32_t a = 0; a < ck->area_count && ret == ESP_OK; a++)
+    {
+        if (fwrite(ck->areas[a].addr, 1, ck->areas[a].size, f) != ck->areas[a].size)
+        {
+            ret = ESP_FAIL;
+        }
+    }
+    if (fflush(f) != 0 || fsync(fileno(f)) != 0)
+    {
+        ret = ESP_FAIL;
+    }
+    if (fclose(f) != 0)
+    {
+        ret = ESP_FAIL;
+    }
+    return ret;
+}
+
+/**
+ * @brief 修改count个随机页中的一个字节，mark为true时同时标记
+ */
+static void touch_pages(sd_ckpt_t *ck, uint32_t count, bool mark)
+{
+    for (uint32_t n = 0; n < count; n++)
+    {
+        uint32_t page = esp_random() % ck->pages;
+        for (uint32_t a = 0; a < ck->area_count; a++)
+        {
+            sd_ckpt_area_t *area = &ck->areas[a];
+            if (page >= area->first_page && page < area->first_page + area->pages)
+            {
+                uint8_t *p = area->addr + (size_t)(page - area->first_page) * SD_CKPT_PAGE_SIZE;
+                (*p)++;
+                if (mark)
+                {
+                    sd_ckpt_mark_dirty(ck, p, 1);
+                }
+                break;
+            }
+        }
+    }
+}
+
+static uint32_t state_crc(const sd_ckpt_t *ck)
+{
+    uint32_t crc = 0;
+    for (uint32_t a = 0; a < ck->area_count; a++)
+    {
+        crc = esp_rom_crc32_le(crc, ck->areas[a].addr, ck->areas[a].size);
+    }
+    return crc;
+}
+
+void sd_ckpt_bench_run(sdmmc_card_t *card)
+{
+    uint8_t *model = malloc(CKPT_BENCH_MODEL_SIZE);
+    uint8_t *buffer = malloc(CKPT_BENCH_BUFFER_SIZE);
+    // 句柄包含FIL，放在堆上以免占用主任务的栈
+    sd_ckpt_t *ck = calloc(1, sizeof(sd_ckpt_t));
+    if (model == NULL || buffer == NULL || ck == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate %u KB of test state",
+                 (unsigned)((CKPT_BENCH_MODEL_SIZE + CKPT_BENCH_BUFFER_SIZE) / 1024));
+        free(model);
+        free(buffer);
+        free(ck);
+        return;
+    }
+    for (size_t i = 0; i < CKPT_BENCH_MODEL_SIZE; i += 4)
+    {
+        *(uint32_t *)(model + i) = esp_random();
+    }
+    memset(buffer, 0x5A, CKPT_BENCH_BUFFER_SIZE);
+
+    sd_ckpt_init(ck);
+    sd_ckpt_register(ck, 1, model, CKPT_BENCH_MODEL_SIZE);
+    sd_ckpt_register(ck, 2, buffer, CKPT_BENCH_BUFFER_SIZE);
+    if (sd_ckpt_open(ck, card, CKPT_BENCH_NAME) != ESP_OK)
+    {
+        free(model);
+        free(buffer);
+        free(ck);
+        return;
+    }
+    size_t state_kb = (CKPT_BENCH_MODEL_SIZE + CKPT_BENCH_BUFFER_SIZE) / 1024;
+    printf("\nIncremental checkpoint (%u KB state in %u pages of %u KB):\n", (unsigned)state_kb,
+           (unsigned)ck->pages, SD_CKPT_PAGE_SIZE / 1024);
+    printf("  %-8s %8s %10s %10s %8s\n", "dirty", "pages", "ckpt ms", "dump ms", "speedup");
+
+    // 第一次提交写入所有页
+    esp_err_t ret = sd_ckpt_commit(ck);
+    static const int percents[] = {1, 10, 25, 50, 100};
+    for (size_t i = 0; i < sizeof(percents) / sizeof(percents[0]) && ret == ESP_OK; i++)
+    {
+        touch_pages(ck, (ck->pages * percents[i] + 99) / 100, true);
+        int64_t start = esp_timer_get_time();
+        ret = sd_ckpt_commit(ck);
+        int64_t ckpt_us = esp_timer_get_time() - start;
+        start = esp_timer_get_time();
+        esp_err_t dump_ret = full_dump(ck);
+        int64_t dump_us = esp_timer_get_time() - start;
+        if (ret != ESP_OK || dump_ret != ESP_OK)
+        {
+            printf("  %7d%% failed\n", percents[i]);
+            break;
+        }
+        printf("  %7d%% %8u %10.1f %10.1f %7.1fx\n", percents[i], (unsigned)ck->pages_written, ckpt_us / 1000.0,
+               dump_us / 1000.0, (double)dump_us / ckpt_us);
+    }
+    unlink(CKPT_BENCH_DUMP);
+
+    // 未标记的修改：扫描按CRC找出改变的页
+    if (ret == ESP_OK)
+    {
+        touch_pages(ck, ck->pages / 10, false);
+        int64_t start = esp_timer_get_time();
+        size_t found = sd_ckpt_scan(ck);
+        int64_t scan_us = esp_timer_get_time() - start;
+        ret = sd_ckpt_commit(ck);
+        printf("  scan: %u changed pages found in %.1f ms\n", (unsigned)found, scan_us / 1000.0);
+    }
+
+    // 恢复：清空内存后从检查点读回，并与提交时的内容比较
+    uint32_t expected = state_crc(ck);
+    sd_ckpt_close(ck);
+    if (ret == ESP_OK)
+    {
+        memset(model, 0, CKPT_BENCH_MODEL_SIZE);
+        memset(buffer, 0, CKPT_BENCH_BUFFER_SIZE);
+        sd_ckpt_init(ck);
+        sd_ckpt_register(ck, 1, model, CKPT_BENCH_MODEL_SIZE);
+        sd_ckpt_register(ck, 2, buffer, CKPT_BENCH_BUFFER_SIZE);
+        int64_t start = esp_timer_get_time();
+        ret = sd_ckpt_open(ck, card, CKPT_BENCH_NAME);
+        if (ret == ESP_OK)
+        {
+            ret = sd_ckpt_restore(ck);
+            int64_t restore_us = esp_timer_get_time() - start;
+            bool match = ret == ESP_OK && state_crc(ck) == expected;
+            printf("  restore: %.1f ms (%.2f MB/s), seq %u, %s\n", restore_us / 1000.0,
+                   (state_kb / 1024.0) / (restore_us / 1000000.0), (unsigned)ck->hdr->seq,
+                   match ? "contents match" : "MISMATCH");
+            sd_ckpt_close(ck);
+        }
+    }
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Checkpoint benchmark failed (%s)", esp_err_to_name(ret));
+    }
+    printf("\n");
+
+    char path[24];
+    snprintf(path, sizeof(path), "%d:/%s", ff_diskio_get_pdrv_card(card), CKPT_BENCH_NAME);
+    f_unlink(path);
+    free(model);
+    free(buffer);
+    free(ck);
+}
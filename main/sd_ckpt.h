@@ -0,0 +1,143 @@
+/*
+ * 增量应用状态检查点
+ *
+ * 把若干块注册的内存区域保存到卡上的一个检查点文件中，每次只写自上次提交以来改变的页。
+ * 页的变化由调用者用sd_ckpt_mark_dirty标记，也可以用sd_ckpt_scan按页CRC查找未标记的修改。
+ *
+ * 文件布局（影子页）：
+ *   [头A][头B][槽0：页0..N-1][槽1：页0..N-1]
+ * 每页在两个槽中各有一个位置，头中记录每页当前所在的槽和CRC。提交时：
+ * 1. 改变的页写到它不在使用的那个槽，已提交的数据不被覆盖
+ * 2. 同步后把序号加1的新头写到另一个头的位置（较旧的那个）并同步
+ * 头带CRC，写到一半掉电时恢复使用另一个（上一次提交的）头，因此提交是原子的。
+ * 头写入或同步失败时，该位置的头被改写为无效，避免卡上留下未确认的头。
+ * 两个头都有效时都保留在内存中：较新的头指向的页校验失败时，恢复改用较旧的头。
+ *
+ * 启动时按相同的顺序注册区域后调用sd_ckpt_restore，同一个槽中连续的页合并为一次读取。
+ *
+ * 注意：提交期间调用者不能修改注册的区域，否则检查点中的页可能不一致。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "sdmmc_cmd.h"
+#include "ff.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SD_CKPT_PAGE_SIZE 4096 // 页大小，也是文件中头和页的对齐单位
+#define SD_CKPT_MAX_AREAS 8    // 最多注册的区域数
+#define SD_CKPT_MAX_PAGES 512  // 所有区域的总页数上限（2MB）
+
+/**
+ * @brief 注册的内存区域
+ */
+typedef struct
+{
+    uint32_t id;         // 区域标识，恢复时必须与保存时一致
+    uint8_t *addr;       // 起始地址
+    size_t size;         // 字节数
+    uint32_t first_page; // 区域第一页在文件中的页号
+    uint32_t pages;      // 区域的页数（最后一页可能不满）
+} sd_ckpt_area_t;
+
+struct sd_ckpt_header;
+
+/**
+ * @brief 检查点句柄
+ */
+typedef struct
+{
+    sd_ckpt_area_t areas[SD_CKPT_MAX_AREAS]; // 注册的区域
+    uint32_t area_count;                     // 区域数
+    uint32_t pages;                          // 总页数
+    FIL fil;                                 // 检查点文件
+    bool open;                               // 文件已打开
+    bool has_image;                          // 文件中有有效的检查点
+    bool has_prev;                           // prev是有效的上一次提交的头
+    struct sd_ckpt_header *hdr;              // 最近一次提交的头（SD_CKPT_PAGE_SIZE字节）
+    struct sd_ckpt_header *prev;             // 另一个头位置上的较旧的头（SD_CKPT_PAGE_SIZE字节）
+    uint8_t dirty[SD_CKPT_MAX_PAGES / 8];    // 自上次提交以来改变的页
+
+    // 统计信息
+    uint32_t pages_written; // 最近一次提交写入的页数
+    uint32_t commits;       // 成功提交的次数
+} sd_ckpt_t;
+
+/**
+ * @brief 初始化句柄
+ */
+void sd_ckpt_init(sd_ckpt_t *ck);
+
+/**
+ * @brief 注册一块内存区域（必须在sd_ckpt_open之前）
+ *
+ * @return ESP_OK 成功，ESP_ERR_INVALID_STATE 已打开，ESP_ERR_NO_MEM 超出区域数或页数上限
+ */
+esp_err_t sd_ckpt_register(sd_ckpt_t *ck, uint32_t id, void *addr, size_t size);
+
+/**
+ * @brief 打开卡根目录下的检查点文件，不存在或布局与注册的区域不符时重新创建
+ *
+ * 打开后所有页都标记为已改变，调用sd_ckpt_restore后才清除。
+ *
+ * @param ck   句柄
+ * @param card 已通过sd_mount挂载的SD卡
+ * @param name 文件名（8.3格式，位于根目录）
+ * @return ESP_OK 成功，ESP_ERR_NOT_FOUND 卡未挂载到FATFS，ESP_ERR_NO_MEM 内存或空间不足，ESP_FAIL 文件操作失败
+ */
+esp_err_t sd_ckpt_open(sd_ckpt_t *ck, sdmmc_card_t *card, const char *name);
+
+/**
+ * @brief 把最近一次提交的检查点读回注册的区域，并校验每页的CRC
+ *
+ * 页校验失败且有上一次提交的头时，改为恢复上一次的检查点，之后的提交以它为基础。
+ *
+ * @return ESP_OK 成功，ESP_ERR_NOT_FOUND 没有有效的检查点，ESP_ERR_INVALID_CRC 两个检查点的页校验都失败，
+ *         ESP_FAIL 读取失败
+ */
+esp_err_t sd_ckpt_restore(sd_ckpt_t *ck);
+
+/**
+ * @brief 标记[addr, addr + len)所在的页已改变（不在注册区域内的部分被忽略）
+ */
+void sd_ckpt_mark_dirty(sd_ckpt_t *ck, const void *addr, size_t len);
+
+/**
+ * @brief 比较未标记页的CRC与检查点中的CRC，把不同的页标记为已改变
+ *
+ * @return 新标记的页数
+ */
+size_t sd_ckpt_scan(sd_ckpt_t *ck);
+
+/**
+ * @brief 写入改变的页并原子地提交新的检查点
+ *
+ * 失败时已提交的检查点不变，改变的页保持标记，可以重试。
+ *
+ * @return ESP_OK 成功，ESP_FAIL 写入失败
+ */
+esp_err_t sd_ckpt_commit(sd_ckpt_t *ck);
+
+/**
+ * @brief 关闭检查点文件并释放资源（不提交）
+ */
+esp_err_t sd_ckpt_close(sd_ckpt_t *ck);
+
+/**
+ * @brief 对比不同改变比例下增量检查点与整体转储的耗时，并测量恢复速度
+ *
+ * @param card 已通过sd_mount挂载的SD卡
+ */
+void sd_ckpt_bench_run(sdmmc_card_t *card);
+
+#ifdef __cplusplus
+}
+#endif
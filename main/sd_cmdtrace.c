@@ -0,0 +1,273 @@
+/*
+ * SD命令级延迟分解实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <sys/unistd.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/sdmmc_defs.h"
+#include "sd_cmdtrace.h"
+#include "sd_bench.h"
+
+static const char *TAG = "sd_cmdtrace";
+
+static const char *const s_phase_names[SD_CMDTRACE_PHASE_MAX] = {
+    "cmd", "read data", "write data", "write busy",
+};
+
+typedef esp_err_t (*do_transaction_fn)(int slot, sdmmc_command_t *cmd);
+
+static sdmmc_card_t *s_card;
+static do_transaction_fn s_orig;
+static bool s_spi;
+
+// 统计可能被多个任务同时更新，主机驱动本身的互斥锁只覆盖原始的do_transaction
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static sd_cmdtrace_hist_t s_hist[SD_CMDTRACE_PHASE_MAX];
+static sd_cmdtrace_rec_t s_ring[SD_CMDTRACE_RING];
+static uint32_t s_ring_next;
+
+// 写命令结束后等待CMD13报告READY_FOR_DATA
+static bool s_busy_pending;
+static int64_t s_busy_start;
+
+static int bucket_of(uint32_t us)
+{
+    int b = 0;
+    while (us > 0 && b < SD_CMDTRACE_BUCKETS - 1)
+    {
+        us >>= 1;
+        b++;
+    }
+    return b;
+}
+
+static void hist_add(sd_cmdtrace_hist_t *h, uint32_t us)
+{
+    h->count++;
+    h->total_us += us;
+    if (us > h->max_us)
+    {
+        h->max_us = us;
+    }
+    h->buckets[bucket_of(us)]++;
+}
+
+static esp_err_t traced_transaction(int slot, sdmmc_command_t *cmd)
+{
+    int64_t t0 = esp_timer_get_time();
+    esp_err_t ret = s_orig(slot, cmd);
+    int64_t t1 = esp_timer_get_time();
+    esp_err_t err = ret == ESP_OK ? cmd->error : ret;
+
+    sd_cmdtrace_phase_t phase = SD_CMDTRACE_CMD;
+    if (cmd->data != NULL && cmd->datalen > 0)
+    {
+        phase = (cmd->flags & SCF_CMD_READ) ? SD_CMDTRACE_READ : SD_CMDTRACE_WRITE;
+    }
+    else if (cmd->opcode == MMC_SEND_STATUS && s_busy_pending)
+    {
+        phase = SD_CMDTRACE_BUSY;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    sd_cmdtrace_rec_t *rec = &s_ring[s_ring_next++ % SD_CMDTRACE_RING];
+    rec->issue_us = t0;
+    rec->dur_us = (uint32_t)(t1 - t0);
+    rec->opcode = cmd->opcode;
+    rec->phase = phase;
+    rec->blocks = cmd->blklen > 0 ? cmd->datalen / cmd->blklen : 0;
+    rec->err = err;
+
+    if (phase == SD_CMDTRACE_BUSY)
+    {
+        // 轮询命令不计入cmd阶段，整个轮询过程作为一次忙等待
+        if (err == ESP_OK && (MMC_R1(cmd->response) & MMC_R1_READY_FOR_DATA))
+        {
+            hist_add(&s_hist[SD_CMDTRACE_BUSY], (uint32_t)(t1 - s_busy_start));
+            s_busy_pending = false;
+        }
+    }
+    else
+    {
+        hist_add(&s_hist[phase], rec->dur_us);
+        // 写命令之后如果不是CMD13（例如SDSPI，或驱动直接发下一条命令），忙等待无法测量
+        s_busy_pending = phase == SD_CMDTRACE_WRITE && err == ESP_OK && !s_spi;
+        s_busy_start = t1;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return ret;
+}
+
+void sd_cmdtrace_reset(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    memset(s_hist, 0, sizeof(s_hist));
+    memset(s_ring, 0, sizeof(s_ring));
+    s_ring_next = 0;
+    s_busy_pending = false;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+esp_err_t sd_cmdtrace_attach(sdmmc_card_t *card)
+{
+    if (s_card != NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    sd_cmdtrace_reset();
+    s_card = card;
+    s_spi = (card->host.flags & SDMMC_HOST_FLAG_SPI) != 0;
+    s_orig = card->host.do_transaction;
+    card->host.do_transaction = traced_transaction;
+    return ESP_OK;
+}
+
+void sd_cmdtrace_detach(sdmmc_card_t *card)
+{
+    if (s_card != card)
+    {
+        return;
+    }
+    card->host.do_transaction = s_orig;
+    s_card = NULL;
+}
+
+void sd_cmdtrace_get(sd_cmdtrace_phase_t phase, sd_cmdtrace_hist_t *hist)
+{
+    portENTER_CRITICAL(&s_lock);
+    *hist = s_hist[phase];
+    portEXIT_CRITICAL(&s_lock);
+}
+
+/**
+ * @brief 打印用的统计快照
+ */
+typedef struct
+{
+    sd_cmdtrace_hist_t hist[SD_CMDTRACE_PHASE_MAX];
+    sd_cmdtrace_rec_t ring[SD_CMDTRACE_RING];
+} cmdtrace_snapshot_t;
+
+void sd_cmdtrace_print(int recent)
+{
+    // 快照约1KB，放在堆上以免占用调用者（如控制台任务）的栈；打印不能在临界区内进行
+    cmdtrace_snapshot_t *snap = malloc(sizeof(cmdtrace_snapshot_t));
+    if (snap == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate trace snapshot");
+        return;
+    }
+    const sd_cmdtrace_hist_t *hist = snap->hist;
+    const sd_cmdtrace_rec_t *ring = snap->ring;
+    portENTER_CRITICAL(&s_lock);
+    memcpy(snap->hist, s_hist, sizeof(snap->hist));
+    memcpy(snap->ring, s_ring, sizeof(snap->ring));
+    uint32_t next = s_ring_next;
+    portEXIT_CRITICAL(&s_lock);
+
+    printf("\nCommand latency breakdown:\n");
+    printf("  %-10s %8s %10s %8s %8s\n", "phase", "count", "total ms", "avg us", "max us");
+    for (int p = 0; p < SD_CMDTRACE_PHASE_MAX; p++)
+    {
+        const sd_cmdtrace_hist_t *h = &hist[p];
+        printf("  %-10s %8u %10.1f %8.0f %8u\n", s_phase_names[p], (unsigned)h->count, h->total_us / 1000.0,
+               h->count ? (double)h->total_us / h->count : 0.0, (unsigned)h->max_us);
+    }
+
+    // 写入路径中传输与忙等待的占比；数据阶段包含一次命令往返，用cmd阶段的平均值扣除
+    const sd_cmdtrace_hist_t *cmd = &hist[SD_CMDTRACE_CMD];
+    const sd_cmdtrace_hist_t *wr = &hist[SD_CMDTRACE_WRITE];
+    const sd_cmdtrace_hist_t *busy = &hist[SD_CMDTRACE_BUSY];
+    double cmd_avg = cmd->count ? (double)cmd->total_us / cmd->count : 0;
+    double wr_cmd = cmd_avg * wr->count;
+    double wr_xfer = wr->total_us > wr_cmd ? wr->total_us - wr_cmd : 0;
+    double wr_total = wr->total_us + busy->total_us;
+    if (wr_total > 0)
+    {
+        printf("  Write path: command %.1f%%, transfer %.1f%%, busy %.1f%%%s\n",
+               wr_cmd * 100 / wr_total, wr_xfer * 100 / wr_total, busy->total_us * 100 / wr_total,
+               s_spi ? " (SPI: busy is included in transfer)" : "");
+    }
+
+    for (int p = 0; p < SD_CMDTRACE_PHASE_MAX; p++)
+    {
+        const sd_cmdtrace_hist_t *h = &hist[p];
+        if (h->count == 0)
+        {
+            continue;
+        }
+        uint32_t peak = 0;
+        for (int b = 0; b < SD_CMDTRACE_BUCKETS; b++)
+        {
+            peak = h->buckets[b] > peak ? h->buckets[b] : peak;
+        }
+        printf("\n  %s (us):\n", s_phase_names[p]);
+        for (int b = 0; b < SD_CMDTRACE_BUCKETS; b++)
+        {
+            if (h->buckets[b] == 0)
+            {
+                continue;
+            }
+            char range[24];
+            if (b == 0)
+            {
+                snprintf(range, sizeof(range), "<1");
+            }
+            else if (b == SD_CMDTRACE_BUCKETS - 1)
+            {
+                snprintf(range, sizeof(range), ">=%u", 1u << (b - 1));
+            }
+            else
+            {
+                snprintf(range, sizeof(range), "%u-%u", 1u << (b - 1), (1u << b) - 1);
+            }
+            int bar = (int)(h->buckets[b] * 40ULL / peak);
+            printf("  %12s %7u |%.*s\n", range, (unsigned)h->buckets[b], bar > 0 ? bar : 1,
+                   "########################################");
+        }
+    }
+
+    int n = recent < SD_CMDTRACE_RING ? recent : SD_CMDTRACE_RING;
+    n = (uint32_t)n < next ? n : (int)next;
+    if (n > 0)
+    {
+        printf("\n  Last %d commands:\n", n);
+        printf("  %12s %5s %6s %-10s %8s  %s\n", "issue us", "cmd", "blocks", "phase", "dur us", "result");
+        for (uint32_t i = next - n; i < next; i++)
+        {
+            const sd_cmdtrace_rec_t *r = &ring[i % SD_CMDTRACE_RING];
+            printf("  %12lld %5u %6u %-10s %8u  %s\n", (long long)r->issue_us, r->opcode, r->blocks,
+                   s_phase_names[r->phase], (unsigned)r->dur_us, esp_err_to_name(r->err));
+        }
+    }
+    printf("\n");
+    free(snap);
+}
+
+void sd_cmdtrace_bench_run(sdmmc_card_t *card)
+{
+    if (sd_cmdtrace_attach(card) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Command trace already attached");
+        return;
+    }
+    ESP_LOGI(TAG, "Tracing host commands during a write/read pass");
+
+    sd_bench_params_t params = SD_BENCH_PARAMS_DEFAULT();
+    params.cold_read = false;
+    sd_bench_result_t result;
+    if (sd_bench_write(&params, &result) == ESP_OK)
+    {
+        sd_bench_read(&params, &result);
+        unlink(params.path);
+    }
+
+    sd_cmdtrace_detach(card);
+    sd_cmdtrace_print(16);
+}
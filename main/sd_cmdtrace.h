@@ -0,0 +1,102 @@
+/*
+ * SD命令级延迟分解
+ *
+ * 替换card->host.do_transaction，为经过主机驱动的每条命令记录时间戳，
+ * 并按阶段统计对数直方图：
+ * - cmd：无数据命令从发出到收到响应的时间（不含写入后的状态轮询）
+ * - read data：读命令从发出到数据传输结束（含命令/响应和自动CMD12）
+ * - write data：写命令从发出到数据传输结束
+ * - write busy：写命令结束到CMD13报告READY_FOR_DATA为止，即卡在DAT0上保持忙的编程时间
+ *
+ * 主机驱动内部的命令发出、响应和数据阶段无法单独计时，因此数据阶段包含一次命令往返，
+ * 可参考cmd阶段的平均值扣除。SDSPI模式下主机驱动在写命令内部等待忙信号，
+ * busy时间包含在write data中。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdmmc_cmd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SD_CMDTRACE_BUCKETS 17 // 直方图桶数：[0,1) [1,2) [2,4) ... [32768,65536) >=65536 us
+#define SD_CMDTRACE_RING 32    // 保留最近多少条命令的时间戳
+
+/**
+ * @brief 命令阶段
+ */
+typedef enum
+{
+    SD_CMDTRACE_CMD = 0,    // 无数据命令
+    SD_CMDTRACE_READ,       // 读数据命令
+    SD_CMDTRACE_WRITE,      // 写数据命令
+    SD_CMDTRACE_BUSY,       // 写入后的忙等待
+    SD_CMDTRACE_PHASE_MAX,
+} sd_cmdtrace_phase_t;
+
+/**
+ * @brief 一个阶段的直方图
+ */
+typedef struct
+{
+    uint32_t count;                        // 次数
+    int64_t total_us;                      // 累计时间
+    uint32_t max_us;                       // 最大值
+    uint32_t buckets[SD_CMDTRACE_BUCKETS]; // 对数直方图
+} sd_cmdtrace_hist_t;
+
+/**
+ * @brief 一条命令的记录
+ */
+typedef struct
+{
+    int64_t issue_us;  // 发出时刻（esp_timer）
+    uint32_t dur_us;   // 从发出到返回的时间
+    uint8_t opcode;    // 命令号
+    uint8_t phase;     // sd_cmdtrace_phase_t
+    uint16_t blocks;   // 数据块数
+    esp_err_t err;     // 结果
+} sd_cmdtrace_rec_t;
+
+/**
+ * @brief 开始跟踪：替换card->host.do_transaction并清零统计
+ *
+ * 同一时间只能跟踪一张卡。卸载SD卡前必须先调用sd_cmdtrace_detach。
+ *
+ * @return ESP_OK 成功，ESP_ERR_INVALID_STATE 已在跟踪
+ */
+esp_err_t sd_cmdtrace_attach(sdmmc_card_t *card);
+
+/**
+ * @brief 停止跟踪并恢复原来的do_transaction
+ */
+void sd_cmdtrace_detach(sdmmc_card_t *card);
+
+/**
+ * @brief 清零直方图和命令记录
+ */
+void sd_cmdtrace_reset(void);
+
+/**
+ * @brief 获取一个阶段的直方图
+ */
+void sd_cmdtrace_get(sd_cmdtrace_phase_t phase, sd_cmdtrace_hist_t *hist);
+
+/**
+ * @brief 打印各阶段汇总和直方图，以及最近的recent条命令记录
+ */
+void sd_cmdtrace_print(int recent);
+
+/**
+ * @brief 在跟踪下运行一次写入和读取测试，并输出延迟分解
+ */
+void sd_cmdtrace_bench_run(sdmmc_card_t *card);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,549 @@
+/*
+ * 运行时测试控制台实现
+ *
+ * 所有命令都在REPL任务中执行，挂载状态只由该任务访问。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <errno.h>
+#include <math.h>
+#include <sys/unistd.h>
+#include <sys/stat.h>
+#include "esp_log.h"
+#include "esp_console.h"
+#include "argtable3/argtable3.h"
+#include "diskio_sdmmc.h"
+#include "ff.h"
+#include "sd_console.h"
+#include "sd_bench.h"
+#include "sd_mem_stats.h"
+#include "sd_erase.h"
+
+#define CONSOLE_STACK_SIZE 8192            // 测试在REPL任务中运行，需要比默认值更大的栈
+#define CONSOLE_RAND_BLOCK_SIZE (4 * 1024) // bench rand默认块大小
+#define CONSOLE_RAND_COUNT 1000            // bench rand默认次数
+
+static const char *TAG = "sd_console";
+
+static sd_mount_params_t s_mount_params; // 下一次mount使用的参数（在上一次的基础上修改）
+static sd_mount_t s_mnt;                 // 当前挂载状态
+
+/**
+ * @brief 最近一次测试结果，stats命令输出
+ */
+typedef struct
+{
+    char label[16];  // 测试名称
+    size_t buf_size; // 缓冲区（或随机读写块）大小
+    int runs;        // 重复次数
+    float min_mb;    // 最低速度
+    float mean_mb;   // 平均速度
+    float max_mb;    // 最高速度
+    float stdev_mb;  // 速度标准差
+    float iops;      // 平均IOPS（仅随机读写）
+} console_last_t;
+
+static console_last_t s_last[4];
+static int s_last_count;
+
+static struct
+{
+    struct arg_str *action;
+    struct arg_str *buf;
+    struct arg_str *size;
+    struct arg_str *block;
+    struct arg_str *pattern;
+    struct arg_int *repeat;
+    struct arg_int *count;
+    struct arg_lit *write;
+    struct arg_lit *keep;
+    struct arg_end *end;
+} s_bench_args;
+
+static struct
+{
+    struct arg_int *freq;
+    struct arg_int *width;
+    struct arg_str *bus;
+    struct arg_end *end;
+} s_mount_args;
+
+static struct
+{
+    struct arg_lit *yes;
+    struct arg_end *end;
+} s_wipe_args;
+
+/**
+ * @brief 解析带k/m后缀的大小，例如"64k"、"16m"，超出size_t范围时返回false
+ */
+static bool parse_size(const char *str, size_t *out)
+{
+    // strtoul接受负数并按无符号数回绕，先排除
+    if (strchr(str, '-') != NULL)
+    {
+        return false;
+    }
+    char *end = NULL;
+    errno = 0;
+    unsigned long long value = strtoull(str, &end, 0);
+    if (end == str || errno == ERANGE)
+    {
+        return false;
+    }
+    size_t multiplier = 1;
+    if (*end == 'k' || *end == 'K')
+    {
+        multiplier = 1024;
+        end++;
+    }
+    else if (*end == 'm' || *end == 'M')
+    {
+        multiplier = 1024 * 1024;
+        end++;
+    }
+    if (*end != '\0' || value == 0 || value > SIZE_MAX / multiplier)
+    {
+        return false;
+    }
+    *out = (size_t)value * multiplier;
+    return true;
+}
+
+/**
+ * @brief 解析可选的大小参数，未指定时保持*out不变
+ */
+static bool parse_size_arg(struct arg_str *arg, const char *name, size_t *out)
+{
+    if (arg->count == 0)
+    {
+        return true;
+    }
+    if (!parse_size(arg->sval[0], out))
+    {
+        printf("Invalid %s: %s\n", name, arg->sval[0]);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 记录一次重复测试的统计结果（同名测试覆盖旧结果）
+ */
+static console_last_t *last_result(const char *label)
+{
+    for (int i = 0; i < s_last_count; i++)
+    {
+        if (strcmp(s_last[i].label, label) == 0)
+        {
+            return &s_last[i];
+        }
+    }
+    if (s_last_count == sizeof(s_last) / sizeof(s_last[0]))
+    {
+        s_last_count--;
+        memmove(&s_last[0], &s_last[1], sizeof(s_last[0]) * s_last_count);
+    }
+    console_last_t *last = &s_last[s_last_count++];
+    memset(last, 0, sizeof(*last));
+    strlcpy(last->label, label, sizeof(last->label));
+    return last;
+}
+
+/**
+ * @brief 确保测试文件存在且不小于file_size，否则先写入一个
+ */
+static esp_err_t ensure_test_file(const sd_bench_params_t *params)
+{
+    struct stat st;
+    if (stat(params->path, &st) == 0 && (size_t)st.st_size >= params->file_size)
+    {
+        return ESP_OK;
+    }
+    printf("Creating %u-byte test file %s\n", (unsigned)params->file_size, params->path);
+    sd_bench_result_t result;
+    return sd_bench_write(params, &result);
+}
+
+/**
+ * @brief 重复运行一项测试并输出最小/平均/最大速度和标准差
+ *
+ * @param action write、read或rand
+ */
+static int run_repeated(const char *action, const sd_bench_params_t *params, int repeat,
+                        size_t block_size, int count, bool rand_write)
+{
+    float min_mb = 0, max_mb = 0, mean_mb = 0, m2 = 0, iops_sum = 0;
+    int runs = 0;
+    for (int i = 0; i < repeat; i++)
+    {
+        sd_bench_result_t result;
+        esp_err_t ret;
+        if (strcmp(action, "write") == 0)
+        {
+            ret = sd_bench_write(params, &result);
+        }
+        else if (strcmp(action, "read") == 0)
+        {
+            ret = sd_bench_read(params, &result);
+        }
+        else
+        {
+            ret = sd_bench_random(params, block_size, count, rand_write, &result);
+        }
+        if (ret != ESP_OK)
+        {
+            printf("%s: run %d failed (%s)\n", action, i + 1, esp_err_to_name(ret));
+            break;
+        }
+
+        // Welford算法累计均值和方差
+        runs++;
+        float delta = result.speed_mb - mean_mb;
+        mean_mb += delta / runs;
+        m2 += delta * (result.speed_mb - mean_mb);
+        min_mb = (runs == 1 || result.speed_mb < min_mb) ? result.speed_mb : min_mb;
+        max_mb = (runs == 1 || result.speed_mb > max_mb) ? result.speed_mb : max_mb;
+        float iops = count / result.seconds;
+        iops_sum += iops;
+        if (strcmp(action, "rand") == 0)
+        {
+            printf("%s: run %d/%d  %8.2f MB/s  %8.1f IOPS\n", action, i + 1, repeat, result.speed_mb, iops);
+        }
+        else
+        {
+            printf("%s: run %d/%d  %8.2f MB/s\n", action, i + 1, repeat, result.speed_mb);
+        }
+    }
+    if (runs == 0)
+    {
+        return 1;
+    }
+
+    char label[16];
+    snprintf(label, sizeof(label), "%s%s", action, strcmp(action, "rand") == 0 && rand_write ? "-w" : "");
+    console_last_t *last = last_result(label);
+    last->buf_size = strcmp(action, "rand") == 0 ? block_size : params->buf_size;
+    last->runs = runs;
+    last->min_mb = min_mb;
+    last->mean_mb = mean_mb;
+    last->max_mb = max_mb;
+    last->stdev_mb = runs > 1 ? sqrtf(m2 / (runs - 1)) : 0;
+    last->iops = strcmp(action, "rand") == 0 ? iops_sum / runs : 0;
+    printf("%s: %d run(s), min %.2f / mean %.2f / max %.2f MB/s, stdev %.2f\n",
+           label, runs, min_mb, mean_mb, max_mb, last->stdev_mb);
+    return runs == repeat ? 0 : 1;
+}
+
+static int cmd_bench(int argc, char **argv)
+{
+    if (arg_parse(argc, argv, (void **)&s_bench_args) != 0)
+    {
+        arg_print_errors(stderr, s_bench_args.end, argv[0]);
+        return 1;
+    }
+    if (s_mnt.card == NULL)
+    {
+        printf("Card is not mounted, use 'mount' first\n");
+        return 1;
+    }
+
+    sd_bench_params_t params = SD_BENCH_PARAMS_DEFAULT();
+    params.cold_read = false;
+    size_t block_size = CONSOLE_RAND_BLOCK_SIZE;
+    if (!parse_size_arg(s_bench_args.buf, "buffer size", &params.buf_size) ||
+        !parse_size_arg(s_bench_args.size, "file size", &params.file_size) ||
+        !parse_size_arg(s_bench_args.block, "block size", &block_size))
+    {
+        return 1;
+    }
+    if (s_bench_args.pattern->count)
+    {
+        const char *pattern = s_bench_args.pattern->sval[0];
+        if (strcmp(pattern, "seq") == 0)
+        {
+            params.pattern = SD_BENCH_PATTERN_SEQ;
+        }
+        else if (strcmp(pattern, "zero") == 0)
+        {
+            params.pattern = SD_BENCH_PATTERN_ZERO;
+        }
+        else if (strcmp(pattern, "random") == 0)
+        {
+            params.pattern = SD_BENCH_PATTERN_RANDOM;
+        }
+        else
+        {
+            printf("Invalid pattern: %s (seq, zero or random)\n", pattern);
+            return 1;
+        }
+    }
+    int repeat = s_bench_args.repeat->count ? s_bench_args.repeat->ival[0] : 1;
+    int count = s_bench_args.count->count ? s_bench_args.count->ival[0] : CONSOLE_RAND_COUNT;
+    if (repeat < 1 || count < 1)
+    {
+        printf("--repeat and --count must be positive\n");
+        return 1;
+    }
+
+    const char *action = s_bench_args.action->sval[0];
+    int ret;
+    if (strcmp(action, "write") == 0)
+    {
+        ret = run_repeated(action, &params, repeat, 0, 0, false);
+        if (s_bench_args.keep->count == 0)
+        {
+            unlink(params.path);
+        }
+    }
+    else if (strcmp(action, "read") == 0 || strcmp(action, "rand") == 0)
+    {
+        // 读取和随机读写测试使用已有的测试文件，保留给下一次测试
+        if (ensure_test_file(&params) != ESP_OK)
+        {
+            return 1;
+        }
+        ret = run_repeated(action, &params, repeat, block_size, count, s_bench_args.write->count > 0);
+    }
+    else
+    {
+        printf("Unknown bench action: %s (write, read or rand)\n", action);
+        return 1;
+    }
+    return ret;
+}
+
+static int cmd_mount(int argc, char **argv)
+{
+    if (arg_parse(argc, argv, (void **)&s_mount_args) != 0)
+    {
+        arg_print_errors(stderr, s_mount_args.end, argv[0]);
+        return 1;
+    }
+    sd_mount_params_t params = s_mount_params;
+    if (s_mount_args.freq->count)
+    {
+        params.max_freq_khz = s_mount_args.freq->ival[0];
+    }
+    if (s_mount_args.width->count)
+    {
+        params.width = s_mount_args.width->ival[0];
+        if (params.width != 1 && params.width != 4)
+        {
+            printf("Invalid width: %d (1 or 4)\n", params.width);
+            return 1;
+        }
+    }
+    if (s_mount_args.bus->count)
+    {
+        const char *bus = s_mount_args.bus->sval[0];
+        if (strcmp(bus, "sdmmc") == 0)
+        {
+            params.bus = SD_BUS_SDMMC;
+        }
+        else if (strcmp(bus, "spi") == 0)
+        {
+            params.bus = SD_BUS_SDSPI;
+        }
+        else
+        {
+            printf("Invalid bus: %s (sdmmc or spi)\n", bus);
+            return 1;
+        }
+    }
+
+    if (s_mnt.card != NULL)
+    {
+        sd_unmount(&s_mnt);
+    }
+    if (sd_mount(&params, &s_mnt) != ESP_OK)
+    {
+        printf("Mount failed\n");
+        return 1;
+    }
+    s_mount_params = params;
+    printf("Mounted %s at %s, %d kHz\n", sd_mount_bus_name(&params), MOUNT_POINT, s_mnt.card->max_freq_khz);
+    return 0;
+}
+
+static int cmd_unmount(int argc, char **argv)
+{
+    if (s_mnt.card == NULL)
+    {
+        printf("Card is not mounted\n");
+        return 1;
+    }
+    sd_unmount(&s_mnt);
+    printf("Card unmounted\n");
+    return 0;
+}
+
+static int cmd_wipe(int argc, char **argv)
+{
+    if (arg_parse(argc, argv, (void **)&s_wipe_args) != 0)
+    {
+        arg_print_errors(stderr, s_wipe_args.end, argv[0]);
+        return 1;
+    }
+    if (s_wipe_args.yes->count == 0)
+    {
+        printf("This erases every sector on the card, run 'wipe --yes' to confirm\n");
+        return 1;
+    }
+    if (s_mnt.card == NULL && sd_mount_raw(&s_mount_params, &s_mnt) != ESP_OK)
+    {
+        printf("Card is not available\n");
+        return 1;
+    }
+    if (sd_erase_wipe(&s_mnt) != ESP_OK)
+    {
+        printf("Wipe failed\n");
+        return 1;
+    }
+    printf("Card wiped and mounted at %s\n", MOUNT_POINT);
+    return 0;
+}
+
+static int cmd_stats(int argc, char **argv)
+{
+    if (s_mnt.card != NULL)
+    {
+        printf("Bus: %s, %d kHz\n", sd_mount_bus_name(&s_mnt.params), s_mnt.card->max_freq_khz);
+        sdmmc_card_print_info(stdout, s_mnt.card);
+
+        BYTE pdrv = ff_diskio_get_pdrv_card(s_mnt.card);
+        char drv[3] = {(char)('0' + pdrv), ':', '\0'};
+        FATFS *fs;
+        DWORD free_clusters;
+        if (pdrv != 0xFF && f_getfree(drv, &free_clusters, &fs) == FR_OK)
+        {
+            uint64_t cluster_bytes = (uint64_t)fs->csize * s_mnt.card->csd.sector_size;
+            printf("Filesystem: %llu KB free of %llu KB, cluster %u bytes\n",
+                   (unsigned long long)(free_clusters * cluster_bytes / 1024),
+                   (unsigned long long)((fs->n_fatent - 2) * cluster_bytes / 1024),
+                   (unsigned)cluster_bytes);
+        }
+    }
+    else
+    {
+        printf("Card is not mounted\n");
+    }
+
+    sd_mem_snapshot_t snap;
+    sd_mem_snapshot(&snap);
+    printf("Heap: internal %u free (largest %u), DMA %u free (largest %u), PSRAM %u free\n",
+           (unsigned)snap.internal_free, (unsigned)snap.internal_largest,
+           (unsigned)snap.dma_free, (unsigned)snap.dma_largest, (unsigned)snap.psram_free);
+
+    if (s_last_count > 0)
+    {
+        printf("\n%-8s %8s %5s %8s %8s %8s %8s %8s\n", "test", "buf", "runs", "min", "mean", "max", "stdev", "IOPS");
+        for (int i = 0; i < s_last_count; i++)
+        {
+            const console_last_t *last = &s_last[i];
+            printf("%-8s %8u %5d %8.2f %8.2f %8.2f %8.2f %8.1f\n", last->label, (unsigned)last->buf_size,
+                   last->runs, last->min_mb, last->mean_mb, last->max_mb, last->stdev_mb, last->iops);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 注册所有命令
+ */
+static void register_commands(void)
+{
+    s_bench_args.action = arg_str1(NULL, NULL, "<write|read|rand>", "test to run");
+    s_bench_args.buf = arg_str0(NULL, "buf", "<size>", "buffer size for write/read, e.g. 64k");
+    s_bench_args.size = arg_str0(NULL, "size", "<size>", "test file size, e.g. 16m");
+    s_bench_args.block = arg_str0(NULL, "block", "<size>", "block size for rand (default 4k)");
+    s_bench_args.pattern = arg_str0(NULL, "pattern", "<seq|zero|random>", "data written");
+    s_bench_args.repeat = arg_int0(NULL, "repeat", "<n>", "number of runs");
+    s_bench_args.count = arg_int0(NULL, "count", "<n>", "operations per rand run (default 1000)");
+    s_bench_args.write = arg_lit0(NULL, "write", "rand: overwrite instead of read");
+    s_bench_args.keep = arg_lit0(NULL, "keep", "write: keep the test file for read/rand");
+    s_bench_args.end = arg_end(4);
+    const esp_console_cmd_t bench_cmd = {
+        .command = "bench",
+        .help = "Run a write, read or random I/O benchmark on " MOUNT_POINT,
+        .hint = NULL,
+        .func = &cmd_bench,
+        .argtable = &s_bench_args,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&bench_cmd));
+
+    s_mount_args.freq = arg_int0(NULL, "freq", "<kHz>", "max bus clock");
+    s_mount_args.width = arg_int0(NULL, "width", "<1|4>", "SDMMC bus width");
+    s_mount_args.bus = arg_str0(NULL, "bus", "<sdmmc|spi>", "bus type");
+    s_mount_args.end = arg_end(3);
+    const esp_console_cmd_t mount_cmd = {
+        .command = "mount",
+        .help = "(Re)mount the card; unspecified options keep their previous values",
+        .hint = NULL,
+        .func = &cmd_mount,
+        .argtable = &s_mount_args,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&mount_cmd));
+
+    const esp_console_cmd_t unmount_cmd = {
+        .command = "unmount",
+        .help = "Unmount the card",
+        .hint = NULL,
+        .func = &cmd_unmount,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&unmount_cmd));
+
+    const esp_console_cmd_t stats_cmd = {
+        .command = "stats",
+        .help = "Show card, filesystem and heap state and the latest benchmark results",
+        .hint = NULL,
+        .func = &cmd_stats,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&stats_cmd));
+
+    s_wipe_args.yes = arg_lit0(NULL, "yes", "confirm that all data on the card is erased");
+    s_wipe_args.end = arg_end(1);
+    const esp_console_cmd_t wipe_cmd = {
+        .command = "wipe",
+        .help = "Erase the whole card with erase commands and format it",
+        .hint = NULL,
+        .func = &cmd_wipe,
+        .argtable = &s_wipe_args,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&wipe_cmd));
+}
+
+esp_err_t sd_console_start(const sd_mount_t *mnt)
+{
+    sd_mount_default_params(&s_mount_params);
+    if (mnt != NULL && mnt->card != NULL)
+    {
+        s_mnt = *mnt;
+        s_mount_params = mnt->params;
+    }
+    else if (sd_mount(&s_mount_params, &s_mnt) != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Card is not mounted, use 'mount' to retry");
+    }
+
+    esp_console_repl_config_t repl_config = ESP_CONSOLE_REPL_CONFIG_DEFAULT();
+    repl_config.prompt = "sd>";
+    repl_config.task_stack_size = CONSOLE_STACK_SIZE;
+    esp_console_dev_uart_config_t uart_config = ESP_CONSOLE_DEV_UART_CONFIG_DEFAULT();
+    esp_console_repl_t *repl = NULL;
+    esp_err_t ret = esp_console_new_repl_uart(&uart_config, &repl_config, &repl);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to create console (%s)", esp_err_to_name(ret));
+        return ret;
+    }
+    esp_console_register_help_command();
+    register_commands();
+
+    ESP_LOGI(TAG, "Benchmark console started, type 'help' for commands");
+    return esp_console_start_repl(repl);
+}
@@ -0,0 +1,41 @@
+/*
+ * 运行时测试控制台
+ *
+ * 基于esp_console的REPL（通过UART控制台），在不重新编译、烧录的情况下
+ * 修改缓冲区大小、文件大小、总线宽度和时钟频率并重复测试。支持的命令：
+ *
+ *   bench write [--buf 64k] [--size 16m] [--pattern seq|zero|random] [--repeat 5] [--keep]
+ *   bench read  [--buf 64k] [--size 16m] [--repeat 5]
+ *   bench rand  [--block 4k] [--count 1000] [--size 16m] [--write]
+ *   mount [--freq <kHz>] [--width 1|4] [--bus sdmmc|spi]
+ *   unmount
+ *   stats
+ *   wipe --yes
+ *
+ * 大小参数支持k和m后缀（1024进制）。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include "esp_err.h"
+#include "sd_mount.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 注册命令并在后台任务中启动REPL
+ *
+ * 控制台接管挂载状态：mnt->card不为NULL时控制台直接使用该挂载，
+ * 否则以menuconfig默认参数尝试挂载一次（失败时可以用mount命令重试）。
+ *
+ * @param mnt 当前挂载状态（可为NULL），内容被复制到控制台内部
+ * @return ESP_OK 成功，其他错误码表示REPL创建失败
+ */
+esp_err_t sd_console_start(const sd_mount_t *mnt);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,483 @@
+/*
+ * AES-CTR加密文件层实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <sys/unistd.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+#include "esp_heap_caps.h"
+#include "sd_crypt.h"
+#include "sd_bench.h"
+
+#define CRYPT_MAGIC "SDCRYPT1"
+#define CRYPT_WRITER_STACK_SIZE 4096
+#define CRYPT_BENCH_PATH MOUNT_POINT "/crypt.bin"
+
+static const char *TAG = "sd_crypt";
+
+/**
+ * @brief 流水线中传递的数据块
+ */
+typedef struct
+{
+    uint8_t *buf; // 缓冲区，NULL表示通知写入任务退出
+    size_t len;   // 有效字节数
+} crypt_chunk_t;
+
+/**
+ * @brief 计算密钥校验值：用密钥加密固定明文后取前8字节
+ */
+static void key_check_value(mbedtls_aes_context *aes, uint8_t kcv[8])
+{
+    static const uint8_t plain[16] = "SDCRYPT-KEYCHECK";
+    uint8_t out[16];
+    mbedtls_aes_crypt_ecb(aes, MBEDTLS_AES_ENCRYPT, plain, out);
+    memcpy(kcv, out, 8);
+}
+
+/**
+ * @brief 根据明文偏移设置CTR计数器状态
+ */
+static void ctr_set_offset(sd_crypt_file_t *cf, uint64_t offset)
+{
+    uint64_t block = offset / 16;
+    memcpy(cf->counter, cf->nonce, 8);
+    for (int i = 0; i < 8; i++)
+    {
+        cf->counter[15 - i] = (block >> (i * 8)) & 0xFF;
+    }
+    cf->nc_off = 0;
+    size_t skip = offset % 16;
+    if (skip)
+    {
+        // 偏移不在16字节边界上时，先消耗掉块内前skip字节的密钥流
+        uint8_t dummy[16] = {0};
+        mbedtls_aes_crypt_ctr(&cf->aes, skip, &cf->nc_off, cf->counter, cf->stream_block, dummy, dummy);
+    }
+    cf->offset = offset;
+}
+
+/**
+ * @brief 后台写入任务：把加密好的缓冲区写入文件并归还到空闲队列
+ */
+static void writer_task(void *arg)
+{
+    sd_crypt_file_t *cf = arg;
+    crypt_chunk_t chunk;
+    while (xQueueReceive(cf->full_q, &chunk, portMAX_DELAY) == pdTRUE)
+    {
+        if (chunk.buf == NULL)
+        {
+            break;
+        }
+        if (cf->write_err == ESP_OK)
+        {
+            int64_t start = esp_timer_get_time();
+            if (fwrite(chunk.buf, 1, chunk.len, cf->f) != chunk.len)
+            {
+                ESP_LOGE(TAG, "Write failed (errno: %d)", errno);
+                cf->write_err = ESP_FAIL;
+            }
+            cf->write_us += esp_timer_get_time() - start;
+        }
+        xQueueSend(cf->free_q, &chunk.buf, portMAX_DELAY);
+    }
+    xSemaphoreGive(cf->done);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief 释放写模式下的流水线资源（不关闭文件）
+ */
+static void release_pipeline(sd_crypt_file_t *cf)
+{
+    for (int i = 0; i < SD_CRYPT_MAX_BUFS; i++)
+    {
+        free(cf->bufs[i]);
+        cf->bufs[i] = NULL;
+    }
+    if (cf->free_q)
+    {
+        vQueueDelete(cf->free_q);
+        cf->free_q = NULL;
+    }
+    if (cf->full_q)
+    {
+        vQueueDelete(cf->full_q);
+        cf->full_q = NULL;
+    }
+    if (cf->done)
+    {
+        vSemaphoreDelete(cf->done);
+        cf->done = NULL;
+    }
+}
+
+/**
+ * @brief 提交当前缓冲区
+ *
+ * 流水线模式下交给后台任务并取一个空闲缓冲区（可能阻塞），
+ * 单缓冲模式下直接在当前任务中写卡。
+ */
+static void submit_current(sd_crypt_file_t *cf)
+{
+    if (cf->cur_len == 0)
+    {
+        return;
+    }
+    if (cf->nbufs == 1)
+    {
+        int64_t start = esp_timer_get_time();
+        if (fwrite(cf->cur, 1, cf->cur_len, cf->f) != cf->cur_len)
+        {
+            ESP_LOGE(TAG, "Write failed (errno: %d)", errno);
+            cf->write_err = ESP_FAIL;
+        }
+        int64_t elapsed = esp_timer_get_time() - start;
+        cf->write_us += elapsed;
+        cf->stall_us += elapsed;
+        cf->cur_len = 0;
+        return;
+    }
+
+    crypt_chunk_t chunk = {.buf = cf->cur, .len = cf->cur_len};
+    xQueueSend(cf->full_q, &chunk, portMAX_DELAY);
+    int64_t start = esp_timer_get_time();
+    xQueueReceive(cf->free_q, &cf->cur, portMAX_DELAY);
+    cf->stall_us += esp_timer_get_time() - start;
+    cf->cur_len = 0;
+}
+
+esp_err_t sd_crypt_create(sd_crypt_file_t *cf, const char *path, const uint8_t key[SD_CRYPT_KEY_LEN],
+                          size_t chunk_size, int nbufs)
+{
+    memset(cf, 0, sizeof(*cf));
+    if (chunk_size == 0 || chunk_size % 16 != 0 || nbufs < 1 || nbufs > SD_CRYPT_MAX_BUFS)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    cf->writable = true;
+    cf->chunk_size = chunk_size;
+    cf->nbufs = nbufs;
+    cf->write_err = ESP_OK;
+
+    // 缓冲区使用DMA兼容内存，SD卡驱动可以直接DMA传输
+    for (int i = 0; i < nbufs; i++)
+    {
+        cf->bufs[i] = heap_caps_malloc(chunk_size, MALLOC_CAP_DMA);
+        if (cf->bufs[i] == NULL)
+        {
+            ESP_LOGE(TAG, "Failed to allocate pipeline buffer %d", i);
+            release_pipeline(cf);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    cf->cur = cf->bufs[0];
+
+    mbedtls_aes_init(&cf->aes);
+    mbedtls_aes_setkey_enc(&cf->aes, key, SD_CRYPT_KEY_LEN * 8);
+
+    // 文件头：魔数 + 随机nonce + 密钥校验值
+    uint8_t *header = calloc(1, SD_CRYPT_HEADER_SIZE);
+    if (header == NULL)
+    {
+        mbedtls_aes_free(&cf->aes);
+        release_pipeline(cf);
+        return ESP_ERR_NO_MEM;
+    }
+    esp_fill_random(cf->nonce, sizeof(cf->nonce));
+    memcpy(header, CRYPT_MAGIC, 8);
+    memcpy(header + 8, cf->nonce, 8);
+    key_check_value(&cf->aes, header + 16);
+
+    cf->f = fopen(path, "w");
+    if (cf->f == NULL || fwrite(header, 1, SD_CRYPT_HEADER_SIZE, cf->f) != SD_CRYPT_HEADER_SIZE)
+    {
+        ESP_LOGE(TAG, "Failed to create %s (errno: %d)", path, errno);
+        if (cf->f)
+        {
+            fclose(cf->f);
+            cf->f = NULL;
+        }
+        free(header);
+        mbedtls_aes_free(&cf->aes);
+        release_pipeline(cf);
+        return ESP_FAIL;
+    }
+    free(header);
+    ctr_set_offset(cf, 0);
+
+    if (nbufs > 1)
+    {
+        cf->free_q = xQueueCreate(nbufs, sizeof(uint8_t *));
+        cf->full_q = xQueueCreate(nbufs + 1, sizeof(crypt_chunk_t));
+        cf->done = xSemaphoreCreateBinary();
+        if (cf->free_q == NULL || cf->full_q == NULL || cf->done == NULL)
+        {
+            fclose(cf->f);
+            cf->f = NULL;
+            mbedtls_aes_free(&cf->aes);
+            release_pipeline(cf);
+            return ESP_ERR_NO_MEM;
+        }
+        for (int i = 1; i < nbufs; i++)
+        {
+            xQueueSend(cf->free_q, &cf->bufs[i], 0);
+        }
+        // 写入任务不绑定核心，双核芯片上加密和写卡可以并行
+        if (xTaskCreatePinnedToCore(writer_task, "sd_crypt_wr", CRYPT_WRITER_STACK_SIZE, cf,
+                                    uxTaskPriorityGet(NULL), &cf->writer, tskNO_AFFINITY) != pdPASS)
+        {
+            fclose(cf->f);
+            cf->f = NULL;
+            mbedtls_aes_free(&cf->aes);
+            release_pipeline(cf);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    return ESP_OK;
+}
+
+size_t sd_crypt_write(sd_crypt_file_t *cf, const void *data, size_t len)
+{
+    const uint8_t *src = data;
+    size_t done = 0;
+    while (done < len)
+    {
+        if (cf->write_err != ESP_OK)
+        {
+            return 0;
+        }
+        size_t n = len - done;
+        if (n > cf->chunk_size - cf->cur_len)
+        {
+            n = cf->chunk_size - cf->cur_len;
+        }
+        // 直接把密文写入流水线缓冲区，不需要额外拷贝
+        int64_t start = esp_timer_get_time();
+        mbedtls_aes_crypt_ctr(&cf->aes, n, &cf->nc_off, cf->counter, cf->stream_block,
+                              src + done, cf->cur + cf->cur_len);
+        cf->encrypt_us += esp_timer_get_time() - start;
+
+        cf->cur_len += n;
+        cf->offset += n;
+        done += n;
+        if (cf->cur_len == cf->chunk_size)
+        {
+            submit_current(cf);
+        }
+    }
+    return done;
+}
+
+esp_err_t sd_crypt_open_read(sd_crypt_file_t *cf, const char *path, const uint8_t key[SD_CRYPT_KEY_LEN])
+{
+    memset(cf, 0, sizeof(*cf));
+    cf->f = fopen(path, "r");
+    if (cf->f == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to open %s (errno: %d)", path, errno);
+        return ESP_FAIL;
+    }
+    uint8_t header[24];
+    if (fread(header, 1, sizeof(header), cf->f) != sizeof(header) || memcmp(header, CRYPT_MAGIC, 8) != 0)
+    {
+        fclose(cf->f);
+        cf->f = NULL;
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    mbedtls_aes_init(&cf->aes);
+    mbedtls_aes_setkey_enc(&cf->aes, key, SD_CRYPT_KEY_LEN * 8);
+    uint8_t kcv[8];
+    key_check_value(&cf->aes, kcv);
+    if (memcmp(kcv, header + 16, sizeof(kcv)) != 0)
+    {
+        ESP_LOGE(TAG, "Wrong key for %s", path);
+        mbedtls_aes_free(&cf->aes);
+        fclose(cf->f);
+        cf->f = NULL;
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(cf->nonce, header + 8, sizeof(cf->nonce));
+    return sd_crypt_seek(cf, 0);
+}
+
+esp_err_t sd_crypt_seek(sd_crypt_file_t *cf, uint64_t offset)
+{
+    if (cf->writable)
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (fseek(cf->f, SD_CRYPT_HEADER_SIZE + offset, SEEK_SET) != 0)
+    {
+        return ESP_FAIL;
+    }
+    ctr_set_offset(cf, offset);
+    return ESP_OK;
+}
+
+size_t sd_crypt_read(sd_crypt_file_t *cf, void *data, size_t len)
+{
+    size_t n = fread(data, 1, len, cf->f);
+    // CTR模式解密与加密相同，可以原地进行
+    int64_t start = esp_timer_get_time();
+    mbedtls_aes_crypt_ctr(&cf->aes, n, &cf->nc_off, cf->counter, cf->stream_block, data, data);
+    cf->encrypt_us += esp_timer_get_time() - start;
+    cf->offset += n;
+    return n;
+}
+
+esp_err_t sd_crypt_close(sd_crypt_file_t *cf)
+{
+    esp_err_t ret = ESP_OK;
+    if (cf->writable)
+    {
+        submit_current(cf);
+        if (cf->nbufs > 1)
+        {
+            // 通知写入任务退出并等待剩余数据写完
+            crypt_chunk_t stop = {.buf = NULL, .len = 0};
+            xQueueSend(cf->full_q, &stop, portMAX_DELAY);
+            xSemaphoreTake(cf->done, portMAX_DELAY);
+            cf->writer = NULL;
+        }
+        ret = cf->write_err;
+        fflush(cf->f);
+        fsync(fileno(cf->f));
+        release_pipeline(cf);
+    }
+    if (fclose(cf->f) != 0 && ret == ESP_OK)
+    {
+        ret = ESP_FAIL;
+    }
+    cf->f = NULL;
+    mbedtls_aes_free(&cf->aes);
+    return ret;
+}
+
+/**
+ * @brief 加密写入测试
+ *
+ * @param cpu_pct   输出：加密耗时占总耗时的百分比
+ * @param stall_pct 输出：调用者等待SD卡写入的时间占总耗时的百分比
+ */
+static esp_err_t bench_encrypted_write(const uint8_t *plain, size_t chunk_size, size_t file_size, int nbufs,
+                                       const uint8_t key[SD_CRYPT_KEY_LEN], sd_bench_result_t *result,
+                                       float *cpu_pct, float *stall_pct)
+{
+    memset(result, 0, sizeof(*result));
+    sd_crypt_file_t cf;
+    int64_t start_time = esp_timer_get_time();
+    esp_err_t ret = sd_crypt_create(&cf, CRYPT_BENCH_PATH, key, chunk_size, nbufs);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    size_t written = 0;
+    while (written < file_size)
+    {
+        size_t n = file_size - written;
+        if (n > chunk_size)
+        {
+            n = chunk_size;
+        }
+        if (sd_crypt_write(&cf, plain, n) != n)
+        {
+            ret = ESP_FAIL;
+            break;
+        }
+        written += n;
+    }
+    int64_t encrypt_us = cf.encrypt_us;
+    int64_t stall_us = cf.stall_us;
+    if (sd_crypt_close(&cf) != ESP_OK)
+    {
+        ret = ESP_FAIL;
+    }
+    int64_t elapsed = esp_timer_get_time() - start_time;
+
+    result->bytes = written;
+    result->seconds = elapsed / 1000000.0;
+    result->speed_mb = (written / (1024.0 * 1024.0)) / result->seconds;
+    result->valid = (ret == ESP_OK);
+    *cpu_pct = elapsed > 0 ? encrypt_us * 100.0 / elapsed : 0;
+    *stall_pct = elapsed > 0 ? stall_us * 100.0 / elapsed : 0;
+    return ret;
+}
+
+void sd_crypt_bench_run(size_t chunk_size, size_t file_size)
+{
+    ESP_LOGI(TAG, "Benchmarking AES-256-CTR encrypted writes");
+
+    uint8_t key[SD_CRYPT_KEY_LEN];
+    esp_fill_random(key, sizeof(key));
+
+    uint8_t *plain = heap_caps_malloc(chunk_size, MALLOC_CAP_DMA);
+    if (plain == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate buffer");
+        return;
+    }
+    for (size_t i = 0; i < chunk_size; i++)
+    {
+        plain[i] = i & 0xFF;
+    }
+
+    // 明文写入作为基准
+    sd_bench_params_t params = SD_BENCH_PARAMS_DEFAULT();
+    params.path = CRYPT_BENCH_PATH;
+    params.buf_size = chunk_size;
+    params.file_size = file_size;
+    sd_bench_result_t plain_result;
+    sd_bench_write(&params, &plain_result);
+    unlink(CRYPT_BENCH_PATH);
+
+    sd_bench_result_t serial_result;
+    sd_bench_result_t pipe_result;
+    float serial_cpu = 0, serial_stall = 0, pipe_cpu = 0, pipe_stall = 0;
+    bench_encrypted_write(plain, chunk_size, file_size, 1, key, &serial_result, &serial_cpu, &serial_stall);
+    unlink(CRYPT_BENCH_PATH);
+    bench_encrypted_write(plain, chunk_size, file_size, 2, key, &pipe_result, &pipe_cpu, &pipe_stall);
+
+    // 读回第一块校验解密结果
+    bool verified = false;
+    uint8_t *check = heap_caps_malloc(chunk_size, MALLOC_CAP_DMA);
+    sd_crypt_file_t cf;
+    if (check && pipe_result.valid && sd_crypt_open_read(&cf, CRYPT_BENCH_PATH, key) == ESP_OK)
+    {
+        size_t n = file_size < chunk_size ? file_size : chunk_size;
+        verified = sd_crypt_read(&cf, check, n) == n && memcmp(check, plain, n) == 0;
+        sd_crypt_close(&cf);
+    }
+    free(check);
+    unlink(CRYPT_BENCH_PATH);
+
+    // 纯内存AES-CTR速度
+    mbedtls_aes_context aes;
+    mbedtls_aes_init(&aes);
+    mbedtls_aes_setkey_enc(&aes, key, SD_CRYPT_KEY_LEN * 8);
+    uint8_t counter[16] = {0};
+    uint8_t stream[16];
+    size_t nc_off = 0;
+    int64_t start = esp_timer_get_time();
+    for (size_t done = 0; done < file_size; done += chunk_size)
+    {
+        mbedtls_aes_crypt_ctr(&aes, chunk_size, &nc_off, counter, stream, plain, plain);
+    }
+    float aes_mb = (file_size / (1024.0 * 1024.0)) / ((esp_timer_get_time() - start) / 1000000.0);
+    mbedtls_aes_free(&aes);
+    free(plain);
+
+    printf("\nAES-256-CTR encrypted writes (%u bytes, %u-byte chunks):\n", (unsigned)file_size, (unsigned)chunk_size);
+    printf("  %-22s %10s %10s %12s\n", "mode", "MB/s", "AES CPU%", "wait SD %");
+    printf("  %-22s %10.2f %10s %12s\n", "plaintext", plain_result.speed_mb, "-", "-");
+    printf("  %-22s %10.2f %10.1f %12.1f\n", "encrypted, serial", serial_result.speed_mb, serial_cpu, serial_stall);
+    printf("  %-22s %10.2f %10.1f %12.1f\n", "encrypted, pipelined", pipe_result.speed_mb, pipe_cpu, pipe_stall);
+    printf("  AES-CTR in RAM: %.2f MB/s, read-back %s\n\n", aes_mb, verified ? "decrypts correctly" : "FAILED");
+}
@@ -0,0 +1,130 @@
+/*
+ * AES-CTR加密文件层
+ *
+ * 写入时使用AES-256-CTR加密数据，ESP32-S3上由mbedTLS调用AES硬件加速器
+ * （CONFIG_MBEDTLS_HARDWARE_AES，大块数据通过DMA传输），未启用时自动使用软件AES。
+ *
+ * 写入路径是流水线式的：调用者所在任务加密第N+1块的同时，
+ * 后台写入任务把第N块写入SD卡。
+ *
+ * 文件格式：
+ * - 前512字节为文件头：魔数、8字节随机nonce、8字节密钥校验值，其余为0
+ * - 之后为密文，与明文一一对应。第k个16字节块的计数器为 nonce || 大端序k，
+ *   因此可以从任意偏移开始解密
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "mbedtls/aes.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SD_CRYPT_KEY_LEN 32     // AES-256密钥长度
+#define SD_CRYPT_HEADER_SIZE 512 // 文件头大小，保证密文按扇区对齐
+#define SD_CRYPT_MAX_BUFS 4      // 流水线缓冲区数量上限
+
+/**
+ * @brief 加密文件句柄
+ */
+typedef struct
+{
+    FILE *f;                  // 底层文件
+    mbedtls_aes_context aes;  // AES上下文
+    uint8_t nonce[8];         // 文件nonce
+    uint8_t counter[16];      // 当前CTR计数器块
+    uint8_t stream_block[16]; // 当前密钥流块
+    size_t nc_off;            // 当前密钥流块中已使用的字节数
+    uint64_t offset;          // 当前明文偏移
+    bool writable;            // 是否为写模式
+
+    // 以下仅用于写模式的流水线
+    size_t chunk_size;                 // 每个流水线缓冲区的大小
+    int nbufs;                         // 流水线缓冲区数量
+    uint8_t *bufs[SD_CRYPT_MAX_BUFS];  // 流水线缓冲区
+    uint8_t *cur;                      // 当前正在填充的缓冲区
+    size_t cur_len;                    // 当前缓冲区已填充的字节数
+    QueueHandle_t free_q;              // 空闲缓冲区队列
+    QueueHandle_t full_q;              // 待写入缓冲区队列
+    SemaphoreHandle_t done;            // 写入任务退出信号
+    TaskHandle_t writer;               // 后台写入任务
+    volatile esp_err_t write_err;      // 后台写入任务遇到的错误
+
+    // 统计信息
+    int64_t encrypt_us; // 加密累计耗时（调用者任务）
+    int64_t stall_us;   // 等待空闲缓冲区累计耗时（即等待SD卡写入）
+    int64_t write_us;   // 后台任务写卡累计耗时
+} sd_crypt_file_t;
+
+/**
+ * @brief 创建加密文件并启动后台写入任务
+ *
+ * @param cf         句柄
+ * @param path       文件路径
+ * @param key        32字节AES-256密钥
+ * @param chunk_size 流水线缓冲区大小（16的倍数，建议为扇区大小的整数倍）
+ * @param nbufs      流水线缓冲区数量（2~SD_CRYPT_MAX_BUFS，1表示不流水）
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数错误，ESP_ERR_NO_MEM 内存不足，ESP_FAIL 文件操作失败
+ */
+esp_err_t sd_crypt_create(sd_crypt_file_t *cf, const char *path, const uint8_t key[SD_CRYPT_KEY_LEN],
+                          size_t chunk_size, int nbufs);
+
+/**
+ * @brief 加密并写入数据
+ *
+ * 数据直接加密到流水线缓冲区，缓冲区满后交给后台任务写卡。
+ * 所有缓冲区都在写卡时会阻塞等待。
+ *
+ * @return 接受的字节数；后台写入出错时返回0
+ */
+size_t sd_crypt_write(sd_crypt_file_t *cf, const void *data, size_t len);
+
+/**
+ * @brief 打开加密文件用于读取，并校验密钥
+ *
+ * @return ESP_OK 成功，ESP_ERR_INVALID_VERSION 文件头无效，ESP_ERR_INVALID_ARG 密钥错误，ESP_FAIL 文件操作失败
+ */
+esp_err_t sd_crypt_open_read(sd_crypt_file_t *cf, const char *path, const uint8_t key[SD_CRYPT_KEY_LEN]);
+
+/**
+ * @brief 读取并解密数据
+ *
+ * @return 实际读取的字节数
+ */
+size_t sd_crypt_read(sd_crypt_file_t *cf, void *data, size_t len);
+
+/**
+ * @brief 移动读取位置（明文偏移）
+ */
+esp_err_t sd_crypt_seek(sd_crypt_file_t *cf, uint64_t offset);
+
+/**
+ * @brief 关闭文件。写模式下会写出剩余数据、停止后台任务并同步到卡上
+ *
+ * @return ESP_OK 成功，其他错误码表示写入过程中出错
+ */
+esp_err_t sd_crypt_close(sd_crypt_file_t *cf);
+
+/**
+ * @brief 对比明文写入、加密写入（不流水）和加密写入（流水线）的吞吐量与CPU开销
+ *
+ * 需要SD卡已挂载，测试结束后删除测试文件。
+ *
+ * @param chunk_size 流水线缓冲区大小
+ * @param file_size  测试文件大小
+ */
+void sd_crypt_bench_run(size_t chunk_size, size_t file_size);
+
+#ifdef __cplusplus
+}
+#endif
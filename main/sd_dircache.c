@@ -0,0 +1,596 @@
+/*
+ * 目录路径解析缓存实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/unistd.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "ff.h"
+#include "diskio_impl.h"
+#include "diskio_sdmmc.h"
+#include "sd_dircache.h"
+#include "sd_prealloc.h"
+#include "sd_mount.h"
+
+#define DIRCACHE_SECTOR_SIZE 512 // SD卡扇区大小
+#define DIRCACHE_BENCH_DEPTH 4   // 测试的最大目录深度（YYYY/MM/DD/HH）
+#define DIRCACHE_BENCH_OPENS 50  // 每种深度测试的打开次数
+#define DIRCACHE_BENCH_FILE "DCACHE.BIN"
+
+static const char *TAG = "sd_dircache";
+
+/**
+ * @brief 路径前缀表的一项
+ */
+typedef struct
+{
+    char path[SD_DIRCACHE_PATH_MAX]; // VFS路径前缀，例如"/sdcard/2024/05"
+    LBA_t first;                     // 目录第一个簇的起始扇区
+    DWORD count;                     // 目录第一个簇的扇区数
+    uint32_t last_use;               // 最近一次使用的时钟值
+    bool valid;
+} prefix_t;
+
+/**
+ * @brief 目录扇区缓存的一项，数据在s_data中
+ */
+typedef struct
+{
+    LBA_t sector;
+    uint32_t last_use;
+    bool valid;
+} sector_t;
+
+static sdmmc_card_t *s_card;         // 已挂接的SD卡，NULL表示未挂接
+static BYTE s_pdrv;                  // 主卷的物理驱动器号
+static FATFS *s_fs;                  // 主卷的文件系统对象
+static SemaphoreHandle_t s_lock;     // 保护前缀表和扇区缓存
+static prefix_t s_prefixes[SD_DIRCACHE_PREFIXES];
+static sector_t s_sectors[SD_DIRCACHE_SECTORS];
+static uint8_t *s_data;              // 扇区数据，SD_DIRCACHE_SECTORS * DIRCACHE_SECTOR_SIZE字节
+static LBA_t s_root_first;           // 根目录的扇区范围（根目录总是缓存）
+static DWORD s_root_count;
+static uint32_t s_clock;
+static sd_dircache_stats_t s_stats;
+
+/**
+ * @brief 计算簇cluster的扇区范围
+ */
+static void cluster_range(DWORD cluster, LBA_t *first, DWORD *count)
+{
+    *first = s_fs->database + (LBA_t)(cluster - 2) * s_fs->csize;
+    *count = s_fs->csize;
+}
+
+/**
+ * @brief 扇区是否属于根目录或前缀表中的目录（调用者持有s_lock）
+ */
+static bool cacheable(LBA_t sector)
+{
+    if (sector >= s_root_first && sector < s_root_first + s_root_count)
+    {
+        return true;
+    }
+    for (int i = 0; i < SD_DIRCACHE_PREFIXES; i++)
+    {
+        const prefix_t *p = &s_prefixes[i];
+        if (p->valid && sector >= p->first && sector < p->first + p->count)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int find_sector(LBA_t sector)
+{
+    for (int i = 0; i < SD_DIRCACHE_SECTORS; i++)
+    {
+        if (s_sectors[i].valid && s_sectors[i].sector == sector)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static DSTATUS diskio_init(BYTE pdrv)
+{
+    return s_card ? 0 : STA_NOINIT;
+}
+
+static DSTATUS diskio_status(BYTE pdrv)
+{
+    return s_card ? 0 : STA_NOINIT;
+}
+
+static DRESULT diskio_read(BYTE pdrv, BYTE *buff, uint32_t sector, UINT count)
+{
+    // FatFs查找目录时通过窗口逐个扇区读取，多扇区读取都是文件数据
+    bool cache = false;
+    if (count == 1)
+    {
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        if (cacheable(sector))
+        {
+            int i = find_sector(sector);
+            if (i >= 0)
+            {
+                memcpy(buff, s_data + i * DIRCACHE_SECTOR_SIZE, DIRCACHE_SECTOR_SIZE);
+                s_sectors[i].last_use = ++s_clock;
+                s_stats.sector_hits++;
+                xSemaphoreGive(s_lock);
+                return RES_OK;
+            }
+            s_stats.sector_misses++;
+            cache = true;
+        }
+        xSemaphoreGive(s_lock);
+    }
+
+    esp_err_t ret = sdmmc_read_sectors(s_card, buff, sector, count);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "sdmmc_read_sectors failed (%s)", esp_err_to_name(ret));
+        return RES_ERROR;
+    }
+    if (cache)
+    {
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        int victim = 0;
+        for (int i = 0; i < SD_DIRCACHE_SECTORS; i++)
+        {
+            if (!s_sectors[i].valid)
+            {
+                victim = i;
+                break;
+            }
+            if (s_sectors[i].last_use < s_sectors[victim].last_use)
+            {
+                victim = i;
+            }
+        }
+        memcpy(s_data + victim * DIRCACHE_SECTOR_SIZE, buff, DIRCACHE_SECTOR_SIZE);
+        s_sectors[victim].sector = sector;
+        s_sectors[victim].last_use = ++s_clock;
+        s_sectors[victim].valid = true;
+        xSemaphoreGive(s_lock);
+    }
+    return RES_OK;
+}
+
+static DRESULT diskio_write(BYTE pdrv, const BYTE *buff, uint32_t sector, UINT count)
+{
+    esp_err_t ret = sdmmc_write_sectors(s_card, buff, sector, count);
+
+    // 写透：缓存中被覆盖的扇区同步更新，写入失败时卡上内容不确定，直接丢弃
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    for (int i = 0; i < SD_DIRCACHE_SECTORS; i++)
+    {
+        sector_t *s = &s_sectors[i];
+        if (s->valid && s->sector >= sector && s->sector < sector + count)
+        {
+            if (ret == ESP_OK)
+            {
+                memcpy(s_data + i * DIRCACHE_SECTOR_SIZE, buff + (s->sector - sector) * DIRCACHE_SECTOR_SIZE,
+                       DIRCACHE_SECTOR_SIZE);
+            }
+            else
+            {
+                s->valid = false;
+            }
+        }
+    }
+    xSemaphoreGive(s_lock);
+
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "sdmmc_write_sectors failed (%s)", esp_err_to_name(ret));
+        return RES_ERROR;
+    }
+    return RES_OK;
+}
+
+static DRESULT diskio_ioctl(BYTE pdrv, BYTE cmd, void *buff)
+{
+    switch (cmd)
+    {
+    case CTRL_SYNC:
+        // sdmmc_write_sectors返回前已等待卡编程完成
+        return RES_OK;
+    case GET_SECTOR_COUNT:
+        *((DWORD *)buff) = s_card->csd.capacity;
+        return RES_OK;
+    case GET_SECTOR_SIZE:
+        *((WORD *)buff) = s_card->csd.sector_size;
+        return RES_OK;
+    case GET_BLOCK_SIZE:
+        return RES_ERROR;
+    }
+    return RES_ERROR;
+}
+
+static const ff_diskio_impl_t s_impl = {
+    .init = &diskio_init,
+    .status = &diskio_status,
+    .read = &diskio_read,
+    .write = &diskio_write,
+    .ioctl = &diskio_ioctl,
+};
+
+esp_err_t sd_dircache_attach(sdmmc_card_t *card)
+{
+    if (s_card != NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    BYTE pdrv = ff_diskio_get_pdrv_card(card);
+    if (pdrv == 0xFF)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    char root[8];
+    snprintf(root, sizeof(root), "%d:/", pdrv);
+    DIR dir;
+    if (f_opendir(&dir, root) != FR_OK)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    s_fs = dir.obj.fs;
+    f_closedir(&dir);
+
+    if (s_lock == NULL)
+    {
+        s_lock = xSemaphoreCreateMutex();
+        if (s_lock == NULL)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    s_data = malloc(SD_DIRCACHE_SECTORS * DIRCACHE_SECTOR_SIZE);
+    if (s_data == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    memset(s_prefixes, 0, sizeof(s_prefixes));
+    memset(s_sectors, 0, sizeof(s_sectors));
+    memset(&s_stats, 0, sizeof(s_stats));
+
+    // FAT32的根目录是普通的簇链，FAT12/16的根目录在数据区之前的固定区域
+    if (s_fs->fs_type == FS_FAT32)
+    {
+        cluster_range(s_fs->dirbase, &s_root_first, &s_root_count);
+    }
+    else
+    {
+        s_root_first = s_fs->dirbase;
+        s_root_count = s_fs->n_rootdir * 32 / DIRCACHE_SECTOR_SIZE;
+    }
+
+    s_pdrv = pdrv;
+    s_card = card;
+    ff_diskio_register(pdrv, &s_impl);
+    ESP_LOGI(TAG, "Attached to drive %d (%u KB sector cache)", pdrv,
+             SD_DIRCACHE_SECTORS * DIRCACHE_SECTOR_SIZE / 1024);
+    return ESP_OK;
+}
+
+void sd_dircache_detach(void)
+{
+    if (s_card == NULL)
+    {
+        return;
+    }
+    ff_diskio_register_sdmmc(s_pdrv, s_card);
+    s_card = NULL;
+    free(s_data);
+    s_data = NULL;
+}
+
+/**
+ * @brief 确保目录前缀在前缀表中
+ *
+ * @return ESP_OK 前缀已在表中或已加入，ESP_ERR_NOT_FOUND 目录不存在
+ */
+static esp_err_t learn(const char *prefix)
+{
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    for (int i = 0; i < SD_DIRCACHE_PREFIXES; i++)
+    {
+        if (s_prefixes[i].valid && strcmp(s_prefixes[i].path, prefix) == 0)
+        {
+            s_prefixes[i].last_use = ++s_clock;
+            s_stats.prefix_hits++;
+            xSemaphoreGive(s_lock);
+            return ESP_OK;
+        }
+    }
+    xSemaphoreGive(s_lock);
+
+    // 查找目录会经过本层的磁盘驱动，不能持有s_lock
+    char fat_path[SD_DIRCACHE_PATH_MAX];
+    if (sd_prealloc_fat_path(s_card, prefix, fat_path, sizeof(fat_path)) != ESP_OK)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    DIR dir;
+    if (f_opendir(&dir, fat_path) != FR_OK)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    DWORD cluster = dir.obj.sclust;
+    f_closedir(&dir);
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    int victim = 0;
+    for (int i = 0; i < SD_DIRCACHE_PREFIXES; i++)
+    {
+        if (!s_prefixes[i].valid)
+        {
+            victim = i;
+            break;
+        }
+        if (s_prefixes[i].last_use < s_prefixes[victim].last_use)
+        {
+            victim = i;
+        }
+    }
+    prefix_t *p = &s_prefixes[victim];
+    strlcpy(p->path, prefix, sizeof(p->path));
+    cluster_range(cluster, &p->first, &p->count);
+    p->last_use = ++s_clock;
+    p->valid = true;
+    s_stats.prefix_misses++;
+    xSemaphoreGive(s_lock);
+    return ESP_OK;
+}
+
+FILE *sd_dircache_fopen(const char *path, const char *mode)
+{
+    size_t root = strlen(MOUNT_POINT);
+    if (s_card != NULL && strncmp(path, MOUNT_POINT "/", root + 1) == 0)
+    {
+        // 依次加入"/sdcard/YYYY"、"/sdcard/YYYY/MM"……，遇到不存在的目录时停止
+        char prefix[SD_DIRCACHE_PATH_MAX];
+        for (const char *p = strchr(path + root + 1, '/'); p != NULL; p = strchr(p + 1, '/'))
+        {
+            size_t len = p - path;
+            if (len >= sizeof(prefix))
+            {
+                break;
+            }
+            memcpy(prefix, path, len);
+            prefix[len] = '\0';
+            if (learn(prefix) != ESP_OK)
+            {
+                break;
+            }
+        }
+    }
+    return fopen(path, mode);
+}
+
+void sd_dircache_invalidate(const char *path)
+{
+    if (s_card == NULL)
+    {
+        return;
+    }
+    size_t len = strlen(path);
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    for (int i = 0; i < SD_DIRCACHE_PREFIXES; i++)
+    {
+        prefix_t *p = &s_prefixes[i];
+        if (p->valid && strncmp(p->path, path, len) == 0 && (p->path[len] == '\0' || p->path[len] == '/'))
+        {
+            // 扇区缓存中的数据仍与卡一致，不再属于任何前缀后不会命中，由LRU淘汰
+            p->valid = false;
+            s_stats.invalidations++;
+        }
+    }
+    xSemaphoreGive(s_lock);
+}
+
+int sd_dircache_rename(const char *from, const char *to)
+{
+    int ret = rename(from, to);
+    if (ret == 0)
+    {
+        sd_dircache_invalidate(from);
+    }
+    return ret;
+}
+
+int sd_dircache_rmdir(const char *path)
+{
+    int ret = rmdir(path);
+    if (ret == 0)
+    {
+        sd_dircache_invalidate(path);
+    }
+    return ret;
+}
+
+void sd_dircache_take_stats(sd_dircache_stats_t *stats)
+{
+    if (s_lock == NULL)
+    {
+        if (stats)
+        {
+            memset(stats, 0, sizeof(*stats));
+        }
+        return;
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    if (stats)
+    {
+        *stats = s_stats;
+    }
+    memset(&s_stats, 0, sizeof(s_stats));
+    xSemaphoreGive(s_lock);
+}
+
+// 测试使用的目录层次，对应YYYY/MM/DD/HH
+static const char *const s_bench_dirs[DIRCACHE_BENCH_DEPTH] = {"2024", "05", "17", "09"};
+
+/**
+ * @brief 生成top下深度为depth的目录路径（depth为0时是MOUNT_POINT）
+ */
+static void bench_dir(char *out, size_t size, const char *top, int depth)
+{
+    int n = snprintf(out, size, "%s", MOUNT_POINT);
+    for (int i = 0; i < depth; i++)
+    {
+        n += snprintf(out + n, size - n, "/%s", i == 0 ? top : s_bench_dirs[i]);
+    }
+}
+
+/**
+ * @brief 生成top下深度为depth的目录中测试文件的路径
+ */
+static void bench_file(char *out, size_t size, const char *top, int depth)
+{
+    bench_dir(out, size, top, depth);
+    size_t len = strlen(out);
+    snprintf(out + len, size - len, "/%s", DIRCACHE_BENCH_FILE);
+}
+
+/**
+ * @brief 删除top下的测试文件和目录（忽略不存在的项）
+ */
+static void bench_remove(const char *top, bool cached)
+{
+    char path[SD_DIRCACHE_PATH_MAX];
+    for (int depth = DIRCACHE_BENCH_DEPTH; depth >= 0; depth--)
+    {
+        bench_dir(path, sizeof(path), top, depth);
+        size_t len = strlen(path);
+        snprintf(path + len, sizeof(path) - len, "/%s", DIRCACHE_BENCH_FILE);
+        unlink(path);
+        path[len] = '\0';
+        if (depth > 0 && cached)
+        {
+            sd_dircache_rmdir(path);
+        }
+        else if (depth > 0)
+        {
+            rmdir(path);
+        }
+    }
+}
+
+/**
+ * @brief 打开并关闭path若干次，返回平均耗时（微秒），失败时返回-1
+ */
+static int64_t bench_opens(const char *path, int count)
+{
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < count; i++)
+    {
+        FILE *f = sd_dircache_fopen(path, "r");
+        if (f == NULL)
+        {
+            return -1;
+        }
+        fclose(f);
+    }
+    return (esp_timer_get_time() - start) / count;
+}
+
+void sd_dircache_bench_run(sdmmc_card_t *card)
+{
+    const char *top = s_bench_dirs[0];
+    const char *renamed = "2025";
+    char path[SD_DIRCACHE_PATH_MAX];
+    bench_remove(top, false);
+    bench_remove(renamed, false);
+
+    // 每一级目录中放一个测试文件
+    for (int depth = 0; depth <= DIRCACHE_BENCH_DEPTH; depth++)
+    {
+        bench_dir(path, sizeof(path), top, depth);
+        if (depth > 0 && mkdir(path, 0777) != 0 && errno != EEXIST)
+        {
+            ESP_LOGE(TAG, "Failed to create %s (errno %d)", path, errno);
+            bench_remove(top, false);
+            return;
+        }
+        size_t len = strlen(path);
+        snprintf(path + len, sizeof(path) - len, "/%s", DIRCACHE_BENCH_FILE);
+        FILE *f = fopen(path, "w");
+        if (f == NULL)
+        {
+            ESP_LOGE(TAG, "Failed to create %s", path);
+            bench_remove(top, false);
+            return;
+        }
+        fputs("dircache\n", f);
+        fclose(f);
+    }
+
+    printf("\nOpen latency vs directory depth (%d opens each):\n", DIRCACHE_BENCH_OPENS);
+    printf("  %-6s %10s %14s %13s %12s\n", "depth", "plain ms", "cached 1st ms", "cached ms", "sector hits");
+    for (int depth = 0; depth <= DIRCACHE_BENCH_DEPTH; depth++)
+    {
+        bench_file(path, sizeof(path), top, depth);
+        int64_t plain = bench_opens(path, DIRCACHE_BENCH_OPENS);
+        int64_t first = -1;
+        int64_t cached = -1;
+        sd_dircache_stats_t stats = {0};
+        if (sd_dircache_attach(card) == ESP_OK)
+        {
+            first = bench_opens(path, 1);
+            sd_dircache_take_stats(NULL);
+            cached = bench_opens(path, DIRCACHE_BENCH_OPENS);
+            sd_dircache_take_stats(&stats);
+            sd_dircache_detach();
+        }
+        printf("  %-6d %10.2f %14.2f %13.2f %12u\n", depth, plain / 1000.0, first / 1000.0, cached / 1000.0,
+               (unsigned)stats.sector_hits);
+    }
+
+    // 重命名顶层目录后旧前缀必须失效，新路径能正常打开
+    if (sd_dircache_attach(card) == ESP_OK)
+    {
+        bench_file(path, sizeof(path), top, DIRCACHE_BENCH_DEPTH);
+        FILE *f = sd_dircache_fopen(path, "r");
+        if (f != NULL)
+        {
+            fclose(f);
+        }
+        char from[SD_DIRCACHE_PATH_MAX];
+        char to[SD_DIRCACHE_PATH_MAX];
+        bench_dir(from, sizeof(from), top, 1);
+        bench_dir(to, sizeof(to), renamed, 1);
+        bool ok = sd_dircache_rename(from, to) == 0;
+        if (ok)
+        {
+            bench_file(path, sizeof(path), renamed, DIRCACHE_BENCH_DEPTH);
+            f = sd_dircache_fopen(path, "r");
+            ok = f != NULL;
+            if (f != NULL)
+            {
+                fclose(f);
+            }
+            top = renamed;
+        }
+        bench_remove(top, true);
+        sd_dircache_stats_t stats;
+        sd_dircache_take_stats(&stats);
+        sd_dircache_detach();
+        printf("  rename/rmdir: %s, %u prefixes invalidated\n", ok ? "ok" : "failed", (unsigned)stats.invalidations);
+    }
+    else
+    {
+        bench_remove(top, false);
+    }
+    printf("\n");
+}
@@ -0,0 +1,98 @@
+/*
+ * 目录路径解析缓存
+ *
+ * FatFs打开文件时从根目录逐级查找路径中的每个目录，每一级至少读一个目录扇区，
+ * 目录层次为/sdcard/YYYY/MM/DD/HH/file时每次fopen要读五个以上的扇区。
+ * ESP-IDF v4.4的FatFs编译时关闭了FF_FS_RPATH，无法从中间目录开始查找，因此缓存分两层：
+ * - 路径前缀表：目录路径前缀 -> 目录的起始簇（及其第一个簇所在的扇区范围），LRU淘汰
+ * - 目录扇区缓存：挂在主卷的磁盘驱动上，前缀表中目录的扇区读过一次后留在内存中，
+ *   之后逐级查找时直接从内存返回；所有写入都经过这一层，缓存内容始终与卡一致
+ *
+ * 重命名或删除目录后前缀对应的簇不再有效，需要通过sd_dircache_rename/sd_dircache_rmdir
+ * 操作，或调用sd_dircache_invalidate使该前缀及其下所有前缀失效。
+ *
+ * 注意：
+ * - 挂接和卸下时会替换主卷的磁盘驱动，此时不能有其他任务在访问该卷
+ * - 只缓存每个目录第一个簇中的扇区
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdmmc_cmd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SD_DIRCACHE_PREFIXES 16 // 路径前缀表的容量
+#define SD_DIRCACHE_SECTORS 32  // 目录扇区缓存的容量（每个扇区512字节）
+#define SD_DIRCACHE_PATH_MAX 64 // 前缀的最大长度（含MOUNT_POINT）
+
+/**
+ * @brief 缓存统计信息
+ */
+typedef struct
+{
+    uint32_t prefix_hits;   // 在前缀表中找到的目录前缀数
+    uint32_t prefix_misses; // 需要查找并加入前缀表的目录前缀数
+    uint32_t sector_hits;   // 从缓存返回的目录扇区读取数
+    uint32_t sector_misses; // 属于缓存目录但需要读卡的扇区读取数
+    uint32_t invalidations; // 因重命名或删除而失效的前缀数
+} sd_dircache_stats_t;
+
+/**
+ * @brief 在主卷上挂接目录缓存
+ *
+ * @param card 已通过sd_mount挂载的SD卡
+ * @return ESP_OK 成功，ESP_ERR_NOT_FOUND 卡未挂载到FATFS，ESP_ERR_NO_MEM 内存不足，ESP_ERR_INVALID_STATE 已挂接
+ */
+esp_err_t sd_dircache_attach(sdmmc_card_t *card);
+
+/**
+ * @brief 卸下目录缓存，恢复ESP-IDF的SD卡磁盘驱动
+ */
+void sd_dircache_detach(void);
+
+/**
+ * @brief 与fopen相同，打开前把路径中的各级目录加入前缀表
+ *
+ * 未挂接时等同于fopen。
+ */
+FILE *sd_dircache_fopen(const char *path, const char *mode);
+
+/**
+ * @brief 与rename相同，成功后使from及其下的前缀失效
+ */
+int sd_dircache_rename(const char *from, const char *to);
+
+/**
+ * @brief 与rmdir相同，成功后使path及其下的前缀失效
+ */
+int sd_dircache_rmdir(const char *path);
+
+/**
+ * @brief 使目录path及其下所有前缀失效
+ */
+void sd_dircache_invalidate(const char *path);
+
+/**
+ * @brief 读取并清零统计信息
+ *
+ * @param stats 输出的统计信息（可为NULL，仅清零）
+ */
+void sd_dircache_take_stats(sd_dircache_stats_t *stats);
+
+/**
+ * @brief 在深度0~5的目录层次中测试打开已有文件的延迟，对比有无目录缓存
+ *
+ * @param card 已通过sd_mount挂载的SD卡
+ */
+void sd_dircache_bench_run(sdmmc_card_t *card);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,171 @@
+/*
+ * 带总线统计的FATFS磁盘驱动实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "diskio_impl.h"
+#include "sd_diskio.h"
+
+static const char *TAG = "sd_diskio";
+
+static sdmmc_card_t *s_cards[FF_VOLUMES];  // 各物理驱动器对应的SD卡
+static SemaphoreHandle_t s_bus_lock;       // SD卡级别的总线锁（示例中只有一张卡）
+static portMUX_TYPE s_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static sd_diskio_stats_t s_stats;
+
+/**
+ * @brief 获取总线锁，并记录是否需要等待以及等待时间
+ *
+ * @return 获取锁的时刻，用于计算占用时间
+ */
+static int64_t bus_acquire(void)
+{
+    int64_t start = esp_timer_get_time();
+    bool contended = false;
+    if (xSemaphoreTake(s_bus_lock, 0) != pdTRUE)
+    {
+        contended = true;
+        xSemaphoreTake(s_bus_lock, portMAX_DELAY);
+    }
+    int64_t now = esp_timer_get_time();
+    if (contended)
+    {
+        portENTER_CRITICAL(&s_stats_lock);
+        s_stats.contended++;
+        s_stats.wait_us += now - start;
+        portEXIT_CRITICAL(&s_stats_lock);
+    }
+    return now;
+}
+
+/**
+ * @brief 释放总线锁并累计本次请求的统计
+ */
+static void bus_release(int64_t acquired, bool write, unsigned count)
+{
+    int64_t busy = esp_timer_get_time() - acquired;
+    xSemaphoreGive(s_bus_lock);
+
+    portENTER_CRITICAL(&s_stats_lock);
+    if (write)
+    {
+        s_stats.writes++;
+    }
+    else
+    {
+        s_stats.reads++;
+    }
+    s_stats.sectors += count;
+    s_stats.busy_us += busy;
+    portEXIT_CRITICAL(&s_stats_lock);
+}
+
+static DSTATUS diskio_init(BYTE pdrv)
+{
+    return s_cards[pdrv] ? 0 : STA_NOINIT;
+}
+
+static DSTATUS diskio_status(BYTE pdrv)
+{
+    return s_cards[pdrv] ? 0 : STA_NOINIT;
+}
+
+static DRESULT diskio_read(BYTE pdrv, BYTE *buff, uint32_t sector, UINT count)
+{
+    int64_t acquired = bus_acquire();
+    esp_err_t ret = sdmmc_read_sectors(s_cards[pdrv], buff, sector, count);
+    bus_release(acquired, false, count);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "sdmmc_read_sectors failed (%s)", esp_err_to_name(ret));
+        return RES_ERROR;
+    }
+    return RES_OK;
+}
+
+static DRESULT diskio_write(BYTE pdrv, const BYTE *buff, uint32_t sector, UINT count)
+{
+    int64_t acquired = bus_acquire();
+    esp_err_t ret = sdmmc_write_sectors(s_cards[pdrv], buff, sector, count);
+    bus_release(acquired, true, count);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "sdmmc_write_sectors failed (%s)", esp_err_to_name(ret));
+        return RES_ERROR;
+    }
+    return RES_OK;
+}
+
+static DRESULT diskio_ioctl(BYTE pdrv, BYTE cmd, void *buff)
+{
+    sdmmc_card_t *card = s_cards[pdrv];
+    switch (cmd)
+    {
+    case CTRL_SYNC:
+        // sdmmc_write_sectors返回前已等待卡编程完成
+        return RES_OK;
+    case GET_SECTOR_COUNT:
+        *((DWORD *)buff) = card->csd.capacity;
+        return RES_OK;
+    case GET_SECTOR_SIZE:
+        *((WORD *)buff) = card->csd.sector_size;
+        return RES_OK;
+    case GET_BLOCK_SIZE:
+        return RES_ERROR;
+    }
+    return RES_ERROR;
+}
+
+static const ff_diskio_impl_t s_impl = {
+    .init = &diskio_init,
+    .status = &diskio_status,
+    .read = &diskio_read,
+    .write = &diskio_write,
+    .ioctl = &diskio_ioctl,
+};
+
+esp_err_t sd_diskio_register(BYTE pdrv, sdmmc_card_t *card)
+{
+    if (pdrv >= FF_VOLUMES)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_bus_lock == NULL)
+    {
+        s_bus_lock = xSemaphoreCreateMutex();
+        if (s_bus_lock == NULL)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    s_cards[pdrv] = card;
+    ff_diskio_register(pdrv, &s_impl);
+    return ESP_OK;
+}
+
+void sd_diskio_unregister(BYTE pdrv)
+{
+    if (pdrv >= FF_VOLUMES)
+    {
+        return;
+    }
+    ff_diskio_register(pdrv, NULL);
+    s_cards[pdrv] = NULL;
+}
+
+void sd_diskio_take_stats(sd_diskio_stats_t *stats)
+{
+    portENTER_CRITICAL(&s_stats_lock);
+    if (stats)
+    {
+        *stats = s_stats;
+    }
+    memset(&s_stats, 0, sizeof(s_stats));
+    portEXIT_CRITICAL(&s_stats_lock);
+}
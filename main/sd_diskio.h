@@ -0,0 +1,61 @@
+/*
+ * 带总线统计的FATFS磁盘驱动
+ *
+ * 与ff_diskio_register_sdmmc功能相同，但所有扇区读写都经过一个SD卡级别的互斥锁，
+ * 并统计请求数、等待总线的次数和时间，用于观察多个卷共用一张卡时的总线争用。
+ *
+ * FATFS的互斥锁是按卷划分的：不同卷上的两个写任务不会互相等待FATFS锁，
+ * 但它们最终仍然共用同一条SD总线，这里统计的就是这部分等待。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdmmc_cmd.h"
+#include "ff.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 总线统计信息
+ */
+typedef struct
+{
+    uint32_t reads;      // 读请求数（一次请求可包含多个扇区）
+    uint32_t writes;     // 写请求数
+    uint32_t sectors;    // 读写的扇区总数
+    uint32_t contended;  // 需要等待其他任务释放总线的请求数
+    int64_t wait_us;     // 等待总线的累计时间
+    int64_t busy_us;     // 占用总线（执行读写）的累计时间
+} sd_diskio_stats_t;
+
+/**
+ * @brief 把SD卡注册为FATFS物理驱动器pdrv
+ *
+ * 同一张卡可以注册到多个物理驱动器号上，它们共用同一个总线锁和统计信息。
+ *
+ * @param pdrv 物理驱动器号（通过ff_diskio_get_drive获取）
+ * @param card 已初始化的SD卡
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 驱动器号无效，ESP_ERR_NO_MEM 创建互斥锁失败
+ */
+esp_err_t sd_diskio_register(BYTE pdrv, sdmmc_card_t *card);
+
+/**
+ * @brief 注销物理驱动器pdrv
+ */
+void sd_diskio_unregister(BYTE pdrv);
+
+/**
+ * @brief 读取并清零总线统计信息
+ *
+ * @param stats 输出的统计信息（可为NULL，仅清零）
+ */
+void sd_diskio_take_stats(sd_diskio_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
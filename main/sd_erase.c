@@ -0,0 +1,459 @@
+/*
+ * 扇区擦除与整卡清除实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_rom_sys.h"
+#include "freertos/task.h"
+#include "driver/sdmmc_defs.h"
+#include "sd_erase.h"
+#include "sd_raw.h"
+
+#define ERASE_TASK_STACK_SIZE 3072
+#define ERASE_SSR_SIZE 64                          // SD状态寄存器大小（字节）
+#define ERASE_CCC_ERASE (1 << 5)                   // CSD命令类中的擦除类
+#define ERASE_CHUNK_BYTES (16 * 1024 * 1024)       // 每条CMD38擦除的大小（按AU向上取整）
+#define ERASE_DEFAULT_UNIT_SECTORS (8 * 1024)      // 卡未报告AU时估算超时的单位（4MB）
+#define ERASE_DEFAULT_UNIT_TIMEOUT_MS 250          // 卡未报告超时参数时每个单位的超时
+#define ERASE_MIN_TIMEOUT_MS 1000                  // 每条擦除命令的最短超时
+#define ERASE_SPIN_US (10 * 1000)                  // 擦除后先忙等待的时间，之后每个tick查询一次
+#define ERASE_BENCH_NAME "ERASE.BIN"               // 测试区域占位文件
+#define ERASE_BENCH_REGION_SIZE (32 * 1024 * 1024) // 测试区域大小
+#define ERASE_BENCH_WRITE_BLOCKS 128               // 覆盖写入时每条CMD25的扇区数
+
+static const char *TAG = "sd_erase";
+
+// SD状态寄存器中的AU_SIZE编码对应的AU大小（KB），0表示未定义
+static const uint32_t s_au_kb[16] = {
+    0, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 12288, 16384, 24576, 32768, 65536,
+};
+
+/**
+ * @brief 通过主机驱动发送一条命令，同时检查传输错误和命令错误
+ */
+static esp_err_t send_cmd(sdmmc_card_t *card, sdmmc_command_t *cmd)
+{
+    esp_err_t ret = card->host.do_transaction(card->host.slot, cmd);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    return cmd->error;
+}
+
+/**
+ * @brief 用ACMD13读取64字节的SD状态寄存器
+ */
+static esp_err_t read_ssr(sdmmc_card_t *card, uint8_t *ssr)
+{
+    sdmmc_command_t app_cmd = {
+        .opcode = MMC_APP_CMD,
+        .arg = MMC_ARG_RCA(card->rca),
+        .flags = SCF_CMD_AC | SCF_RSP_R1,
+    };
+    esp_err_t ret = send_cmd(card, &app_cmd);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    sdmmc_command_t cmd = {
+        .opcode = SD_APP_SD_STATUS,
+        .flags = SCF_CMD_ADTC | SCF_CMD_READ | SCF_RSP_R1,
+        .data = ssr,
+        .datalen = ERASE_SSR_SIZE,
+        .blklen = ERASE_SSR_SIZE,
+    };
+    return send_cmd(card, &cmd);
+}
+
+esp_err_t sd_erase_get_info(sdmmc_card_t *card, sd_erase_info_t *info)
+{
+    memset(info, 0, sizeof(*info));
+    info->supported = (card->csd.card_command_class & ERASE_CCC_ERASE) != 0;
+    if (card->is_mmc || !card->is_mem)
+    {
+        return ESP_OK;
+    }
+    uint8_t *ssr = heap_caps_malloc(ERASE_SSR_SIZE, MALLOC_CAP_DMA);
+    if (ssr == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = read_ssr(card, ssr);
+    if (ret == ESP_OK)
+    {
+        // 寄存器按大端顺序传输，第0字节为位511~504
+        info->au_sectors = s_au_kb[ssr[10] >> 4] * 2;
+        info->erase_size_au = (ssr[11] << 8) | ssr[12];
+        info->erase_timeout_s = ssr[13] >> 2;
+        info->erase_offset_s = ssr[13] & 0x3;
+        if (info->erase_timeout_s == 0)
+        {
+            info->erase_size_au = 0;
+        }
+    }
+    else
+    {
+        ESP_LOGW(TAG, "Failed to read SD status (%s), using default erase timeouts", esp_err_to_name(ret));
+    }
+    free(ssr);
+    return ESP_OK;
+}
+
+/**
+ * @brief 擦除count个扇区的超时时间
+ */
+static uint32_t erase_timeout_ms(const sd_erase_info_t *info, uint32_t count)
+{
+    uint32_t timeout;
+    if (info->au_sectors != 0 && info->erase_size_au != 0)
+    {
+        // 范围可能跨过两端不完整的AU，多算一个
+        uint64_t aus = (count + info->au_sectors - 1) / info->au_sectors + 1;
+        timeout = aus * info->erase_timeout_s * 1000 / info->erase_size_au + info->erase_offset_s * 1000;
+    }
+    else
+    {
+        uint32_t units = (count + ERASE_DEFAULT_UNIT_SECTORS - 1) / ERASE_DEFAULT_UNIT_SECTORS;
+        timeout = units * ERASE_DEFAULT_UNIT_TIMEOUT_MS;
+    }
+    return timeout > ERASE_MIN_TIMEOUT_MS ? timeout : ERASE_MIN_TIMEOUT_MS;
+}
+
+/**
+ * @brief SD模式下等待卡完成擦除并回到传输状态
+ *
+ * SDSPI模式下主机驱动在R1b响应后已等待忙信号结束。
+ */
+static esp_err_t wait_erased(sdmmc_card_t *card, uint32_t timeout_ms)
+{
+    if (card->host.flags & SDMMC_HOST_FLAG_SPI)
+    {
+        return ESP_OK;
+    }
+    int64_t start = esp_timer_get_time();
+    int64_t deadline = start + (int64_t)timeout_ms * 1000;
+    while (true)
+    {
+        sdmmc_command_t cmd = {
+            .opcode = MMC_SEND_STATUS,
+            .arg = MMC_ARG_RCA(card->rca),
+            .flags = SCF_CMD_AC | SCF_RSP_R1,
+        };
+        esp_err_t ret = send_cmd(card, &cmd);
+        if (ret != ESP_OK)
+        {
+            return ret;
+        }
+        if ((MMC_R1(cmd.response) & MMC_R1_READY_FOR_DATA) &&
+            MMC_R1_CURRENT_STATE(cmd.response) == MMC_R1_CURRENT_STATE_TRAN)
+        {
+            return ESP_OK;
+        }
+        int64_t now = esp_timer_get_time();
+        if (now > deadline)
+        {
+            return ESP_ERR_TIMEOUT;
+        }
+        // 小范围擦除通常很快完成，先短间隔查询，之后让出CPU
+        if (now - start < ERASE_SPIN_US)
+        {
+            esp_rom_delay_us(200);
+        }
+        else
+        {
+            vTaskDelay(1);
+        }
+    }
+}
+
+/**
+ * @brief 用一组CMD32/CMD33/CMD38擦除[first, last]，并等待完成
+ */
+static esp_err_t erase_chunk(sdmmc_card_t *card, uint32_t first, uint32_t last, uint32_t timeout_ms)
+{
+    if ((card->ocr & SD_OCR_SDHC_CAP) == 0)
+    {
+        first *= SD_RAW_SECTOR_SIZE; // 标准容量卡使用字节地址
+        last *= SD_RAW_SECTOR_SIZE;
+    }
+    sdmmc_command_t start_cmd = {
+        .opcode = SD_ERASE_GROUP_START,
+        .arg = first,
+        .flags = SCF_CMD_AC | SCF_RSP_R1,
+    };
+    esp_err_t ret = send_cmd(card, &start_cmd);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    sdmmc_command_t end_cmd = {
+        .opcode = SD_ERASE_GROUP_END,
+        .arg = last,
+        .flags = SCF_CMD_AC | SCF_RSP_R1,
+    };
+    ret = send_cmd(card, &end_cmd);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    sdmmc_command_t erase_cmd = {
+        .opcode = MMC_ERASE,
+        .arg = 0,
+        .flags = SCF_CMD_AC | SCF_RSP_R1B,
+        .timeout_ms = timeout_ms,
+    };
+    ret = send_cmd(card, &erase_cmd);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    return wait_erased(card, timeout_ms);
+}
+
+esp_err_t sd_erase_range(sdmmc_card_t *card, const sd_erase_info_t *info, uint32_t start, uint32_t count,
+                         volatile uint32_t *done)
+{
+    if (!info->supported)
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (count == 0 || (uint64_t)start + count > (uint64_t)card->csd.capacity)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // 分块大小取AU的整数倍，分块边界与AU边界对齐
+    uint32_t unit = info->au_sectors != 0 ? info->au_sectors : ERASE_DEFAULT_UNIT_SECTORS;
+    uint32_t chunk = (ERASE_CHUNK_BYTES / SD_RAW_SECTOR_SIZE + unit - 1) / unit * unit;
+
+    uint32_t end = start + count;
+    uint32_t pos = start;
+    while (pos < end)
+    {
+        uint32_t next = (pos / chunk + 1) * chunk;
+        if (next > end || next < pos)
+        {
+            next = end;
+        }
+        esp_err_t ret = erase_chunk(card, pos, next - 1, erase_timeout_ms(info, next - pos));
+        if (ret != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Erase of sectors %u-%u failed (%s)", (unsigned)pos, (unsigned)(next - 1),
+                     esp_err_to_name(ret));
+            return ret;
+        }
+        pos = next;
+        if (done != NULL)
+        {
+            *done = pos - start;
+        }
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 后台擦除任务
+ */
+static void erase_task(void *arg)
+{
+    sd_erase_job_t *job = arg;
+    int64_t start = esp_timer_get_time();
+    job->result = sd_erase_range(job->card, &job->info, job->start, job->count, &job->done);
+    job->elapsed_us = esp_timer_get_time() - start;
+    xSemaphoreGive(job->finished);
+    vTaskDelete(NULL);
+}
+
+esp_err_t sd_erase_start(sd_erase_job_t *job, sdmmc_card_t *card, uint32_t start, uint32_t count)
+{
+    memset(job, 0, sizeof(*job));
+    job->card = card;
+    job->start = start;
+    job->count = count;
+    job->result = ESP_OK;
+    esp_err_t ret = sd_erase_get_info(card, &job->info);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    job->finished = xSemaphoreCreateBinary();
+    if (job->finished == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreatePinnedToCore(erase_task, "sd_erase", ERASE_TASK_STACK_SIZE, job,
+                                uxTaskPriorityGet(NULL), NULL, tskNO_AFFINITY) != pdPASS)
+    {
+        vSemaphoreDelete(job->finished);
+        job->finished = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t sd_erase_wait(sd_erase_job_t *job, TickType_t ticks)
+{
+    if (job->finished == NULL)
+    {
+        return job->result;
+    }
+    if (xSemaphoreTake(job->finished, ticks) != pdTRUE)
+    {
+        return ESP_ERR_TIMEOUT;
+    }
+    vSemaphoreDelete(job->finished);
+    job->finished = NULL;
+    return job->result;
+}
+
+esp_err_t sd_erase_wipe(sd_mount_t *mnt)
+{
+    sd_mount_params_t params = mnt->params;
+    sd_unmount(mnt);
+
+    // 只初始化卡，擦除期间没有文件系统访问卡
+    esp_err_t ret = sd_mount_raw(&params, mnt);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    uint32_t total = mnt->card->csd.capacity;
+    sd_erase_job_t job;
+    ret = sd_erase_start(&job, mnt->card, 0, total);
+    if (ret == ESP_OK)
+    {
+        printf("Wiping %u MB...\n", (unsigned)(total / 2048));
+        while ((ret = sd_erase_wait(&job, pdMS_TO_TICKS(1000))) == ESP_ERR_TIMEOUT)
+        {
+            printf("  %3u%%  %u MB\n", (unsigned)((uint64_t)job.done * 100 / total), (unsigned)(job.done / 2048));
+        }
+    }
+    sd_unmount(mnt);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Wipe failed (%s), card is left unmounted", esp_err_to_name(ret));
+        return ret;
+    }
+    printf("Wiped in %.1f s, formatting\n", job.elapsed_us / 1000000.0);
+
+    // 分区表已被擦除，挂载时重新分区并格式化
+    sd_mount_params_t format_params = params;
+    format_params.format_if_mount_failed = true;
+    ret = sd_mount(&format_params, mnt);
+    mnt->params = params;
+    return ret;
+}
+
+static void print_row(const char *label, esp_err_t ret, uint32_t sectors, int64_t us, uint32_t card_sectors)
+{
+    if (ret != ESP_OK)
+    {
+        printf("  %-18s failed (%s)\n", label, esp_err_to_name(ret));
+        return;
+    }
+    double seconds = us / 1000000.0;
+    printf("  %-18s %9.1f %9.2f %12.1f\n", label, us / 1000.0,
+           (sectors * (double)SD_RAW_SECTOR_SIZE / (1024 * 1024)) / seconds,
+           seconds * card_sectors / sectors);
+}
+
+void sd_erase_bench_run(sdmmc_card_t *card)
+{
+    sd_erase_info_t info;
+    if (sd_erase_get_info(card, &info) != ESP_OK)
+    {
+        return;
+    }
+    if (!info.supported)
+    {
+        ESP_LOGW(TAG, "Card does not support erase commands, erase benchmark skipped");
+        return;
+    }
+    sd_raw_region_t region;
+    if (sd_raw_reserve(card, ERASE_BENCH_NAME, ERASE_BENCH_REGION_SIZE, &region) != ESP_OK)
+    {
+        return;
+    }
+    uint8_t *buf = heap_caps_calloc(ERASE_BENCH_WRITE_BLOCKS, SD_RAW_SECTOR_SIZE, MALLOC_CAP_DMA);
+    if (buf == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate write buffer");
+        sd_raw_release(&region);
+        return;
+    }
+    uint32_t total = region.sectors - region.sectors % ERASE_BENCH_WRITE_BLOCKS;
+    uint32_t card_sectors = card->csd.capacity;
+
+    printf("\nErase vs overwrite (%u KB region, AU %u KB", (unsigned)(total / 2), (unsigned)(info.au_sectors / 2));
+    if (info.erase_size_au != 0)
+    {
+        printf(", timeout %u s per %u AU + %u s", (unsigned)info.erase_timeout_s, (unsigned)info.erase_size_au,
+               (unsigned)info.erase_offset_s);
+    }
+    printf("):\n");
+    printf("  %-18s %9s %9s %12s\n", "method", "ms", "MB/s", "full card s");
+
+    // 覆盖写入：与用文件写满整张卡清除数据的方式相同，每条CMD25写入64KB的0
+    esp_err_t ret = ESP_OK;
+    int64_t start = esp_timer_get_time();
+    for (uint32_t sector = 0; sector < total && ret == ESP_OK; sector += ERASE_BENCH_WRITE_BLOCKS)
+    {
+        ret = sd_raw_write(&region, sector, buf, ERASE_BENCH_WRITE_BLOCKS);
+    }
+    print_row("overwrite 64K", ret, total, esp_timer_get_time() - start, card_sectors);
+
+    start = esp_timer_get_time();
+    ret = sd_erase_range(card, &info, region.start, total, NULL);
+    print_row("erase", ret, total, esp_timer_get_time() - start, card_sectors);
+
+    // 擦除后的扇区内容应一致（全0或全1，取决于卡）
+    if (ret == ESP_OK && sd_raw_read(&region, total / 2, buf, 1) == ESP_OK)
+    {
+        bool uniform = true;
+        for (int i = 1; i < SD_RAW_SECTOR_SIZE; i++)
+        {
+            uniform &= buf[i] == buf[0];
+        }
+        if (uniform)
+        {
+            printf("  erased sectors read as 0x%02X\n", buf[0]);
+        }
+        else
+        {
+            printf("  erased sector content is not uniform\n");
+        }
+    }
+
+    // 后台擦除：调用者每10ms查询一次进度
+    sd_erase_job_t job;
+    uint32_t updates = 0;
+    uint32_t last_done = 0;
+    ret = sd_erase_start(&job, card, region.start, total);
+    if (ret == ESP_OK)
+    {
+        while ((ret = sd_erase_wait(&job, pdMS_TO_TICKS(10))) == ESP_ERR_TIMEOUT)
+        {
+            if (job.done != last_done)
+            {
+                last_done = job.done;
+                updates++;
+            }
+        }
+    }
+    print_row("erase (background)", ret, total, job.elapsed_us, card_sectors);
+    if (ret == ESP_OK)
+    {
+        printf("  background job: %u progress updates seen while waiting\n", (unsigned)updates);
+    }
+    printf("  full card s: time extrapolated to the whole card (%u MB)\n\n", (unsigned)(card_sectors / 2048));
+
+    free(buf);
+    sd_raw_release(&region);
+}
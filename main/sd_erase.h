@@ -0,0 +1,124 @@
+/*
+ * 扇区擦除与整卡清除
+ *
+ * 用CMD32/CMD33/CMD38擦除扇区范围，卡在内部把整块闪存标记为已擦除，
+ * 不需要像覆盖写入那样逐扇区传输数据。擦除参数来自SD状态寄存器（ACMD13）：
+ * - AU_SIZE：分配单元大小，范围按AU边界切分，每条CMD38只擦除整数个AU（首尾除外）
+ * - ERASE_SIZE/ERASE_TIMEOUT/ERASE_OFFSET：按擦除的AU数计算每条CMD38的超时
+ * 卡未报告这些参数时按每4MB一个分块、每个分块250ms估算超时。
+ *
+ * 擦除后扇区读出为全0或全1，取决于卡（SCR的DATA_STAT_AFTER_ERASE）。
+ * 后台擦除任务按分块更新进度，调用者可以在等待时输出进度。
+ * sd_erase_wipe清除整张卡（包括分区表），然后重新挂载并格式化。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "sdmmc_cmd.h"
+#include "sd_mount.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 卡的擦除参数
+ */
+typedef struct
+{
+    bool supported;           // CSD的命令类中包含擦除命令（class 5）
+    uint32_t au_sectors;      // 分配单元大小（扇区），0表示卡未报告
+    uint32_t erase_size_au;   // ERASE_SIZE：与超时对应的AU数，0表示卡未报告超时参数
+    uint32_t erase_timeout_s; // ERASE_TIMEOUT：擦除erase_size_au个AU的超时（秒）
+    uint32_t erase_offset_s;  // ERASE_OFFSET：每条擦除命令附加的超时（秒）
+} sd_erase_info_t;
+
+/**
+ * @brief 后台擦除任务
+ */
+typedef struct
+{
+    sdmmc_card_t *card;         // SD卡
+    sd_erase_info_t info;       // 擦除参数
+    uint32_t start;             // 起始扇区（绝对扇区号）
+    uint32_t count;             // 扇区数
+    volatile uint32_t done;     // 已擦除的扇区数
+    volatile esp_err_t result;  // 任务结束后的结果
+    int64_t elapsed_us;         // 任务耗时
+    SemaphoreHandle_t finished; // 任务退出信号
+} sd_erase_job_t;
+
+/**
+ * @brief 读取卡的擦除参数
+ *
+ * @return ESP_OK 成功，读取SD状态寄存器失败时也返回ESP_OK（AU等参数为0）
+ */
+esp_err_t sd_erase_get_info(sdmmc_card_t *card, sd_erase_info_t *info);
+
+/**
+ * @brief 擦除扇区范围，按AU边界分块发送擦除命令，阻塞到全部完成
+ *
+ * @param card  SD卡
+ * @param info  擦除参数（sd_erase_get_info）
+ * @param start 起始扇区（绝对扇区号）
+ * @param count 扇区数
+ * @param done  可为NULL；每完成一个分块更新为已擦除的扇区数
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_NOT_SUPPORTED 卡不支持擦除命令
+ *  - ESP_ERR_INVALID_ARG 范围超出卡容量
+ *  - ESP_ERR_TIMEOUT 卡在超时时间内没有完成擦除
+ *  - 其他错误码来自主机驱动
+ */
+esp_err_t sd_erase_range(sdmmc_card_t *card, const sd_erase_info_t *info, uint32_t start, uint32_t count,
+                         volatile uint32_t *done);
+
+/**
+ * @brief 启动后台擦除任务
+ *
+ * 擦除期间卡被任务独占，调用者不能通过文件系统或其他方式访问该卡。
+ *
+ * @param job   任务状态，sd_erase_wait返回前必须保持有效
+ * @param card  SD卡
+ * @param start 起始扇区（绝对扇区号）
+ * @param count 扇区数
+ * @return ESP_OK 已启动，ESP_ERR_NO_MEM 无法创建任务，其他错误码同sd_erase_get_info
+ */
+esp_err_t sd_erase_start(sd_erase_job_t *job, sdmmc_card_t *card, uint32_t start, uint32_t count);
+
+/**
+ * @brief 等待后台擦除任务结束
+ *
+ * @param job   任务状态
+ * @param ticks 最长等待时间，超时后可以读取job->done输出进度再继续等待
+ * @return ESP_ERR_TIMEOUT 任务尚未结束，否则为擦除结果（任务资源已释放）
+ */
+esp_err_t sd_erase_wait(sd_erase_job_t *job, TickType_t ticks);
+
+/**
+ * @brief 清除整张卡并重新挂载，挂载时自动分区和格式化
+ *
+ * 先卸载文件系统并只初始化卡，在后台擦除全部扇区（每秒输出一次进度），
+ * 再以format_if_mount_failed挂载。
+ *
+ * @param mnt 已挂载的卡，成功后为新的挂载状态
+ * @return ESP_OK 成功，其他错误码来自擦除或挂载
+ */
+esp_err_t sd_erase_wipe(sd_mount_t *mnt);
+
+/**
+ * @brief 在预留区域上对比覆盖写入与擦除命令的耗时，并换算为清除整卡的时间
+ *
+ * @param card 已通过sd_mount挂载的SD卡
+ */
+void sd_erase_bench_run(sdmmc_card_t *card);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,665 @@
+/*
+ * 多通道扇出日志实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/unistd.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "diskio_sdmmc.h"
+#include "sd_fanout.h"
+
+#define FANOUT_WRITER_STACK_SIZE 4096
+#define FANOUT_DRAINED_BIT (1u << SD_FANOUT_MAX_CHANNELS) // 交给写入任务的缓冲区都已写完
+#define FANOUT_BENCH_CHANNELS 12                          // 测试通道数
+#define FANOUT_BENCH_BYTES (4 * 1024 * 1024)              // 所有通道写入的总字节数
+#define FANOUT_BENCH_RECORD 64                            // 每条记录的字节数
+
+static const char *TAG = "sd_fanout";
+
+/**
+ * @brief 池中的缓冲区
+ */
+typedef struct sd_fanout_buf
+{
+    uint8_t *data;              // 缓冲区（DMA可用，buf_size字节）
+    size_t len;                 // 已填充的字节数
+    size_t cap;                 // 本次最多填充的字节数，使缓冲区结束于文件中的对齐位置
+    int64_t submit_us;          // 交给写入任务的时刻
+    struct sd_fanout_buf *next; // 链表中的下一个
+} fanout_buf_t;
+
+/**
+ * @brief 按上一段时间各通道写入的字节数重新分配配额
+ *
+ * 每个通道保留两个缓冲区，其余按比例分配，配额之和不超过池中的缓冲区数。
+ * 调用者必须持有f->lock。
+ */
+static void rebalance(sd_fanout_t *f)
+{
+    uint64_t total = 0;
+    for (size_t i = 0; i < f->channel_count; i++)
+    {
+        total += f->channels[i].recent_bytes;
+    }
+    f->since_rebalance = 0;
+    if (total == 0)
+    {
+        return;
+    }
+    uint32_t spare = f->config.buf_count - 2 * f->channel_count;
+    for (size_t i = 0; i < f->channel_count; i++)
+    {
+        sd_fanout_channel_t *ch = &f->channels[i];
+        ch->quota = 2 + (uint32_t)((uint64_t)spare * ch->recent_bytes / total);
+        ch->recent_bytes = 0;
+    }
+    f->rebalances++;
+}
+
+/**
+ * @brief 把通道正在填充的缓冲区交给写入任务
+ *
+ * 调用者必须持有f->lock。
+ */
+static void submit_current(sd_fanout_t *f, sd_fanout_channel_t *ch)
+{
+    fanout_buf_t *b = ch->cur;
+    if (b == NULL || b->len == 0)
+    {
+        return;
+    }
+    ch->cur = NULL;
+    b->submit_us = esp_timer_get_time();
+    if (ch->last != NULL)
+    {
+        ch->last->next = b;
+    }
+    else
+    {
+        ch->pending = b;
+    }
+    ch->last = b;
+    ch->submitted += b->len;
+    f->inflight++;
+    xEventGroupClearBits(f->events, FANOUT_DRAINED_BIT);
+    if (++f->since_rebalance >= f->config.buf_count)
+    {
+        rebalance(f);
+    }
+    xTaskNotifyGive(f->writer);
+}
+
+/**
+ * @brief 为通道从池中取一个缓冲区，超出配额或池为空时等待写入任务释放（可能阻塞）
+ *
+ * 调用者必须持有f->lock，等待期间会暂时释放。
+ */
+static void take_buffer(sd_fanout_t *f, size_t index)
+{
+    sd_fanout_channel_t *ch = &f->channels[index];
+    EventBits_t bit = 1u << index;
+    bool stalled = false;
+    while (f->free_list == NULL || ch->held >= ch->quota)
+    {
+        // 先清除本通道的位再释放锁，写入任务之后置位时等待立即返回
+        stalled = true;
+        f->waiting |= bit;
+        xEventGroupClearBits(f->events, bit);
+        xSemaphoreGive(f->lock);
+        xEventGroupWaitBits(f->events, bit, pdTRUE, pdFALSE, portMAX_DELAY);
+        xSemaphoreTake(f->lock, portMAX_DELAY);
+    }
+    ch->stalls += stalled;
+
+    fanout_buf_t *b = f->free_list;
+    f->free_list = b->next;
+    b->next = NULL;
+    b->len = 0;
+    // sd_fanout_sync写出过不满的缓冲区时，只填充到下一个对齐位置
+    b->cap = f->config.buf_size - ch->submitted % f->config.buf_size;
+    ch->cur = b;
+    ch->held++;
+}
+
+/**
+ * @brief 后台写入任务：按轮询顺序每次取一个通道的全部待写缓冲区，连续写入该通道的文件
+ */
+static void writer_task(void *arg)
+{
+    sd_fanout_t *f = arg;
+    size_t next = 0;
+    while (true)
+    {
+        xSemaphoreTake(f->lock, portMAX_DELAY);
+        sd_fanout_channel_t *ch = NULL;
+        for (size_t i = 0; i < f->channel_count && ch == NULL; i++)
+        {
+            size_t index = (next + i) % f->channel_count;
+            if (f->channels[index].pending != NULL)
+            {
+                ch = &f->channels[index];
+                next = index + 1;
+            }
+        }
+        fanout_buf_t *batch = NULL;
+        if (ch != NULL)
+        {
+            batch = ch->pending;
+            ch->pending = NULL;
+            ch->last = NULL;
+        }
+        bool stop = ch == NULL && f->stopping;
+        xSemaphoreGive(f->lock);
+        if (stop)
+        {
+            break;
+        }
+        if (ch == NULL)
+        {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        // 缓冲区在文件中按顺序相连且结束于对齐位置，FatFs直接用多块写入，不经过扇区缓存
+        uint32_t count = 0;
+        for (fanout_buf_t *b = batch; b != NULL; b = b->next)
+        {
+            if (f->write_err == ESP_OK)
+            {
+                UINT bw;
+                FRESULT res = f_write(&ch->fil, b->data, b->len, &bw);
+                if (res != FR_OK || bw != b->len)
+                {
+                    ESP_LOGE(TAG, "Write of %u bytes to channel %u failed (%d)", (unsigned)b->len,
+                             (unsigned)(ch - f->channels), res);
+                    f->write_err = res == FR_OK ? ESP_ERR_NO_MEM : ESP_FAIL; // bw不足表示卡已满
+                }
+            }
+            ch->queue_us += esp_timer_get_time() - b->submit_us;
+            ch->flushed++;
+            count++;
+        }
+        f->batches++;
+
+        // 出错后仍然释放缓冲区，等待中的通道不会永远阻塞
+        xSemaphoreTake(f->lock, portMAX_DELAY);
+        while (batch != NULL)
+        {
+            fanout_buf_t *b = batch;
+            batch = b->next;
+            b->next = f->free_list;
+            f->free_list = b;
+        }
+        ch->held -= count;
+        f->inflight -= count;
+        if (f->waiting != 0)
+        {
+            xEventGroupSetBits(f->events, f->waiting);
+            f->waiting = 0;
+        }
+        if (f->inflight == 0)
+        {
+            xEventGroupSetBits(f->events, FANOUT_DRAINED_BIT);
+        }
+        xSemaphoreGive(f->lock);
+    }
+    xSemaphoreGive(f->done);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief 关闭前opened个通道的文件并释放资源
+ */
+static void release_fanout(sd_fanout_t *f, size_t opened)
+{
+    for (size_t i = 0; i < opened; i++)
+    {
+        f_close(&f->channels[i].fil);
+    }
+    if (f->bufs != NULL)
+    {
+        for (size_t i = 0; i < f->config.buf_count; i++)
+        {
+            free(f->bufs[i].data);
+        }
+    }
+    free(f->bufs);
+    f->bufs = NULL;
+    free(f->channels);
+    f->channels = NULL;
+    if (f->lock)
+    {
+        vSemaphoreDelete(f->lock);
+        f->lock = NULL;
+    }
+    if (f->events)
+    {
+        vEventGroupDelete(f->events);
+        f->events = NULL;
+    }
+    if (f->done)
+    {
+        vSemaphoreDelete(f->done);
+        f->done = NULL;
+    }
+}
+
+esp_err_t sd_fanout_open(sd_fanout_t *f, sdmmc_card_t *card, const char *const *names, size_t count,
+                         const sd_fanout_config_t *config)
+{
+    memset(f, 0, sizeof(*f));
+    f->config = config != NULL ? *config : (sd_fanout_config_t)SD_FANOUT_CONFIG_DEFAULT();
+    f->write_err = ESP_OK;
+    if (count == 0 || count > SD_FANOUT_MAX_CHANNELS || f->config.buf_size == 0 ||
+        f->config.buf_size % card->csd.sector_size != 0 || f->config.buf_count < 2 * count)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    BYTE pdrv = ff_diskio_get_pdrv_card(card);
+    if (pdrv == 0xFF)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    f->channels = calloc(count, sizeof(sd_fanout_channel_t));
+    f->bufs = calloc(f->config.buf_count, sizeof(fanout_buf_t));
+    f->lock = xSemaphoreCreateMutex();
+    f->events = xEventGroupCreate();
+    f->done = xSemaphoreCreateBinary();
+    if (f->channels == NULL || f->bufs == NULL || f->lock == NULL || f->events == NULL || f->done == NULL)
+    {
+        release_fanout(f, 0);
+        return ESP_ERR_NO_MEM;
+    }
+    for (size_t i = 0; i < f->config.buf_count; i++)
+    {
+        f->bufs[i].data = heap_caps_malloc(f->config.buf_size, MALLOC_CAP_DMA);
+        if (f->bufs[i].data == NULL)
+        {
+            ESP_LOGE(TAG, "Failed to allocate %u x %u-byte buffer pool", (unsigned)f->config.buf_count,
+                     (unsigned)f->config.buf_size);
+            release_fanout(f, 0);
+            return ESP_ERR_NO_MEM;
+        }
+        f->bufs[i].next = f->free_list;
+        f->free_list = &f->bufs[i];
+    }
+
+    // 还没有速率信息，先平均分配
+    f->channel_count = count;
+    for (size_t i = 0; i < count; i++)
+    {
+        char path[24];
+        snprintf(path, sizeof(path), "%d:/%s", pdrv, names[i]);
+        FRESULT res = f_open(&f->channels[i].fil, path, FA_CREATE_ALWAYS | FA_WRITE);
+        if (res != FR_OK)
+        {
+            ESP_LOGE(TAG, "Failed to open %s (%d)", path, res);
+            release_fanout(f, i);
+            return ESP_FAIL;
+        }
+        f->channels[i].quota = f->config.buf_count / count;
+    }
+    xEventGroupSetBits(f->events, FANOUT_DRAINED_BIT);
+
+    if (xTaskCreatePinnedToCore(writer_task, "sd_fanout_wr", FANOUT_WRITER_STACK_SIZE, f,
+                                uxTaskPriorityGet(NULL), &f->writer, tskNO_AFFINITY) != pdPASS)
+    {
+        release_fanout(f, count);
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t sd_fanout_write(sd_fanout_t *f, size_t channel, const void *data, size_t len)
+{
+    if (channel >= f->channel_count)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (f->write_err != ESP_OK)
+    {
+        return f->write_err;
+    }
+    sd_fanout_channel_t *ch = &f->channels[channel];
+    int64_t start = esp_timer_get_time();
+    const uint8_t *src = data;
+    xSemaphoreTake(f->lock, portMAX_DELAY);
+    while (len > 0)
+    {
+        if (ch->cur == NULL)
+        {
+            take_buffer(f, channel);
+        }
+        fanout_buf_t *b = ch->cur;
+        size_t n = b->cap - b->len;
+        if (n > len)
+        {
+            n = len;
+        }
+        memcpy(b->data + b->len, src, n);
+        b->len += n;
+        src += n;
+        len -= n;
+        ch->bytes += n;
+        ch->recent_bytes += n;
+        if (b->len == b->cap)
+        {
+            submit_current(f, ch);
+        }
+    }
+    xSemaphoreGive(f->lock);
+
+    int64_t us = esp_timer_get_time() - start;
+    ch->writes++;
+    ch->write_us += us;
+    ch->max_write_us = us > ch->max_write_us ? us : ch->max_write_us;
+    return f->write_err;
+}
+
+/**
+ * @brief 交出所有通道不满的缓冲区并等待写入任务写完
+ */
+static void drain(sd_fanout_t *f)
+{
+    xSemaphoreTake(f->lock, portMAX_DELAY);
+    for (size_t i = 0; i < f->channel_count; i++)
+    {
+        submit_current(f, &f->channels[i]);
+    }
+    xSemaphoreGive(f->lock);
+    xEventGroupWaitBits(f->events, FANOUT_DRAINED_BIT, pdFALSE, pdFALSE, portMAX_DELAY);
+}
+
+esp_err_t sd_fanout_sync(sd_fanout_t *f)
+{
+    drain(f);
+    esp_err_t ret = f->write_err;
+    for (size_t i = 0; i < f->channel_count; i++)
+    {
+        if (f_sync(&f->channels[i].fil) != FR_OK && ret == ESP_OK)
+        {
+            ret = ESP_FAIL;
+        }
+    }
+    return ret;
+}
+
+esp_err_t sd_fanout_close(sd_fanout_t *f)
+{
+    drain(f);
+    f->stopping = true;
+    xTaskNotifyGive(f->writer);
+    xSemaphoreTake(f->done, portMAX_DELAY);
+
+    esp_err_t ret = f->write_err;
+    for (size_t i = 0; i < f->channel_count; i++)
+    {
+        if (f_close(&f->channels[i].fil) != FR_OK && ret == ESP_OK)
+        {
+            ret = ESP_FAIL;
+        }
+    }
+    release_fanout(f, 0);
+    return ret;
+}
+
+/**
+ * @brief 写入调用的延迟统计
+ */
+typedef struct
+{
+    uint32_t ops;   // 调用次数
+    int64_t sum_us; // 总延迟
+    int64_t max_us; // 最大延迟
+} write_stats_t;
+
+static void stats_add(write_stats_t *s, int64_t us)
+{
+    s->ops++;
+    s->sum_us += us;
+    s->max_us = us > s->max_us ? us : s->max_us;
+}
+
+static void stats_merge(write_stats_t *total, const write_stats_t *s)
+{
+    total->ops += s->ops;
+    total->sum_us += s->sum_us;
+    total->max_us = s->max_us > total->max_us ? s->max_us : total->max_us;
+}
+
+/**
+ * @brief 通道i每轮写入的记录数，四档速率依次相差一倍
+ */
+static uint32_t channel_weight(size_t i)
+{
+    return 1u << (i % 4);
+}
+
+static void make_record(uint8_t *record, size_t channel, uint32_t n)
+{
+    memset(record, 'a' + channel, FANOUT_BENCH_RECORD);
+    memcpy(record, &n, sizeof(n));
+}
+
+/**
+ * @brief 每个通道一个stdio FILE，使用默认缓冲
+ */
+static esp_err_t bench_stdio(uint32_t rounds, write_stats_t *stats, int64_t *us)
+{
+    FILE *files[FANOUT_BENCH_CHANNELS] = {0};
+    uint8_t record[FANOUT_BENCH_RECORD];
+    char path[32];
+    esp_err_t ret = ESP_OK;
+    int64_t start = esp_timer_get_time();
+    for (size_t i = 0; i < FANOUT_BENCH_CHANNELS; i++)
+    {
+        snprintf(path, sizeof(path), MOUNT_POINT "/FO%02u.LOG", (unsigned)i);
+        files[i] = fopen(path, "w");
+        if (files[i] == NULL)
+        {
+            ret = ESP_FAIL;
+        }
+    }
+    uint32_t n = 0;
+    for (uint32_t r = 0; r < rounds && ret == ESP_OK; r++)
+    {
+        for (size_t i = 0; i < FANOUT_BENCH_CHANNELS; i++)
+        {
+            for (uint32_t k = 0; k < channel_weight(i); k++)
+            {
+                make_record(record, i, n++);
+                int64_t t = esp_timer_get_time();
+                if (fwrite(record, 1, sizeof(record), files[i]) != sizeof(record))
+                {
+                    ret = ESP_FAIL;
+                }
+                stats_add(&stats[i], esp_timer_get_time() - t);
+            }
+        }
+    }
+    for (size_t i = 0; i < FANOUT_BENCH_CHANNELS; i++)
+    {
+        if (files[i] != NULL && fclose(files[i]) != 0)
+        {
+            ret = ESP_FAIL;
+        }
+    }
+    *us = esp_timer_get_time() - start;
+    return ret;
+}
+
+/**
+ * @brief 扇出日志的测试结果，在关闭前从句柄中复制
+ */
+typedef struct
+{
+    uint32_t quota[FANOUT_BENCH_CHANNELS];   // 结束时每个通道的配额
+    uint32_t stalls[FANOUT_BENCH_CHANNELS];  // 每个通道等待缓冲区的次数
+    uint32_t flushed[FANOUT_BENCH_CHANNELS]; // 每个通道写到卡上的缓冲区数
+    int64_t queue_us[FANOUT_BENCH_CHANNELS]; // 每个通道的缓冲区从交出到写完的累计时间
+    uint32_t batches;                        // 写入批次数
+    uint32_t rebalances;                     // 重新分配配额的次数
+} fanout_result_t;
+
+/**
+ * @brief 所有通道写入扇出日志，使用默认配置
+ */
+static esp_err_t bench_fanout(sdmmc_card_t *card, uint32_t rounds, write_stats_t *stats, int64_t *us,
+                              fanout_result_t *result)
+{
+    char names[FANOUT_BENCH_CHANNELS][13];
+    const char *name_ptrs[FANOUT_BENCH_CHANNELS];
+    for (size_t i = 0; i < FANOUT_BENCH_CHANNELS; i++)
+    {
+        snprintf(names[i], sizeof(names[i]), "FO%02u.LOG", (unsigned)i);
+        name_ptrs[i] = names[i];
+    }
+
+    sd_fanout_t f;
+    uint8_t record[FANOUT_BENCH_RECORD];
+    int64_t start = esp_timer_get_time();
+    esp_err_t ret = sd_fanout_open(&f, card, name_ptrs, FANOUT_BENCH_CHANNELS, NULL);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    uint32_t n = 0;
+    for (uint32_t r = 0; r < rounds && ret == ESP_OK; r++)
+    {
+        for (size_t i = 0; i < FANOUT_BENCH_CHANNELS && ret == ESP_OK; i++)
+        {
+            for (uint32_t k = 0; k < channel_weight(i) && ret == ESP_OK; k++)
+            {
+                make_record(record, i, n++);
+                int64_t t = esp_timer_get_time();
+                ret = sd_fanout_write(&f, i, record, sizeof(record));
+                stats_add(&stats[i], esp_timer_get_time() - t);
+            }
+        }
+    }
+    // 同步后写入任务空闲，统计信息不再变化，关闭时只剩目录项已更新的文件
+    esp_err_t sync_ret = sd_fanout_sync(&f);
+    for (size_t i = 0; i < FANOUT_BENCH_CHANNELS; i++)
+    {
+        result->quota[i] = f.channels[i].quota;
+        result->stalls[i] = f.channels[i].stalls;
+        result->flushed[i] = f.channels[i].flushed;
+        result->queue_us[i] = f.channels[i].queue_us;
+    }
+    result->batches = f.batches;
+    result->rebalances = f.rebalances;
+    esp_err_t close_ret = sd_fanout_close(&f);
+    *us = esp_timer_get_time() - start;
+    if (ret == ESP_OK)
+    {
+        ret = sync_ret != ESP_OK ? sync_ret : close_ret;
+    }
+    return ret;
+}
+
+static void print_row(const char *label, esp_err_t ret, const write_stats_t *stats, int64_t us)
+{
+    if (ret != ESP_OK)
+    {
+        printf("  %-10s failed (%s)\n", label, esp_err_to_name(ret));
+        return;
+    }
+    write_stats_t total = {0};
+    for (size_t i = 0; i < FANOUT_BENCH_CHANNELS; i++)
+    {
+        stats_merge(&total, &stats[i]);
+    }
+    printf("  %-10s %8.2f %8.1f %8.2f\n", label, (double)FANOUT_BENCH_BYTES / us,
+           (double)total.sum_us / total.ops, total.max_us / 1000.0);
+}
+
+void sd_fanout_bench_run(const sd_mount_params_t *params)
+{
+    uint32_t weights = 0;
+    for (size_t i = 0; i < FANOUT_BENCH_CHANNELS; i++)
+    {
+        weights += channel_weight(i);
+    }
+    const uint32_t rounds = FANOUT_BENCH_BYTES / (weights * FANOUT_BENCH_RECORD);
+    sd_fanout_config_t config = SD_FANOUT_CONFIG_DEFAULT();
+
+    printf("\nFan-out logger vs one stdio FILE per channel (%u channels, %u KB, %u B records):\n",
+           FANOUT_BENCH_CHANNELS, FANOUT_BENCH_BYTES / 1024, FANOUT_BENCH_RECORD);
+    printf("  %-10s %8s %8s %8s\n", "method", "MB/s", "avg us", "max ms");
+
+    write_stats_t *stdio_stats = calloc(FANOUT_BENCH_CHANNELS, sizeof(write_stats_t));
+    write_stats_t *fanout_stats = calloc(FANOUT_BENCH_CHANNELS, sizeof(write_stats_t));
+    fanout_result_t *result = calloc(1, sizeof(fanout_result_t));
+    if (stdio_stats == NULL || fanout_stats == NULL || result == NULL)
+    {
+        printf("  failed to allocate result buffers\n\n");
+        free(stdio_stats);
+        free(fanout_stats);
+        free(result);
+        return;
+    }
+    // stdio方式同时打开所有通道的文件，受VFS的max_files限制，因此以足够的max_files重新挂载
+    sd_mount_params_t p = *params;
+    if (p.max_files < FANOUT_BENCH_CHANNELS)
+    {
+        p.max_files = FANOUT_BENCH_CHANNELS;
+    }
+    sd_mount_t mnt;
+    if (sd_mount(&p, &mnt) != ESP_OK)
+    {
+        printf("  mount with max_files %d failed\n\n", p.max_files);
+        free(stdio_stats);
+        free(fanout_stats);
+        free(result);
+        return;
+    }
+    int64_t us = 0;
+    esp_err_t stdio_ret = bench_stdio(rounds, stdio_stats, &us);
+    print_row("stdio", stdio_ret, stdio_stats, us);
+    esp_err_t fanout_ret = bench_fanout(mnt.card, rounds, fanout_stats, &us, result);
+    print_row("fan-out", fanout_ret, fanout_stats, us);
+
+    if (fanout_ret == ESP_OK)
+    {
+        printf("  pool %u x %u KB, %u batches, quota rebalanced %u times\n", (unsigned)config.buf_count,
+               (unsigned)(config.buf_size / 1024), (unsigned)result->batches, (unsigned)result->rebalances);
+        printf("  %3s %6s %12s %8s %12s %8s %6s %6s %10s\n", "ch", "weight", "stdio avg us", "max ms",
+               "fan-out us", "max ms", "quota", "stalls", "on-card ms");
+        for (size_t i = 0; i < FANOUT_BENCH_CHANNELS; i++)
+        {
+            const write_stats_t *s = &stdio_stats[i];
+            const write_stats_t *fo = &fanout_stats[i];
+            if (stdio_ret == ESP_OK)
+            {
+                printf("  %3u %6u %12.1f %8.2f", (unsigned)i, (unsigned)channel_weight(i),
+                       (double)s->sum_us / s->ops, s->max_us / 1000.0);
+            }
+            else
+            {
+                printf("  %3u %6u %12s %8s", (unsigned)i, (unsigned)channel_weight(i), "-", "-");
+            }
+            printf(" %12.1f %8.2f %6u %6u %10.1f\n", (double)fo->sum_us / fo->ops, fo->max_us / 1000.0,
+                   (unsigned)result->quota[i], (unsigned)result->stalls[i],
+                   result->flushed[i] ? result->queue_us[i] / 1000.0 / result->flushed[i] : 0.0);
+        }
+    }
+    printf("\n");
+
+    for (size_t i = 0; i < FANOUT_BENCH_CHANNELS; i++)
+    {
+        char path[32];
+        snprintf(path, sizeof(path), MOUNT_POINT "/FO%02u.LOG", (unsigned)i);
+        unlink(path);
+    }
+    sd_unmount(&mnt);
+    free(stdio_stats);
+    free(fanout_stats);
+    free(result);
+}
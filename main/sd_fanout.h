@@ -0,0 +1,152 @@
+/*
+ * 多通道扇出日志
+ *
+ * 多个相互独立的通道各写一个文件时，每个stdio FILE的缓冲区很小，写满就各自调用一次write，
+ * 卡上看到的是不同文件之间交错的单扇区写入。扇出日志改为：
+ * - 所有通道共用一个缓冲区池，每个通道从池中取缓冲区填充，写满后交给后台写入任务
+ * - 写入任务按轮询顺序依次处理各通道，一次写出该通道所有待写的缓冲区，
+ *   每个缓冲区在文件中的偏移都是缓冲区大小的整数倍，FatFs直接以多块写入卡上
+ * - 每个通道可以占用的缓冲区数（配额）按最近的写入速率分配：每个通道至少两个（双缓冲），
+ *   其余的按各通道写入的字节数比例分给速率高的通道，池中缓冲区写入后定期重新分配
+ * 通道占用的缓冲区达到配额或池中没有空闲缓冲区时，sd_fanout_write阻塞直到写入任务写完一个。
+ *
+ * 注意：
+ * - 数据只在缓冲区写满、sd_fanout_sync或sd_fanout_close时写到卡上
+ * - sd_fanout_sync写出不满的缓冲区后，该通道的下一个缓冲区只填充到下一个对齐位置，之后重新对齐
+ * - 同一个通道不能在多个任务中同时写入，不同通道可以
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "sdmmc_cmd.h"
+#include "ff.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "sd_mount.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SD_FANOUT_MAX_CHANNELS 16 // 最多通道数（每个通道占用事件组的一位）
+
+/**
+ * @brief 扇出日志配置
+ */
+typedef struct
+{
+    size_t buf_size;  // 每个缓冲区的字节数（扇区大小的整数倍），也是写入的对齐单位
+    size_t buf_count; // 池中的缓冲区数，至少为通道数的两倍
+} sd_fanout_config_t;
+
+#define SD_FANOUT_CONFIG_DEFAULT() { \
+    .buf_size = 4096,                \
+    .buf_count = 32,                 \
+}
+
+struct sd_fanout_buf;
+
+/**
+ * @brief 通道
+ */
+typedef struct
+{
+    FIL fil;                       // 通道的文件
+    struct sd_fanout_buf *cur;     // 正在填充的缓冲区，NULL表示没有
+    struct sd_fanout_buf *pending; // 待写入的缓冲区链表（按文件顺序）
+    struct sd_fanout_buf *last;    // 待写入链表的末尾
+    FSIZE_t submitted;             // 已交给写入任务的字节数
+    uint32_t held;                 // 占用的缓冲区数（正在填充、待写入和正在写入的）
+    uint32_t quota;                // 可以占用的缓冲区数
+    uint32_t recent_bytes;         // 上次重新分配配额之后写入的字节数
+
+    // 统计信息
+    uint64_t bytes;       // 写入的字节数
+    uint32_t writes;      // sd_fanout_write调用次数
+    int64_t write_us;     // sd_fanout_write累计耗时
+    int64_t max_write_us; // sd_fanout_write最大耗时
+    uint32_t stalls;      // 因配额或池为空而等待的次数
+    uint32_t flushed;     // 写到卡上的缓冲区数
+    int64_t queue_us;     // 缓冲区从交给写入任务到写完的累计时间
+} sd_fanout_channel_t;
+
+/**
+ * @brief 扇出日志
+ */
+typedef struct
+{
+    sd_fanout_config_t config;       // 配置
+    sd_fanout_channel_t *channels;   // 通道数组
+    size_t channel_count;            // 通道数
+    struct sd_fanout_buf *bufs;      // 缓冲区描述符数组
+    struct sd_fanout_buf *free_list; // 空闲缓冲区链表
+    uint32_t inflight;               // 已交给写入任务、尚未写完的缓冲区数
+    uint32_t waiting;                // 正在等待缓冲区的通道（按位）
+    uint32_t since_rebalance;        // 上次重新分配配额之后交给写入任务的缓冲区数
+    SemaphoreHandle_t lock;          // 保护缓冲区池、链表和配额
+    EventGroupHandle_t events;       // 每个通道一位（可取缓冲区），另有一位表示全部写完
+    TaskHandle_t writer;             // 后台写入任务
+    SemaphoreHandle_t done;          // 写入任务退出信号
+    volatile bool stopping;          // 通知写入任务在写完后退出
+    volatile esp_err_t write_err;    // 写入任务遇到的第一个错误
+
+    // 统计信息
+    uint32_t batches;    // 写入任务处理的批次数（每批为一个通道的连续缓冲区）
+    uint32_t rebalances; // 重新分配配额的次数
+} sd_fanout_t;
+
+/**
+ * @brief 打开卡根目录下的一组文件作为通道，并启动后台写入任务
+ *
+ * @param f      扇出日志
+ * @param card   已通过sd_mount挂载的SD卡
+ * @param names  每个通道的文件名（8.3格式，位于根目录），文件已存在时被截断
+ * @param count  通道数（1到SD_FANOUT_MAX_CHANNELS）
+ * @param config 配置，NULL表示使用SD_FANOUT_CONFIG_DEFAULT
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数错误，ESP_ERR_NOT_FOUND 卡未挂载到FATFS，
+ *         ESP_ERR_NO_MEM 内存不足，ESP_FAIL 打开文件失败
+ */
+esp_err_t sd_fanout_open(sd_fanout_t *f, sdmmc_card_t *card, const char *const *names, size_t count,
+                         const sd_fanout_config_t *config);
+
+/**
+ * @brief 向通道追加数据
+ *
+ * 数据被复制到通道的缓冲区中，调用返回后data即可重用。
+ *
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 通道号错误，其他错误码来自之前的写入
+ */
+esp_err_t sd_fanout_write(sd_fanout_t *f, size_t channel, const void *data, size_t len);
+
+/**
+ * @brief 写出所有通道不满的缓冲区，等待写完并同步所有文件
+ */
+esp_err_t sd_fanout_sync(sd_fanout_t *f);
+
+/**
+ * @brief 写出剩余数据，关闭所有文件，停止写入任务并释放资源
+ *
+ * @return 期间第一个写入错误，或ESP_OK
+ */
+esp_err_t sd_fanout_close(sd_fanout_t *f);
+
+/**
+ * @brief 对比扇出日志与每个通道一个stdio FILE在多个不同速率的通道下的总吞吐量和每通道延迟
+ *
+ * stdio方式需要同时打开所有通道的文件，测试以不小于通道数的max_files自行挂载SD卡，
+ * 必须在主挂载卸载后调用。
+ *
+ * @param params 挂载参数（max_files小于通道数时增大）
+ */
+void sd_fanout_bench_run(const sd_mount_params_t *params);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,91 @@
+/*
+ * 写入路径内联SHA-256校验与完整性清单
+ *
+ * 在写入文件的同时计算SHA-256（ESP32-S3上由mbedTLS调用SHA硬件加速器），
+ * 关闭文件时把摘要追加到卡上的清单文件，无需再完整读取一遍文件。
+ *
+ * 清单格式与sha256sum兼容（路径相对于挂载点），在PC上可以进入卡的根目录执行
+ *   sha256sum -c MANIFEST.TXT
+ * 进行校验。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "mbedtls/sha256.h"
+#include "sd_mount.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 清单文件路径（未启用长文件名，文件名需符合8.3格式）
+#define SD_HASH_MANIFEST_PATH MOUNT_POINT "/MANIFEST.TXT"
+
+// SHA-256摘要长度
+#define SD_HASH_DIGEST_LEN 32
+
+/**
+ * @brief 带内联校验的写文件句柄
+ */
+typedef struct
+{
+    FILE *f;                    // 底层文件
+    mbedtls_sha256_context sha; // SHA-256上下文
+    size_t bytes;               // 已写入字节数
+    char path[64];              // 文件路径，关闭时写入清单
+} sd_hashed_file_t;
+
+/**
+ * @brief 创建（覆盖）文件并开始计算SHA-256
+ *
+ * @param hf   句柄
+ * @param path 文件路径（必须位于MOUNT_POINT之下）
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 路径过长，ESP_FAIL 打开文件失败
+ */
+esp_err_t sd_hashed_open(sd_hashed_file_t *hf, const char *path);
+
+/**
+ * @brief 写入数据并更新摘要
+ *
+ * 先写文件，再只对实际写入成功的部分更新摘要，保证摘要与卡上内容一致。
+ *
+ * @return 实际写入的字节数，与fwrite相同
+ */
+size_t sd_hashed_write(sd_hashed_file_t *hf, const void *data, size_t len);
+
+/**
+ * @brief 同步并关闭文件，完成摘要计算并追加清单条目
+ *
+ * @param hf            句柄
+ * @param digest        输出的摘要（可为NULL）
+ * @param manifest_path 清单文件路径，通常为SD_HASH_MANIFEST_PATH；为NULL时不写清单
+ * @return ESP_OK 成功，ESP_FAIL 同步或关闭文件失败，或清单条目未能写入并同步到卡上
+ */
+esp_err_t sd_hashed_close(sd_hashed_file_t *hf, uint8_t digest[SD_HASH_DIGEST_LEN], const char *manifest_path);
+
+/**
+ * @brief 重新读取整个文件计算SHA-256，用于校验清单
+ *
+ * @param path   文件路径
+ * @param digest 输出的摘要
+ * @return ESP_OK 成功，ESP_ERR_NO_MEM 缓冲区分配失败，ESP_FAIL 读取失败
+ */
+esp_err_t sd_hash_file(const char *path, uint8_t digest[SD_HASH_DIGEST_LEN]);
+
+/**
+ * @brief 对比普通写入与带SHA-256写入的吞吐量，并输出纯内存哈希速度作为参考
+ *
+ * 需要SD卡已挂载，测试结束后删除测试文件。
+ *
+ * @param buf_size  每次写入的缓冲区大小
+ * @param file_size 测试文件大小
+ */
+void sd_hash_bench_run(size_t buf_size, size_t file_size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,258 @@
+/*
+ * 卡上测试历史记录与回归检测实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <errno.h>
+#include <sys/unistd.h>
+#include <sys/stat.h>
+#include "esp_log.h"
+#include "esp_ota_ops.h"
+#include "sd_history.h"
+#include "sd_bench.h"
+
+#define HISTORY_LINE_SIZE 160
+
+static const char *TAG = "sd_history";
+
+/**
+ * @brief 把字符串中不适合放进CSV字段的字符替换为'_'
+ */
+static void sanitize(char *str)
+{
+    for (; *str; str++)
+    {
+        if (*str == ',' || !isprint((unsigned char)*str))
+        {
+            *str = '_';
+        }
+    }
+}
+
+void sd_history_card_id(const sdmmc_card_t *card, char *out, size_t size)
+{
+    snprintf(out, size, "%02X-%04X-%.8s-%08X", card->cid.mfg_id & 0xFF, card->cid.oem_id & 0xFFFF,
+             card->cid.name, (unsigned)card->cid.serial);
+    for (char *p = out; *p; p++)
+    {
+        if (!isalnum((unsigned char)*p) && *p != '-')
+        {
+            *p = '_';
+        }
+    }
+}
+
+esp_err_t sd_history_find_baseline(const char *path, const char *card_id, const sd_history_entry_t *key,
+                                   sd_history_entry_t *baseline)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // 文件按时间顺序追加，取最后一条匹配的记录
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+    char line[HISTORY_LINE_SIZE];
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        char card[40];
+        char firmware[40];
+        char flag[12];
+        sd_history_entry_t e;
+        unsigned buf_size;
+        unsigned file_size;
+        memset(&e, 0, sizeof(e));
+        if (sscanf(line, "%39[^,],%39[^,],%11[^,],%u,%u,%d,%f,%f,%11s", card, firmware, e.test,
+                   &buf_size, &file_size, &e.runs, &e.mean_mb, &e.stdev_mb, flag) != 9)
+        {
+            continue; // 表头或损坏的行
+        }
+        e.buf_size = buf_size;
+        e.file_size = file_size;
+        if (strcmp(card, card_id) == 0 && strcmp(e.test, key->test) == 0 &&
+            e.buf_size == key->buf_size && e.file_size == key->file_size &&
+            strcmp(flag, "regress") != 0)
+        {
+            *baseline = e;
+            ret = ESP_OK;
+        }
+    }
+    fclose(f);
+    return ret;
+}
+
+/**
+ * @brief 单侧t检验（显著性水平0.05）的临界值
+ */
+static float t_critical(float df)
+{
+    static const struct
+    {
+        float df;
+        float t;
+    } table[] = {
+        {1, 6.314f}, {2, 2.920f}, {3, 2.353f}, {4, 2.132f}, {5, 2.015f}, {6, 1.943f}, {7, 1.895f},
+        {8, 1.860f}, {9, 1.833f}, {10, 1.812f}, {12, 1.782f}, {15, 1.753f}, {20, 1.725f}, {30, 1.697f},
+    };
+    // 自由度不是整数时取表中不大于它的一项，结果偏保守
+    float t = table[0].t;
+    for (size_t i = 0; i < sizeof(table) / sizeof(table[0]); i++)
+    {
+        if (df >= table[i].df)
+        {
+            t = table[i].t;
+        }
+    }
+    return t;
+}
+
+void sd_history_compare(const sd_history_entry_t *current, const sd_history_entry_t *baseline,
+                        sd_history_cmp_t *cmp)
+{
+    memset(cmp, 0, sizeof(*cmp));
+    if (baseline == NULL || baseline->mean_mb <= 0)
+    {
+        return;
+    }
+    cmp->has_baseline = true;
+    cmp->baseline_mb = baseline->mean_mb;
+    cmp->change_pct = (current->mean_mb - baseline->mean_mb) * 100.0f / baseline->mean_mb;
+
+    // 任一方只有一次运行时无法估计方差，不做显著性判断
+    if (current->runs < 2 || baseline->runs < 2)
+    {
+        return;
+    }
+    float v1 = current->stdev_mb * current->stdev_mb / current->runs;
+    float v2 = baseline->stdev_mb * baseline->stdev_mb / baseline->runs;
+    float se = sqrtf(v1 + v2);
+    if (se <= 0)
+    {
+        // 两次结果都没有波动，任何下降都视为显著
+        cmp->t = current->mean_mb < baseline->mean_mb ? -INFINITY : 0;
+        cmp->regression = cmp->change_pct <= -SD_HISTORY_MIN_CHANGE_PCT;
+        return;
+    }
+    cmp->t = (current->mean_mb - baseline->mean_mb) / se;
+
+    // Welch-Satterthwaite自由度
+    float df = (v1 + v2) * (v1 + v2) /
+               (v1 * v1 / (current->runs - 1) + v2 * v2 / (baseline->runs - 1));
+    cmp->regression = cmp->t < -t_critical(df) && cmp->change_pct <= -SD_HISTORY_MIN_CHANGE_PCT;
+}
+
+esp_err_t sd_history_append(const char *path, const char *card_id, const sd_history_entry_t *entry,
+                            const sd_history_cmp_t *cmp)
+{
+    struct stat st;
+    bool exists = stat(path, &st) == 0;
+    FILE *f = fopen(path, "a");
+    if (f == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to open %s (errno: %d)", path, errno);
+        return ESP_FAIL;
+    }
+    if (!exists)
+    {
+        fprintf(f, "card,firmware,test,buf,size,runs,mean_mb,stdev_mb,flag\n");
+    }
+
+    char firmware[40];
+    const esp_app_desc_t *app = esp_ota_get_app_description();
+    snprintf(firmware, sizeof(firmware), "%s", app->version);
+    sanitize(firmware);
+
+    const char *flag = !cmp->has_baseline ? "new" : (cmp->regression ? "regress" : "ok");
+    fprintf(f, "%s,%s,%s,%u,%u,%d,%.3f,%.3f,%s\n", card_id, firmware, entry->test,
+            (unsigned)entry->buf_size, (unsigned)entry->file_size, entry->runs,
+            entry->mean_mb, entry->stdev_mb, flag);
+    fflush(f);
+    fsync(fileno(f));
+    return fclose(f) == 0 ? ESP_OK : ESP_FAIL;
+}
+
+/**
+ * @brief 用Welford算法累计一次运行的速度
+ */
+static void accumulate(sd_history_entry_t *e, float *m2, float speed_mb)
+{
+    e->runs++;
+    float delta = speed_mb - e->mean_mb;
+    e->mean_mb += delta / e->runs;
+    *m2 += delta * (speed_mb - e->mean_mb);
+    e->stdev_mb = e->runs > 1 ? sqrtf(*m2 / (e->runs - 1)) : 0;
+}
+
+void sd_history_bench_run(const sdmmc_card_t *card, int runs)
+{
+    ESP_LOGI(TAG, "Running %d write/read passes for benchmark history", runs);
+
+    sd_bench_params_t params = SD_BENCH_PARAMS_DEFAULT();
+    params.cold_read = false;
+    sd_history_entry_t entries[2];
+    float m2[2] = {0, 0};
+    memset(entries, 0, sizeof(entries));
+    strlcpy(entries[0].test, "write", sizeof(entries[0].test));
+    strlcpy(entries[1].test, "read", sizeof(entries[1].test));
+    for (int i = 0; i < 2; i++)
+    {
+        entries[i].buf_size = params.buf_size;
+        entries[i].file_size = params.file_size;
+    }
+
+    for (int i = 0; i < runs; i++)
+    {
+        sd_bench_result_t result;
+        if (sd_bench_write(&params, &result) != ESP_OK)
+        {
+            break;
+        }
+        accumulate(&entries[0], &m2[0], result.speed_mb);
+        if (sd_bench_read(&params, &result) == ESP_OK)
+        {
+            accumulate(&entries[1], &m2[1], result.speed_mb);
+        }
+        unlink(params.path);
+    }
+
+    char card_id[40];
+    sd_history_card_id(card, card_id, sizeof(card_id));
+    printf("\nBenchmark history (card %s, firmware %s, %s):\n", card_id,
+           esp_ota_get_app_description()->version, SD_HISTORY_PATH);
+    printf("  %-6s %5s %8s %8s %9s %8s %8s  %s\n", "test", "runs", "mean", "stdev", "baseline", "change", "t", "result");
+    for (int i = 0; i < 2; i++)
+    {
+        const sd_history_entry_t *e = &entries[i];
+        if (e->runs == 0)
+        {
+            printf("  %-6s failed\n", e->test);
+            continue;
+        }
+        sd_history_entry_t baseline;
+        bool found = sd_history_find_baseline(SD_HISTORY_PATH, card_id, e, &baseline) == ESP_OK;
+        sd_history_cmp_t cmp;
+        sd_history_compare(e, found ? &baseline : NULL, &cmp);
+
+        if (cmp.has_baseline)
+        {
+            printf("  %-6s %5d %8.2f %8.2f %9.2f %+7.1f%% %8.2f  %s\n", e->test, e->runs, e->mean_mb, e->stdev_mb,
+                   cmp.baseline_mb, cmp.change_pct, cmp.t, cmp.regression ? "REGRESSION" : "ok");
+        }
+        else
+        {
+            printf("  %-6s %5d %8.2f %8.2f %9s %8s %8s  %s\n", e->test, e->runs, e->mean_mb, e->stdev_mb,
+                   "-", "-", "-", "new baseline");
+        }
+        if (cmp.regression)
+        {
+            ESP_LOGW(TAG, "%s speed dropped %.1f%% against the previous baseline", e->test, -cmp.change_pct);
+        }
+        sd_history_append(SD_HISTORY_PATH, card_id, e, &cmp);
+    }
+    printf("\n");
+}
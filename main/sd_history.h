@@ -0,0 +1,108 @@
+/*
+ * 卡上测试历史记录与回归检测
+ *
+ * 每次测试把结果、固件版本和SD卡CID追加到卡上的CSV文件中。
+ * 下一次测试时，以同一张卡、同一项测试、相同参数的上一条正常记录为基线，
+ * 用Welch t检验判断速度下降是否显著，从而发现拖慢I/O路径的固件改动。
+ *
+ * 文件格式（每行一条记录）：
+ *   card,firmware,test,buf,size,runs,mean_mb,stdev_mb,flag
+ * flag为ok、regress或new（无基线），被标记为regress的记录不作为后续基线。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "sdmmc_cmd.h"
+#include "sd_mount.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 历史记录文件（未启用长文件名，文件名需符合8.3格式）
+#define SD_HISTORY_PATH MOUNT_POINT "/BENCHHST.CSV"
+
+// 速度下降低于该百分比时即使统计显著也不视为回归
+#define SD_HISTORY_MIN_CHANGE_PCT 3.0f
+
+/**
+ * @brief 一项测试多次运行的汇总
+ */
+typedef struct
+{
+    char test[12];    // 测试名称，例如"write"
+    size_t buf_size;  // 缓冲区大小
+    size_t file_size; // 文件大小
+    int runs;         // 运行次数
+    float mean_mb;    // 平均速度（MB/s）
+    float stdev_mb;   // 速度的样本标准差
+} sd_history_entry_t;
+
+/**
+ * @brief 与基线比较的结果
+ */
+typedef struct
+{
+    bool has_baseline; // 是否找到基线
+    float baseline_mb; // 基线平均速度
+    float change_pct;  // 相对基线的变化（负数表示变慢）
+    float t;           // Welch t统计量
+    bool regression;   // 是否为显著回归
+} sd_history_cmp_t;
+
+/**
+ * @brief 根据CID生成卡的标识，例如"03-5344-SD32G-1234ABCD"
+ *
+ * @param card SD卡
+ * @param out  输出缓冲区
+ * @param size 输出缓冲区大小（建议至少32字节）
+ */
+void sd_history_card_id(const sdmmc_card_t *card, char *out, size_t size);
+
+/**
+ * @brief 查找同一张卡、同一项测试、相同参数的最近一条非回归记录
+ *
+ * @param path     历史记录文件
+ * @param card_id  卡标识
+ * @param key      使用其中的test、buf_size和file_size
+ * @param baseline 输出的基线
+ * @return ESP_OK 找到，ESP_ERR_NOT_FOUND 没有基线（或文件不存在）
+ */
+esp_err_t sd_history_find_baseline(const char *path, const char *card_id, const sd_history_entry_t *key,
+                                   sd_history_entry_t *baseline);
+
+/**
+ * @brief 用单侧Welch t检验（显著性水平0.05）比较当前结果与基线
+ *
+ * 速度下降超过SD_HISTORY_MIN_CHANGE_PCT且统计显著时判定为回归。
+ *
+ * @param current  当前结果
+ * @param baseline 基线（为NULL表示没有基线）
+ * @param cmp      输出的比较结果
+ */
+void sd_history_compare(const sd_history_entry_t *current, const sd_history_entry_t *baseline,
+                        sd_history_cmp_t *cmp);
+
+/**
+ * @brief 追加一条记录（文件不存在时先写入表头），固件版本取自应用描述
+ *
+ * @return ESP_OK 成功，ESP_FAIL 写文件失败
+ */
+esp_err_t sd_history_append(const char *path, const char *card_id, const sd_history_entry_t *entry,
+                            const sd_history_cmp_t *cmp);
+
+/**
+ * @brief 运行runs次写入和读取测试，与历史基线比较并追加到历史记录
+ *
+ * @param card SD卡（已挂载到MOUNT_POINT）
+ * @param runs 每项测试的运行次数（至少2次才能做显著性检验）
+ */
+void sd_history_bench_run(const sdmmc_card_t *card, int runs);
+
+#ifdef __cplusplus
+}
+#endif
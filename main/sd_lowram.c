@@ -0,0 +1,196 @@
+/*
+ * FATFS内存占用与低内存配置实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <sys/unistd.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "ff.h"
+#include "sd_lowram.h"
+#include "sd_mem_stats.h"
+
+#define LOWRAM_BENCH_MAX_FILES 32          // 测试吞吐量时挂载的max_files
+#define LOWRAM_BENCH_TOTAL (512 * 1024)    // 每种配置写入的总字节数（平均分给所有文件）
+#define LOWRAM_BENCH_WRITE 256             // 每次fwrite的字节数，依次轮流写各个文件
+
+static const char *TAG = "sd_lowram";
+
+void sd_lowram_footprint(int max_files, sd_lowram_footprint_t *fp)
+{
+    fp->window_bytes = FF_MAX_SS;
+    fp->fatfs_bytes = sizeof(FATFS);
+    fp->fil_bytes = sizeof(FIL);
+    fp->per_file_cache = !FF_FS_TINY;
+    fp->mount_bytes = sizeof(FATFS) + (size_t)max_files * sizeof(FIL);
+}
+
+void sd_lowram_print_footprint(int max_files)
+{
+    sd_lowram_footprint_t fp;
+    sd_lowram_footprint(max_files, &fp);
+    printf("FATFS footprint: %u B sectors, FATFS %u B, FIL %u B (per-file cache %s), "
+           "%d files -> %u B per mount\n",
+           (unsigned)fp.window_bytes, (unsigned)fp.fatfs_bytes, (unsigned)fp.fil_bytes,
+           fp.per_file_cache ? "on" : "off", max_files, (unsigned)fp.mount_bytes);
+}
+
+/**
+ * @brief 以max_files挂载并返回挂载占用的内部RAM（字节），失败时返回0
+ */
+static size_t measure_mount(const sd_mount_params_t *params, int max_files)
+{
+    sd_mount_params_t p = *params;
+    p.max_files = max_files;
+    sd_mem_snapshot_t before;
+    sd_mem_snapshot_t after;
+    sd_mount_t mnt;
+    sd_mem_snapshot(&before);
+    if (sd_mount(&p, &mnt) != ESP_OK)
+    {
+        return 0;
+    }
+    sd_mem_snapshot(&after);
+    sd_unmount(&mnt);
+    return before.internal_free - after.internal_free;
+}
+
+/**
+ * @brief 打开nfiles个文件（stdio缓冲区为buf_size，0表示无缓冲），轮流写入
+ *
+ * @param file_bytes 输出：每个打开文件占用的内部RAM（FIL槽位之外）
+ * @param speed_mb   输出：写入速度（MB/s）
+ */
+static esp_err_t bench_files(int nfiles, size_t buf_size, size_t *file_bytes, float *speed_mb)
+{
+    static uint8_t data[LOWRAM_BENCH_WRITE];
+    memset(data, 0xA5, sizeof(data));
+    FILE *files[16] = {0};
+    char path[32];
+    esp_err_t ret = ESP_OK;
+
+    sd_mem_snapshot_t before;
+    sd_mem_snapshot_t after;
+    sd_mem_snapshot(&before);
+    for (int i = 0; i < nfiles && ret == ESP_OK; i++)
+    {
+        snprintf(path, sizeof(path), MOUNT_POINT "/LR%02d.BIN", i);
+        files[i] = fopen(path, "w");
+        if (files[i] == NULL)
+        {
+            ESP_LOGE(TAG, "Failed to open %s", path);
+            ret = ESP_FAIL;
+            break;
+        }
+        if (buf_size == 0)
+        {
+            setvbuf(files[i], NULL, _IONBF, 0);
+        }
+        else
+        {
+            setvbuf(files[i], NULL, _IOFBF, buf_size);
+        }
+    }
+
+    int64_t start = esp_timer_get_time();
+    size_t writes = LOWRAM_BENCH_TOTAL / LOWRAM_BENCH_WRITE;
+    for (size_t n = 0; n < writes && ret == ESP_OK; n++)
+    {
+        if (fwrite(data, 1, sizeof(data), files[n % nfiles]) != sizeof(data))
+        {
+            ret = ESP_FAIL;
+        }
+        if (n + 1 == (size_t)nfiles)
+        {
+            // 每个文件都写过一次后stdio缓冲区已分配，此时的占用即打开文件的开销
+            sd_mem_snapshot(&after);
+        }
+    }
+    for (int i = 0; i < nfiles; i++)
+    {
+        if (files[i] != NULL && fclose(files[i]) != 0)
+        {
+            ret = ESP_FAIL;
+        }
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+
+    for (int i = 0; i < nfiles; i++)
+    {
+        snprintf(path, sizeof(path), MOUNT_POINT "/LR%02d.BIN", i);
+        unlink(path);
+    }
+    if (ret == ESP_OK)
+    {
+        *file_bytes = (before.internal_free - after.internal_free) / nfiles;
+        *speed_mb = (LOWRAM_BENCH_TOTAL / (1024.0f * 1024.0f)) / (elapsed / 1000000.0f);
+    }
+    return ret;
+}
+
+void sd_lowram_bench_run(const sd_mount_params_t *params)
+{
+    printf("\n");
+    sd_lowram_print_footprint(LOWRAM_BENCH_MAX_FILES);
+
+    printf("\nMount RAM vs max_files (internal heap):\n");
+    printf("  %-10s %10s %12s %12s\n", "max_files", "mount KB", "estimate KB", "per slot B");
+    size_t base = measure_mount(params, 1);
+    static const int counts[] = {1, 5, 16, 32};
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+    {
+        size_t bytes = counts[i] == 1 ? base : measure_mount(params, counts[i]);
+        sd_lowram_footprint_t fp;
+        sd_lowram_footprint(counts[i], &fp);
+        if (bytes == 0)
+        {
+            printf("  %-10d mount failed\n", counts[i]);
+            continue;
+        }
+        // 与max_files为1时的差值即每个FIL槽位的实际占用
+        char per_slot[12] = "-";
+        if (counts[i] > 1 && base != 0)
+        {
+            snprintf(per_slot, sizeof(per_slot), "%d", (int)(bytes - base) / (counts[i] - 1));
+        }
+        printf("  %-10d %10.1f %12.1f %12s\n", counts[i], bytes / 1024.0, fp.mount_bytes / 1024.0, per_slot);
+    }
+
+    sd_mount_params_t p = *params;
+    p.max_files = LOWRAM_BENCH_MAX_FILES;
+    sd_mount_t mnt;
+    if (sd_mount(&p, &mnt) != ESP_OK)
+    {
+        return;
+    }
+    sd_lowram_footprint_t fp;
+    sd_lowram_footprint(LOWRAM_BENCH_MAX_FILES, &fp);
+
+    printf("\nInterleaved %d B writes, %u KB total (max_files %d):\n", LOWRAM_BENCH_WRITE,
+           (unsigned)(LOWRAM_BENCH_TOTAL / 1024), LOWRAM_BENCH_MAX_FILES);
+    printf("  %-6s %10s %12s %12s %8s\n", "files", "stdio buf", "B per file", "total KB", "MB/s");
+    static const int nfiles[] = {1, 4, 16};
+    static const size_t bufs[] = {0, 512, 4096};
+    for (size_t i = 0; i < sizeof(nfiles) / sizeof(nfiles[0]); i++)
+    {
+        for (size_t j = 0; j < sizeof(bufs) / sizeof(bufs[0]); j++)
+        {
+            size_t file_bytes = 0;
+            float speed = 0;
+            if (bench_files(nfiles[i], bufs[j], &file_bytes, &speed) != ESP_OK)
+            {
+                printf("  %-6d %10u failed\n", nfiles[i], (unsigned)bufs[j]);
+                continue;
+            }
+            // 总占用：FATFS对象、打开文件使用的FIL槽位和每个打开文件的stdio开销
+            size_t total = fp.fatfs_bytes + nfiles[i] * (fp.fil_bytes + file_bytes);
+            printf("  %-6d %10u %12u %12.1f %8.2f\n", nfiles[i], (unsigned)bufs[j], (unsigned)file_bytes,
+                   total / 1024.0, speed);
+        }
+    }
+    printf("\n");
+    sd_unmount(&mnt);
+}
@@ -0,0 +1,60 @@
+/*
+ * FATFS内存占用与低内存配置
+ *
+ * ESP-IDF v4.4中FATFS的内存占用主要来自：
+ * - 每次挂载：FATFS对象（含一个FF_MAX_SS字节的扇区窗口）和max_files个FIL，
+ *   挂载时一次性分配，与实际打开的文件数无关
+ * - 每个FIL：启用CONFIG_FATFS_PER_FILE_CACHE时含一个FF_MAX_SS字节的每文件扇区缓存
+ * - 每个打开的文件：newlib的FILE结构和stdio缓冲区（可用setvbuf调整或关闭）
+ *
+ * FF_MAX_SS跟随CONFIG_WL_SECTOR_SIZE，默认4096，而SD卡扇区只有512字节。
+ * 项目根目录下的sdkconfig.lowram关闭每文件缓存（所有文件共用卷的扇区窗口，即FatFs的
+ * FF_FS_TINY）并把扇区大小改为512，此时每个FIL只有几十字节，max_files可以设得很大。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "sd_mount.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 按当前编译配置估算的FATFS内存占用
+ */
+typedef struct
+{
+    size_t window_bytes;   // 扇区窗口/每文件缓存的大小（FF_MAX_SS）
+    size_t fatfs_bytes;    // FATFS对象大小（每次挂载一个）
+    size_t fil_bytes;      // FIL对象大小（每个max_files槽位一个）
+    bool per_file_cache;   // FIL中是否含每文件扇区缓存
+    size_t mount_bytes;    // 每次挂载的FATFS部分：FATFS + max_files个FIL
+} sd_lowram_footprint_t;
+
+/**
+ * @brief 估算以max_files挂载时的FATFS内存占用
+ */
+void sd_lowram_footprint(int max_files, sd_lowram_footprint_t *fp);
+
+/**
+ * @brief 打印当前编译配置下的FATFS内存占用
+ */
+void sd_lowram_print_footprint(int max_files);
+
+/**
+ * @brief 测量不同max_files下挂载占用的内部RAM，以及不同打开文件数和stdio缓冲区大小下的
+ *        写入吞吐量与内存占用
+ *
+ * 需要反复挂载，必须在主挂载卸载后调用。
+ *
+ * @param params 挂载参数（max_files由测试设置）
+ */
+void sd_lowram_bench_run(const sd_mount_params_t *params);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,69 @@
+/*
+ * 内存使用统计实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <stdio.h>
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sd_mem_stats.h"
+
+#define MIN_OF(a, b) ((a) < (b) ? (a) : (b))
+
+void sd_mem_snapshot(sd_mem_snapshot_t *snap)
+{
+    snap->internal_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    snap->internal_largest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    snap->dma_free = heap_caps_get_free_size(MALLOC_CAP_DMA);
+    snap->dma_largest = heap_caps_get_largest_free_block(MALLOC_CAP_DMA);
+    snap->psram_free = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    snap->psram_largest = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+    // ESP-IDF中栈以字节为单位，返回值即剩余字节数
+    snap->stack_free = uxTaskGetStackHighWaterMark(NULL);
+}
+
+void sd_mem_track_begin(sd_mem_usage_t *usage)
+{
+    sd_mem_snapshot(&usage->before);
+    usage->during = usage->before;
+    usage->after = usage->before;
+}
+
+void sd_mem_track_sample(sd_mem_usage_t *usage)
+{
+    sd_mem_snapshot_t now;
+    sd_mem_snapshot(&now);
+    sd_mem_snapshot_t *d = &usage->during;
+    d->internal_free = MIN_OF(d->internal_free, now.internal_free);
+    d->internal_largest = MIN_OF(d->internal_largest, now.internal_largest);
+    d->dma_free = MIN_OF(d->dma_free, now.dma_free);
+    d->dma_largest = MIN_OF(d->dma_largest, now.dma_largest);
+    d->psram_free = MIN_OF(d->psram_free, now.psram_free);
+    d->psram_largest = MIN_OF(d->psram_largest, now.psram_largest);
+    d->stack_free = MIN_OF(d->stack_free, now.stack_free);
+}
+
+void sd_mem_track_end(sd_mem_usage_t *usage)
+{
+    sd_mem_snapshot(&usage->after);
+}
+
+void sd_mem_print(const char *label, const sd_mem_usage_t *usage)
+{
+    const sd_mem_snapshot_t *s[3] = {&usage->before, &usage->during, &usage->after};
+    const char *phase[3] = {"before", "during", "after"};
+
+    printf("%s memory (bytes):\n", label);
+    printf("  %-7s %10s %10s %10s %10s %10s %10s %8s\n", "phase",
+           "int free", "int blk", "dma free", "dma blk", "psram", "psram blk", "stack");
+    for (int i = 0; i < 3; i++)
+    {
+        printf("  %-7s %10u %10u %10u %10u %10u %10u %8u\n", phase[i],
+               (unsigned)s[i]->internal_free, (unsigned)s[i]->internal_largest,
+               (unsigned)s[i]->dma_free, (unsigned)s[i]->dma_largest,
+               (unsigned)s[i]->psram_free, (unsigned)s[i]->psram_largest,
+               (unsigned)s[i]->stack_free);
+    }
+}
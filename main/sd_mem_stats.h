@@ -0,0 +1,78 @@
+/*
+ * 内存使用统计
+ *
+ * 在测试前、测试中和测试后记录内部RAM、DMA可用内存、PSRAM的空闲量、
+ * 最大空闲块以及当前任务栈的高水位，用于确定I/O缓冲区大小。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 某一时刻的内存快照
+ */
+typedef struct
+{
+    size_t internal_free;    // 内部RAM空闲字节数
+    size_t internal_largest; // 内部RAM最大空闲块
+    size_t dma_free;         // DMA可用内存空闲字节数
+    size_t dma_largest;      // DMA可用内存最大空闲块
+    size_t psram_free;       // PSRAM空闲字节数（未启用PSRAM时为0）
+    size_t psram_largest;    // PSRAM最大空闲块
+    uint32_t stack_free;     // 当前任务栈高水位（历史最少剩余字节数）
+} sd_mem_snapshot_t;
+
+/**
+ * @brief 一次测试的内存使用情况
+ *
+ * during记录测试过程中各项的最小值（即内存最紧张时的状态）。
+ */
+typedef struct
+{
+    sd_mem_snapshot_t before; // 测试开始前
+    sd_mem_snapshot_t during; // 测试过程中的最小值
+    sd_mem_snapshot_t after;  // 测试结束后（缓冲区已释放）
+} sd_mem_usage_t;
+
+/**
+ * @brief 获取当前内存快照
+ *
+ * @param snap 输出的快照
+ */
+void sd_mem_snapshot(sd_mem_snapshot_t *snap);
+
+/**
+ * @brief 开始跟踪：记录before，并以其初始化during
+ */
+void sd_mem_track_begin(sd_mem_usage_t *usage);
+
+/**
+ * @brief 测试过程中采样一次，更新during中的最小值
+ *
+ * 开销为几次堆统计调用（需要遍历堆），应在计时区间之外调用，如计时开始前和结束后。
+ */
+void sd_mem_track_sample(sd_mem_usage_t *usage);
+
+/**
+ * @brief 结束跟踪：记录after
+ */
+void sd_mem_track_end(sd_mem_usage_t *usage);
+
+/**
+ * @brief 以表格形式打印一次测试的内存使用情况
+ *
+ * @param label 测试名称
+ * @param usage 内存使用情况
+ */
+void sd_mem_print(const char *label, const sd_mem_usage_t *usage);
+
+#ifdef __cplusplus
+}
+#endif
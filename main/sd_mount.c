@@ -0,0 +1,345 @@
+/*
+ * SD卡挂载接口实现
+ *
+ * 支持两种挂载路径：
+ * 1. SDMMC外设：1线或4线SD模式，GPIO可通过menuconfig配置
+ * 2. SDSPI：使用SPI外设与SD卡通信，SPI总线启用DMA传输
+ *
+ * 注意：SD卡一旦进入SPI模式，只能通过重新上电退回SD模式。
+ * 因此在同一次启动中对比多种总线时，SDSPI必须放在最后测试。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_vfs_fat.h"
+#include "sdmmc_cmd.h"
+#include "driver/sdmmc_host.h"
+#include "driver/sdspi_host.h"
+#include "driver/spi_common.h"
+#include "sd_mount.h"
+#include "sd_boottime.h"
+
+// SPI总线单次DMA传输的最大字节数（需大于一个512字节扇区加上命令和令牌开销）
+#define SDSPI_MAX_TRANSFER_SIZE (4 * 1024)
+
+// 根据menuconfig决定编译哪些挂载路径（对应的GPIO配置项只在启用时存在）
+#if defined(CONFIG_EXAMPLE_SD_INTERFACE_SDMMC)
+#define SD_MOUNT_HAS_SDMMC 1
+#endif
+#if defined(CONFIG_EXAMPLE_SD_INTERFACE_SDSPI) || defined(CONFIG_EXAMPLE_BENCH_COMPARE_BUSES)
+#define SD_MOUNT_HAS_SDSPI 1
+#endif
+
+static const char *TAG = "sd_mount";
+
+void sd_mount_default_params(sd_mount_params_t *params)
+{
+    memset(params, 0, sizeof(*params));
+#ifdef CONFIG_EXAMPLE_SD_INTERFACE_SDSPI
+    params->bus = SD_BUS_SDSPI;
+    params->max_freq_khz = CONFIG_EXAMPLE_SDSPI_MAX_FREQ_KHZ;
+#else
+    params->bus = SD_BUS_SDMMC;
+    params->max_freq_khz = CONFIG_EXAMPLE_SDMMC_MAX_FREQ_KHZ;
+#endif
+#ifdef CONFIG_EXAMPLE_SDMMC_BUS_WIDTH_4
+    params->width = 4;
+#else
+    params->width = 1;
+#endif
+    params->max_files = CONFIG_EXAMPLE_MAX_OPEN_FILES; // 最大同时打开文件数
+#ifdef CONFIG_EXAMPLE_FORMAT_IF_MOUNT_FAILED
+    params->format_if_mount_failed = true; // 挂载失败时格式化SD卡
+#else
+    params->format_if_mount_failed = false; // 挂载失败时不格式化SD卡
+#endif
+#ifdef CONFIG_EXAMPLE_FAST_CARD_INIT
+    params->fast_init = true; // 缩短卡初始化时间
+#endif
+}
+
+const char *sd_mount_bus_name(const sd_mount_params_t *params)
+{
+    if (params->bus == SD_BUS_SDSPI)
+    {
+        return "SDSPI";
+    }
+    return params->width == 4 ? "SDMMC 4-bit" : "SDMMC 1-bit";
+}
+
+/**
+ * @brief 释放主机（SDMMC外设或SDSPI设备），与esp_vfs_fat_sdcard_unmount的处理相同
+ */
+static void host_deinit(const sdmmc_host_t *host)
+{
+    if (host->flags & SDMMC_HOST_FLAG_DEINIT_ARG)
+    {
+        host->deinit_p(host->slot);
+    }
+    else
+    {
+        host->deinit();
+    }
+}
+
+/**
+ * @brief 在已初始化的主机上初始化SD卡，不挂载文件系统
+ */
+static esp_err_t attach_card(const sdmmc_host_t *host, sd_mount_t *mnt)
+{
+    sdmmc_card_t *card = malloc(sizeof(sdmmc_card_t));
+    if (card == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = sdmmc_card_init(host, card);
+    if (ret != ESP_OK)
+    {
+        free(card);
+        return ret;
+    }
+    mnt->card = card;
+    mnt->raw = true;
+    return ESP_OK;
+}
+
+#ifdef SD_MOUNT_HAS_SDMMC
+/**
+ * @brief 使用SDMMC外设初始化SD卡并挂载文件系统
+ *
+ * mount_config为NULL时只初始化SD卡，不挂载文件系统
+ */
+static esp_err_t mount_sdmmc(const sd_mount_params_t *params,
+                             const esp_vfs_fat_sdmmc_mount_config_t *mount_config,
+                             sd_mount_t *mnt)
+{
+    ESP_LOGI(TAG, "SDMMC host: %d-bit, max %d kHz", params->width, params->max_freq_khz);
+
+#ifndef CONFIG_EXAMPLE_SDMMC_BUS_WIDTH_4
+    if (params->width == 4)
+    {
+        // D1~D3引脚只在menuconfig选择4线模式时才会配置
+        ESP_LOGE(TAG, "4-bit mode requires EXAMPLE_SDMMC_BUS_WIDTH_4 (D1-D3 pins are not configured)");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+#endif
+
+    // 获取SDMMC主机默认配置
+    sdmmc_host_t host = SDMMC_HOST_DEFAULT();
+    host.max_freq_khz = params->max_freq_khz;
+    sd_boottime_hook(&host); // 按命令记录各初始化阶段的耗时
+
+    // 初始化SD卡插槽配置，这里不使用卡检测(CD)和写保护(WP)信号
+    // 如果您的开发板上有这些信号，请修改slot_config.gpio_cd和slot_config.gpio_wp
+    sdmmc_slot_config_t slot_config = SDMMC_SLOT_CONFIG_DEFAULT();
+    slot_config.width = params->width;
+
+    // 在支持配置SD卡GPIO的芯片上（如ESP32S3），
+    // 在slot_config结构体中设置这些引脚：
+#ifdef CONFIG_IDF_TARGET_ESP32S3
+    slot_config.clk = CONFIG_EXAMPLE_PIN_CLK; // 时钟信号引脚
+    slot_config.cmd = CONFIG_EXAMPLE_PIN_CMD; // 命令信号引脚
+    slot_config.d0 = CONFIG_EXAMPLE_PIN_D0;   // 数据线0引脚
+#ifdef CONFIG_EXAMPLE_SDMMC_BUS_WIDTH_4
+    slot_config.d1 = CONFIG_EXAMPLE_PIN_D1; // 数据线1引脚
+    slot_config.d2 = CONFIG_EXAMPLE_PIN_D2; // 数据线2引脚
+    slot_config.d3 = CONFIG_EXAMPLE_PIN_D3; // 数据线3引脚
+#endif                                      // CONFIG_EXAMPLE_SDMMC_BUS_WIDTH_4
+#endif                                      // CONFIG_IDF_TARGET_ESP32S3
+
+    // 在使能的引脚上启用内部上拉电阻
+    // 但是内部上拉电阻的强度不够，请确保在总线上
+    // 连接10k的外部上拉电阻。这仅用于调试/示例目的。
+    slot_config.flags |= SDMMC_SLOT_FLAG_INTERNAL_PULLUP;
+
+    if (mount_config == NULL)
+    {
+        esp_err_t ret = host.init();
+        if (ret != ESP_OK)
+        {
+            return ret;
+        }
+        ret = sdmmc_host_init_slot(host.slot, &slot_config);
+        if (ret == ESP_OK)
+        {
+            ret = attach_card(&host, mnt);
+        }
+        if (ret != ESP_OK)
+        {
+            host_deinit(&host);
+        }
+        return ret;
+    }
+    return esp_vfs_fat_sdmmc_mount(MOUNT_POINT, &host, &slot_config, mount_config, &mnt->card);
+}
+#endif // SD_MOUNT_HAS_SDMMC
+
+#ifdef SD_MOUNT_HAS_SDSPI
+/**
+ * @brief 使用SPI外设初始化SD卡并挂载文件系统
+ *
+ * SPI总线使用SPI_DMA_CH_AUTO自动分配DMA通道，
+ * 数据块通过DMA传输，缓冲区应使用MALLOC_CAP_DMA分配以避免额外拷贝。
+ * mount_config为NULL时只初始化SD卡，不挂载文件系统
+ */
+static esp_err_t mount_sdspi(const sd_mount_params_t *params,
+                             const esp_vfs_fat_sdmmc_mount_config_t *mount_config,
+                             sd_mount_t *mnt)
+{
+    ESP_LOGI(TAG, "SDSPI host: max %d kHz, DMA enabled", params->max_freq_khz);
+
+    sdmmc_host_t host = SDSPI_HOST_DEFAULT();
+    host.max_freq_khz = params->max_freq_khz;
+    sd_boottime_hook(&host); // 按命令记录各初始化阶段的耗时
+
+    spi_bus_config_t bus_cfg = {
+        .mosi_io_num = CONFIG_EXAMPLE_PIN_SPI_MOSI,
+        .miso_io_num = CONFIG_EXAMPLE_PIN_SPI_MISO,
+        .sclk_io_num = CONFIG_EXAMPLE_PIN_SPI_CLK,
+        .quadwp_io_num = -1,
+        .quadhd_io_num = -1,
+        .max_transfer_sz = SDSPI_MAX_TRANSFER_SIZE,
+    };
+    esp_err_t ret = spi_bus_initialize((spi_host_device_t)host.slot, &bus_cfg, SPI_DMA_CH_AUTO);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to initialize SPI bus (%s)", esp_err_to_name(ret));
+        return ret;
+    }
+    mnt->spi_host = host.slot;
+
+    // 不使用卡检测(CD)和写保护(WP)信号
+    sdspi_device_config_t slot_config = SDSPI_DEVICE_CONFIG_DEFAULT();
+    slot_config.gpio_cs = CONFIG_EXAMPLE_PIN_SPI_CS;
+    slot_config.host_id = (spi_host_device_t)host.slot;
+
+    if (mount_config == NULL)
+    {
+        sdspi_dev_handle_t handle;
+        ret = host.init();
+        if (ret == ESP_OK)
+        {
+            ret = sdspi_host_init_device(&slot_config, &handle);
+        }
+        if (ret == ESP_OK)
+        {
+            host.slot = handle;
+            ret = attach_card(&host, mnt);
+            if (ret != ESP_OK)
+            {
+                host_deinit(&host);
+            }
+        }
+    }
+    else
+    {
+        ret = esp_vfs_fat_sdspi_mount(MOUNT_POINT, &host, &slot_config, mount_config, &mnt->card);
+    }
+    if (ret != ESP_OK)
+    {
+        spi_bus_free((spi_host_device_t)mnt->spi_host);
+        mnt->spi_host = -1;
+    }
+    return ret;
+}
+#endif // SD_MOUNT_HAS_SDSPI
+
+/**
+ * @brief sd_mount和sd_mount_raw的公共部分，mount_config为NULL时不挂载文件系统
+ */
+static esp_err_t mount_card(const sd_mount_params_t *params,
+                            const esp_vfs_fat_sdmmc_mount_config_t *mount_config,
+                            sd_mount_t *mnt)
+{
+    memset(mnt, 0, sizeof(*mnt));
+    mnt->params = *params;
+    mnt->spi_host = -1;
+    sd_boottime_begin(params->fast_init);
+
+    // 注意：esp_vfs_fat_sdmmc/sdspi_mount是集成了所有功能的便捷函数
+    // 在开发生产应用时，请查看其源代码并实现错误恢复机制
+    esp_err_t ret = ESP_ERR_NOT_SUPPORTED;
+    if (params->bus == SD_BUS_SDSPI)
+    {
+#ifdef SD_MOUNT_HAS_SDSPI
+        ret = mount_sdspi(params, mount_config, mnt);
+#else
+        ESP_LOGE(TAG, "SDSPI support is not enabled in menuconfig");
+#endif
+    }
+    else
+    {
+#ifdef SD_MOUNT_HAS_SDMMC
+        ret = mount_sdmmc(params, mount_config, mnt);
+#else
+        ESP_LOGE(TAG, "SDMMC support is not enabled in menuconfig");
+#endif
+    }
+
+    if (ret != ESP_OK) // 如果挂载失败
+    {
+        if (ret == ESP_FAIL) // 如果是文件系统挂载失败
+        {
+            ESP_LOGE(TAG, "Failed to mount filesystem. "
+                          "If you want the card to be formatted, set the EXAMPLE_FORMAT_IF_MOUNT_FAILED menuconfig option.");
+        }
+        else // 如果是其他错误（如硬件初始化失败）
+        {
+            ESP_LOGE(TAG, "Failed to initialize the card (%s). "
+                          "Make sure SD card lines have pull-up resistors in place.",
+                     esp_err_to_name(ret));
+        }
+        mnt->card = NULL;
+    }
+    sd_boottime_end(mnt->card);
+    return ret;
+}
+
+esp_err_t sd_mount(const sd_mount_params_t *params, sd_mount_t *mnt)
+{
+    // 文件系统挂载配置选项
+    // 如果format_if_mount_failed设置为true，则在挂载失败时
+    // 会对SD卡进行分区和格式化操作
+    esp_vfs_fat_sdmmc_mount_config_t mount_config = {
+        .format_if_mount_failed = params->format_if_mount_failed,
+        .max_files = params->max_files,
+        .allocation_unit_size = SD_MOUNT_ALLOCATION_UNIT_SIZE};
+
+    return mount_card(params, &mount_config, mnt);
+}
+
+esp_err_t sd_mount_raw(const sd_mount_params_t *params, sd_mount_t *mnt)
+{
+    return mount_card(params, NULL, mnt);
+}
+
+esp_err_t sd_unmount(sd_mount_t *mnt)
+{
+    if (mnt->card == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // 注意：SDSPI挂载后card->host.slot保存的是设备句柄而不是SPI主机号，
+    // 因此使用挂载时记录的spi_host释放总线
+    esp_err_t ret = ESP_OK;
+    if (mnt->raw)
+    {
+        host_deinit(&mnt->card->host);
+        free(mnt->card);
+    }
+    else
+    {
+        ret = esp_vfs_fat_sdcard_unmount(MOUNT_POINT, mnt->card);
+    }
+    mnt->card = NULL;
+    mnt->raw = false;
+    if (mnt->spi_host >= 0)
+    {
+        spi_bus_free((spi_host_device_t)mnt->spi_host);
+        mnt->spi_host = -1;
+    }
+    return ret;
+}
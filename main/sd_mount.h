@@ -0,0 +1,107 @@
+/*
+ * SD卡挂载接口
+ *
+ * 封装SDMMC外设和SPI外设（SDSPI）两种挂载路径，使测试代码
+ * 可以在运行时选择总线类型、总线宽度和时钟频率。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stdbool.h>
+#include "esp_err.h"
+#include "sdmmc_cmd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 定义SD卡在虚拟文件系统中的挂载点
+#define MOUNT_POINT "/sdcard"
+
+// FAT文件系统分配单元大小(32KB，优化文件系统性能)，格式化时使用
+#define SD_MOUNT_ALLOCATION_UNIT_SIZE (32 * 1024)
+
+/**
+ * @brief SD卡总线类型
+ */
+typedef enum
+{
+    SD_BUS_SDMMC = 0, // SDMMC外设（1线或4线SD模式）
+    SD_BUS_SDSPI,     // SPI外设（SD卡SPI模式）
+} sd_bus_t;
+
+/**
+ * @brief 挂载参数
+ */
+typedef struct
+{
+    sd_bus_t bus;                // 总线类型
+    int width;                   // SDMMC总线宽度（1或4），SDSPI忽略此项
+    int max_freq_khz;            // 最大时钟频率（kHz）
+    int max_files;               // 最大同时打开文件数
+    bool format_if_mount_failed; // 挂载失败时是否格式化
+    bool fast_init;              // 快速初始化：缩短ACMD41轮询间隔，已知的存储卡跳过SDIO探测
+} sd_mount_params_t;
+
+/**
+ * @brief 挂载状态
+ */
+typedef struct
+{
+    sd_mount_params_t params; // 实际使用的挂载参数
+    sdmmc_card_t *card;       // 挂载成功后的SD卡信息
+    int spi_host;             // 由本模块初始化的SPI总线编号（卸载时释放），-1表示无
+    bool raw;                 // 只初始化了SD卡，未挂载文件系统（sd_mount_raw）
+} sd_mount_t;
+
+/**
+ * @brief 根据menuconfig配置填充默认挂载参数
+ *
+ * @param params 输出的挂载参数
+ */
+void sd_mount_default_params(sd_mount_params_t *params);
+
+/**
+ * @brief 初始化SD卡并挂载FAT文件系统到MOUNT_POINT
+ *
+ * @param params 挂载参数
+ * @param mnt    输出的挂载状态，卸载时传给sd_unmount
+ * @return
+ *  - ESP_OK 挂载成功
+ *  - ESP_FAIL 文件系统挂载失败
+ *  - 其他错误码 SD卡或总线初始化失败
+ */
+esp_err_t sd_mount(const sd_mount_params_t *params, sd_mount_t *mnt);
+
+/**
+ * @brief 只初始化总线和SD卡，不挂载文件系统
+ *
+ * 用于需要自行注册FATFS驱动器或直接访问扇区的场景。
+ * mnt->card由本模块分配，同样使用sd_unmount释放。
+ *
+ * @param params 挂载参数（忽略max_files和format_if_mount_failed）
+ * @param mnt    输出的挂载状态
+ * @return ESP_OK 成功，其他错误码表示SD卡或总线初始化失败
+ */
+esp_err_t sd_mount_raw(const sd_mount_params_t *params, sd_mount_t *mnt);
+
+/**
+ * @brief 卸载文件系统并释放总线
+ *
+ * @param mnt sd_mount输出的挂载状态
+ * @return ESP_OK 成功，其他错误码表示卸载失败
+ */
+esp_err_t sd_unmount(sd_mount_t *mnt);
+
+/**
+ * @brief 获取挂载参数对应的可读总线名称，例如"SDMMC 4-bit"
+ *
+ * @param params 挂载参数
+ * @return 静态字符串
+ */
+const char *sd_mount_bus_name(const sd_mount_params_t *params);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,745 @@
+/*
+ * 单文件多路复用流容器实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_rom_crc.h"
+#include "diskio_sdmmc.h"
+#include "sd_mux.h"
+
+#define MUX_CHUNK_MAGIC 0x4B484358u       // "XCHK"
+#define MUX_TRAILER_MAGIC 0x4C525458u     // "XTRL"
+#define MUX_INDEX_STREAM 0xFFFF           // 索引块使用的流号
+#define MUX_NO_INDEX UINT32_MAX           // 没有上一个索引块
+#define MUX_BENCH_NAME "MUX.BIN"          // 测试容器文件
+#define MUX_BENCH_STREAMS 8               // 测试流数
+#define MUX_BENCH_BYTES (4 * 1024 * 1024) // 所有流写入的总字节数
+#define MUX_BENCH_MIN_CHUNK 256           // 流0的块大小，其他流依次加倍（四档循环）
+#define MUX_BENCH_READ_SIZE (16 * 1024)   // 从单独文件读取时每次读取的字节数
+
+static const char *TAG = "sd_mux";
+
+/**
+ * @brief 块头，位于每个块（数据块、索引块）的开头
+ */
+typedef struct
+{
+    uint32_t magic;    // MUX_CHUNK_MAGIC
+    uint16_t stream;   // 流号，索引块为MUX_INDEX_STREAM
+    uint16_t reserved; // 保留，为0
+    uint32_t seq;      // 该流中的序号（索引块为索引块的序号）
+    uint32_t len;      // 块头之后的数据长度
+    uint32_t crc;      // 块头（crc为0时）和数据的CRC32
+} mux_chunk_t;
+
+/**
+ * @brief 索引项
+ */
+typedef struct sd_mux_entry
+{
+    uint16_t stream;   // 流号
+    uint16_t reserved; // 保留，为0
+    uint32_t seq;      // 该流中的序号
+    uint32_t offset;   // 块头在文件中的偏移
+    uint32_t len;      // 数据长度
+} mux_entry_t;
+
+/**
+ * @brief 索引块数据的开头，后接count个索引项
+ */
+typedef struct
+{
+    uint32_t prev;  // 上一个索引块的偏移，没有时为MUX_NO_INDEX
+    uint32_t count; // 索引项数
+} mux_index_t;
+
+/**
+ * @brief 文件尾部
+ */
+typedef struct
+{
+    uint32_t magic;       // MUX_TRAILER_MAGIC
+    uint32_t last_index;  // 最后一个索引块的偏移，没有时为MUX_NO_INDEX
+    uint32_t index_count; // 索引块数
+    uint32_t crc;         // 以上字段的CRC32
+} mux_trailer_t;
+
+static uint32_t chunk_crc(const mux_chunk_t *hdr, const void *d1, size_t l1, const void *d2, size_t l2)
+{
+    mux_chunk_t h = *hdr;
+    h.crc = 0;
+    uint32_t crc = esp_rom_crc32_le(0, (const uint8_t *)&h, sizeof(h));
+    crc = esp_rom_crc32_le(crc, d1, l1);
+    return l2 > 0 ? esp_rom_crc32_le(crc, d2, l2) : crc;
+}
+
+/**
+ * @brief 写出写缓冲区中的数据，下一次填充到下一个对齐位置为止
+ */
+static esp_err_t flush_buffer(sd_mux_t *m)
+{
+    if (m->used == 0)
+    {
+        return ESP_OK;
+    }
+    UINT bw;
+    FRESULT res = f_write(&m->fil, m->buf, m->used, &bw);
+    if (res != FR_OK || bw != m->used)
+    {
+        ESP_LOGE(TAG, "Write of %u bytes failed (%d)", (unsigned)m->used, res);
+        return ESP_FAIL;
+    }
+    m->written += m->used;
+    m->used = 0;
+    m->cap = SD_MUX_BUF_SIZE - m->written % SD_MUX_BUF_SIZE;
+    return ESP_OK;
+}
+
+static esp_err_t put(sd_mux_t *m, const void *data, size_t len)
+{
+    const uint8_t *src = data;
+    while (len > 0)
+    {
+        size_t n = m->cap - m->used;
+        if (n > len)
+        {
+            n = len;
+        }
+        memcpy(m->buf + m->used, src, n);
+        m->used += n;
+        src += n;
+        len -= n;
+        if (m->used == m->cap && flush_buffer(m) != ESP_OK)
+        {
+            return ESP_FAIL;
+        }
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 追加一个块，数据由两段组成（第二段可以为空）
+ */
+static esp_err_t put_chunk(sd_mux_t *m, uint16_t stream, uint32_t seq, const void *d1, size_t l1,
+                           const void *d2, size_t l2)
+{
+    mux_chunk_t hdr = {
+        .magic = MUX_CHUNK_MAGIC,
+        .stream = stream,
+        .seq = seq,
+        .len = l1 + l2,
+    };
+    hdr.crc = chunk_crc(&hdr, d1, l1, d2, l2);
+    if (put(m, &hdr, sizeof(hdr)) != ESP_OK || put(m, d1, l1) != ESP_OK || put(m, d2, l2) != ESP_OK)
+    {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 为上一个索引块之后写入的块追加一个索引块
+ */
+static esp_err_t write_index(sd_mux_t *m)
+{
+    if (m->entry_count == 0)
+    {
+        return ESP_OK;
+    }
+    uint32_t offset = m->written + m->used;
+    mux_index_t idx = {.prev = m->last_index, .count = m->entry_count};
+    if (put_chunk(m, MUX_INDEX_STREAM, m->index_chunks, &idx, sizeof(idx), m->entries,
+                  m->entry_count * sizeof(mux_entry_t)) != ESP_OK)
+    {
+        return ESP_FAIL;
+    }
+    m->last_index = offset;
+    m->entry_count = 0;
+    m->index_chunks++;
+    return ESP_OK;
+}
+
+esp_err_t sd_mux_open(sd_mux_t *m, sdmmc_card_t *card, const char *name)
+{
+    memset(m, 0, sizeof(*m));
+    BYTE pdrv = ff_diskio_get_pdrv_card(card);
+    if (pdrv == 0xFF)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    char path[24];
+    snprintf(path, sizeof(path), "%d:/%s", pdrv, name);
+    m->buf = heap_caps_malloc(SD_MUX_BUF_SIZE, MALLOC_CAP_DMA);
+    m->entries = malloc(SD_MUX_INDEX_INTERVAL * sizeof(mux_entry_t));
+    if (m->buf == NULL || m->entries == NULL)
+    {
+        free(m->buf);
+        free(m->entries);
+        m->buf = NULL;
+        m->entries = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    FRESULT res = f_open(&m->fil, path, FA_CREATE_ALWAYS | FA_WRITE);
+    if (res != FR_OK)
+    {
+        ESP_LOGE(TAG, "Failed to create %s (%d)", path, res);
+        free(m->buf);
+        free(m->entries);
+        m->buf = NULL;
+        m->entries = NULL;
+        return ESP_FAIL;
+    }
+    m->cap = SD_MUX_BUF_SIZE;
+    m->last_index = MUX_NO_INDEX;
+    return ESP_OK;
+}
+
+esp_err_t sd_mux_write(sd_mux_t *m, uint16_t stream, const void *data, size_t len)
+{
+    if (stream >= SD_MUX_MAX_STREAMS)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len == 0 || len > SD_MUX_MAX_CHUNK)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    mux_entry_t *e = &m->entries[m->entry_count];
+    e->stream = stream;
+    e->reserved = 0;
+    e->seq = m->seq[stream];
+    e->offset = m->written + m->used;
+    e->len = len;
+    if (put_chunk(m, stream, e->seq, data, len, NULL, 0) != ESP_OK)
+    {
+        return ESP_FAIL;
+    }
+    m->seq[stream]++;
+    m->entry_count++;
+    m->chunks++;
+    m->payload_bytes += len;
+    if (m->entry_count == SD_MUX_INDEX_INTERVAL)
+    {
+        return write_index(m);
+    }
+    return ESP_OK;
+}
+
+esp_err_t sd_mux_sync(sd_mux_t *m)
+{
+    if (write_index(m) != ESP_OK || flush_buffer(m) != ESP_OK || f_sync(&m->fil) != FR_OK)
+    {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t sd_mux_close(sd_mux_t *m)
+{
+    if (m->buf == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t ret = write_index(m);
+    if (ret == ESP_OK)
+    {
+        mux_trailer_t trailer = {
+            .magic = MUX_TRAILER_MAGIC,
+            .last_index = m->last_index,
+            .index_count = m->index_chunks,
+        };
+        trailer.crc = esp_rom_crc32_le(0, (const uint8_t *)&trailer, offsetof(mux_trailer_t, crc));
+        ret = put(m, &trailer, sizeof(trailer));
+    }
+    if (ret == ESP_OK)
+    {
+        ret = flush_buffer(m);
+    }
+    if (f_close(&m->fil) != FR_OK)
+    {
+        ret = ESP_FAIL;
+    }
+    free(m->buf);
+    free(m->entries);
+    m->buf = NULL;
+    m->entries = NULL;
+    return ret;
+}
+
+static bool read_at(FIL *fil, FSIZE_t offset, void *buf, size_t len)
+{
+    UINT br;
+    return f_lseek(fil, offset) == FR_OK && f_read(fil, buf, len, &br) == FR_OK && br == len;
+}
+
+/**
+ * @brief 从尾部沿索引块链收集所有索引块的偏移
+ *
+ * @return ESP_OK 成功，ESP_ERR_NOT_FOUND 没有有效的尾部或索引链不完整，ESP_ERR_NO_MEM 内存不足
+ */
+static esp_err_t load_index_chain(sd_mux_reader_t *rd)
+{
+    FSIZE_t size = f_size(&rd->fil);
+    mux_trailer_t trailer;
+    if (size < sizeof(trailer) || !read_at(&rd->fil, size - sizeof(trailer), &trailer, sizeof(trailer)) ||
+        trailer.magic != MUX_TRAILER_MAGIC ||
+        trailer.crc != esp_rom_crc32_le(0, (const uint8_t *)&trailer, offsetof(mux_trailer_t, crc)))
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    rd->index_offsets = malloc((trailer.index_count + 1) * sizeof(uint32_t));
+    if (rd->index_offsets == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    // 只检查块头和链接，索引项的CRC在读取该索引块时检查
+    uint32_t offset = trailer.last_index;
+    for (uint32_t i = trailer.index_count; i-- > 0;)
+    {
+        mux_chunk_t hdr;
+        mux_index_t idx;
+        if (offset == MUX_NO_INDEX || offset >= size || !read_at(&rd->fil, offset, &hdr, sizeof(hdr)) ||
+            hdr.magic != MUX_CHUNK_MAGIC || hdr.stream != MUX_INDEX_STREAM || hdr.seq != i ||
+            hdr.len < sizeof(idx) || !read_at(&rd->fil, offset + sizeof(hdr), &idx, sizeof(idx)))
+        {
+            break;
+        }
+        rd->index_offsets[i] = offset;
+        offset = idx.prev;
+        if (i == 0 && offset == MUX_NO_INDEX)
+        {
+            rd->index_count = trailer.index_count;
+            return ESP_OK;
+        }
+    }
+    free(rd->index_offsets);
+    rd->index_offsets = NULL;
+    return trailer.index_count == 0 && trailer.last_index == MUX_NO_INDEX ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+/**
+ * @brief 读取一个索引块，只保留目标流的索引项
+ */
+static esp_err_t load_index(sd_mux_reader_t *rd, uint32_t offset)
+{
+    mux_chunk_t hdr;
+    mux_index_t idx;
+    if (!read_at(&rd->fil, offset, &hdr, sizeof(hdr)) || hdr.len < sizeof(idx) ||
+        hdr.len > sizeof(idx) + SD_MUX_INDEX_INTERVAL * sizeof(mux_entry_t) ||
+        !read_at(&rd->fil, offset + sizeof(hdr), &idx, sizeof(idx)))
+    {
+        return ESP_FAIL;
+    }
+    size_t entries_len = hdr.len - sizeof(idx);
+    UINT br;
+    if (idx.count * sizeof(mux_entry_t) != entries_len ||
+        f_read(&rd->fil, rd->entries, entries_len, &br) != FR_OK || br != entries_len)
+    {
+        return ESP_FAIL;
+    }
+    if (hdr.crc != chunk_crc(&hdr, &idx, sizeof(idx), rd->entries, entries_len))
+    {
+        return ESP_ERR_INVALID_CRC;
+    }
+    rd->entry_count = 0;
+    rd->entry_pos = 0;
+    for (uint32_t i = 0; i < idx.count; i++)
+    {
+        if (rd->entries[i].stream == rd->stream)
+        {
+            rd->entries[rd->entry_count++] = rd->entries[i];
+        }
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 打开读取器，use_index为false时总是顺序扫描（用于测试对比）
+ */
+static esp_err_t open_reader(sd_mux_reader_t *rd, sdmmc_card_t *card, const char *name, uint16_t stream,
+                             bool use_index)
+{
+    memset(rd, 0, sizeof(*rd));
+    rd->stream = stream;
+    BYTE pdrv = ff_diskio_get_pdrv_card(card);
+    if (pdrv == 0xFF)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    char path[24];
+    snprintf(path, sizeof(path), "%d:/%s", pdrv, name);
+    rd->entries = malloc(SD_MUX_INDEX_INTERVAL * sizeof(mux_entry_t));
+    if (rd->entries == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    FRESULT res = f_open(&rd->fil, path, FA_READ);
+    if (res != FR_OK)
+    {
+        free(rd->entries);
+        rd->entries = NULL;
+        return res == FR_NO_FILE ? ESP_ERR_NOT_FOUND : ESP_FAIL;
+    }
+    esp_err_t ret = use_index ? load_index_chain(rd) : ESP_ERR_NOT_FOUND;
+    if (ret == ESP_ERR_NO_MEM)
+    {
+        sd_mux_reader_close(rd);
+        return ret;
+    }
+    rd->indexed = ret == ESP_OK;
+    if (!rd->indexed && use_index)
+    {
+        ESP_LOGW(TAG, "%s has no valid index, scanning chunk headers", path);
+    }
+    return ESP_OK;
+}
+
+esp_err_t sd_mux_reader_open(sd_mux_reader_t *rd, sdmmc_card_t *card, const char *name, uint16_t stream)
+{
+    return open_reader(rd, card, name, stream, true);
+}
+
+/**
+ * @brief 读取块头之后的数据并检查CRC和序号，文件位置必须在块头之后
+ */
+static esp_err_t read_body(sd_mux_reader_t *rd, const mux_chunk_t *hdr, void *data, size_t size, size_t *len)
+{
+    if (hdr->len > size)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    UINT br;
+    if (f_read(&rd->fil, data, hdr->len, &br) != FR_OK)
+    {
+        return ESP_FAIL;
+    }
+    if (br != hdr->len)
+    {
+        return ESP_ERR_NOT_FOUND; // 文件末尾写到一半的块
+    }
+    if (hdr->crc != chunk_crc(hdr, data, hdr->len, NULL, 0) || hdr->seq != rd->next_seq)
+    {
+        return ESP_ERR_INVALID_CRC;
+    }
+    rd->next_seq++;
+    *len = hdr->len;
+    return ESP_OK;
+}
+
+esp_err_t sd_mux_reader_read(sd_mux_reader_t *rd, void *data, size_t size, size_t *len)
+{
+    mux_chunk_t hdr;
+    if (rd->indexed)
+    {
+        while (rd->entry_pos == rd->entry_count)
+        {
+            if (rd->index_pos == rd->index_count)
+            {
+                return ESP_ERR_NOT_FOUND;
+            }
+            esp_err_t ret = load_index(rd, rd->index_offsets[rd->index_pos++]);
+            if (ret != ESP_OK)
+            {
+                return ret;
+            }
+        }
+        const mux_entry_t *e = &rd->entries[rd->entry_pos++];
+        if (!read_at(&rd->fil, e->offset, &hdr, sizeof(hdr)))
+        {
+            return ESP_FAIL;
+        }
+        rd->headers++;
+        if (hdr.magic != MUX_CHUNK_MAGIC || hdr.stream != rd->stream || hdr.seq != e->seq || hdr.len != e->len)
+        {
+            return ESP_ERR_INVALID_CRC;
+        }
+        return read_body(rd, &hdr, data, size, len);
+    }
+
+    // 顺序扫描：跳过其他流的块和索引块，遇到无效的块头（尾部或写到一半的块）时结束
+    while (true)
+    {
+        UINT br;
+        if (f_lseek(&rd->fil, rd->scan_pos) != FR_OK || f_read(&rd->fil, &hdr, sizeof(hdr), &br) != FR_OK)
+        {
+            return ESP_FAIL;
+        }
+        if (br != sizeof(hdr) || hdr.magic != MUX_CHUNK_MAGIC || hdr.len > SD_MUX_MAX_CHUNK)
+        {
+            return ESP_ERR_NOT_FOUND;
+        }
+        rd->headers++;
+        rd->scan_pos += sizeof(hdr) + hdr.len;
+        if (hdr.stream == rd->stream)
+        {
+            return read_body(rd, &hdr, data, size, len);
+        }
+    }
+}
+
+void sd_mux_reader_close(sd_mux_reader_t *rd)
+{
+    f_close(&rd->fil);
+    free(rd->index_offsets);
+    free(rd->entries);
+    rd->index_offsets = NULL;
+    rd->entries = NULL;
+}
+
+static size_t chunk_size(uint16_t stream)
+{
+    return MUX_BENCH_MIN_CHUNK << (stream % 4);
+}
+
+static void make_chunk(uint8_t *buf, uint16_t stream, uint32_t seq)
+{
+    memset(buf, 'A' + stream, chunk_size(stream));
+    memcpy(buf, &seq, sizeof(seq));
+}
+
+static void bench_path(char *path, size_t size, sdmmc_card_t *card, const char *name)
+{
+    snprintf(path, size, "%d:/%s", ff_diskio_get_pdrv_card(card), name);
+}
+
+/**
+ * @brief 每个流一个文件，块直接追加到各自的文件
+ */
+static esp_err_t bench_separate_write(sdmmc_card_t *card, uint32_t rounds, uint8_t *chunk)
+{
+    FIL *files = calloc(MUX_BENCH_STREAMS, sizeof(FIL));
+    if (files == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = ESP_OK;
+    uint16_t opened = 0;
+    char name[16];
+    char path[24];
+    for (; opened < MUX_BENCH_STREAMS; opened++)
+    {
+        snprintf(name, sizeof(name), "MX%02u.BIN", (unsigned)opened);
+        bench_path(path, sizeof(path), card, name);
+        if (f_open(&files[opened], path, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK)
+        {
+            ret = ESP_FAIL;
+            break;
+        }
+    }
+    for (uint32_t r = 0; r < rounds && ret == ESP_OK; r++)
+    {
+        for (uint16_t s = 0; s < MUX_BENCH_STREAMS && ret == ESP_OK; s++)
+        {
+            UINT bw;
+            make_chunk(chunk, s, r);
+            if (f_write(&files[s], chunk, chunk_size(s), &bw) != FR_OK || bw != chunk_size(s))
+            {
+                ret = ESP_FAIL;
+            }
+        }
+    }
+    for (uint16_t s = 0; s < opened; s++)
+    {
+        if (f_close(&files[s]) != FR_OK)
+        {
+            ret = ESP_FAIL;
+        }
+    }
+    free(files);
+    return ret;
+}
+
+/**
+ * @brief 从容器中提取一个流，检查每块的序号和内容
+ */
+static esp_err_t bench_extract_mux(sdmmc_card_t *card, uint16_t stream, bool use_index, uint8_t *buf,
+                                   uint64_t *bytes, uint32_t *headers)
+{
+    sd_mux_reader_t *rd = calloc(1, sizeof(sd_mux_reader_t));
+    if (rd == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = open_reader(rd, card, MUX_BENCH_NAME, stream, use_index);
+    if (ret != ESP_OK)
+    {
+        free(rd);
+        return ret;
+    }
+    size_t len;
+    uint32_t seq = 0;
+    while ((ret = sd_mux_reader_read(rd, buf, MUX_BENCH_READ_SIZE, &len)) == ESP_OK)
+    {
+        uint32_t n;
+        memcpy(&n, buf, sizeof(n));
+        if (n != seq++ || len != chunk_size(stream) || buf[len - 1] != 'A' + stream)
+        {
+            ret = ESP_ERR_INVALID_CRC;
+            break;
+        }
+        *bytes += len;
+    }
+    *headers = rd->headers;
+    if (ret == ESP_ERR_NOT_FOUND)
+    {
+        ret = use_index && !rd->indexed ? ESP_ERR_INVALID_STATE : ESP_OK; // 索引无效时不计入索引读取的结果
+    }
+    sd_mux_reader_close(rd);
+    free(rd);
+    return ret;
+}
+
+static esp_err_t bench_extract_separate(sdmmc_card_t *card, uint16_t stream, uint8_t *buf, uint64_t *bytes)
+{
+    FIL *fil = calloc(1, sizeof(FIL));
+    if (fil == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    char name[16];
+    char path[24];
+    snprintf(name, sizeof(name), "MX%02u.BIN", (unsigned)stream);
+    bench_path(path, sizeof(path), card, name);
+    esp_err_t ret = ESP_FAIL;
+    if (f_open(fil, path, FA_READ) == FR_OK)
+    {
+        UINT br;
+        ret = ESP_OK;
+        do
+        {
+            if (f_read(fil, buf, MUX_BENCH_READ_SIZE, &br) != FR_OK)
+            {
+                ret = ESP_FAIL;
+                break;
+            }
+            *bytes += br;
+        } while (br == MUX_BENCH_READ_SIZE);
+        f_close(fil);
+    }
+    free(fil);
+    return ret;
+}
+
+static void print_extract_row(const char *label, uint16_t stream, esp_err_t ret, uint64_t bytes, int64_t us,
+                              uint32_t headers)
+{
+    if (ret != ESP_OK)
+    {
+        printf("  %-10s %6u failed (%s)\n", label, (unsigned)stream, esp_err_to_name(ret));
+        return;
+    }
+    printf("  %-10s %6u %8u %8.1f %8.2f %8u\n", label, (unsigned)stream, (unsigned)(bytes / 1024), us / 1000.0,
+           (double)bytes / us, (unsigned)headers);
+}
+
+void sd_mux_bench_run(sdmmc_card_t *card)
+{
+    size_t round_bytes = 0;
+    for (uint16_t s = 0; s < MUX_BENCH_STREAMS; s++)
+    {
+        round_bytes += chunk_size(s);
+    }
+    const uint32_t rounds = MUX_BENCH_BYTES / round_bytes;
+    const uint16_t extract_streams[] = {0, 3}; // 块最小和最大的流
+
+    printf("\nMultiplexed container vs one file per stream (%u streams, %u KB, %u..%u B chunks):\n",
+           MUX_BENCH_STREAMS, MUX_BENCH_BYTES / 1024, MUX_BENCH_MIN_CHUNK, MUX_BENCH_MIN_CHUNK << 3);
+
+    uint8_t *buf = malloc(MUX_BENCH_READ_SIZE);
+    sd_mux_t *m = calloc(1, sizeof(sd_mux_t));
+    if (buf == NULL || m == NULL)
+    {
+        printf("  failed to allocate buffers\n\n");
+        free(buf);
+        free(m);
+        return;
+    }
+
+    // 写入：各流的块轮流到达
+    printf("  %-10s %8s\n", "write", "MB/s");
+    int64_t start = esp_timer_get_time();
+    esp_err_t mux_ret = sd_mux_open(m, card, MUX_BENCH_NAME);
+    for (uint32_t r = 0; r < rounds && mux_ret == ESP_OK; r++)
+    {
+        for (uint16_t s = 0; s < MUX_BENCH_STREAMS && mux_ret == ESP_OK; s++)
+        {
+            make_chunk(buf, s, r);
+            mux_ret = sd_mux_write(m, s, buf, chunk_size(s));
+        }
+    }
+    if (m->buf != NULL)
+    {
+        esp_err_t close_ret = sd_mux_close(m);
+        mux_ret = mux_ret == ESP_OK ? close_ret : mux_ret;
+    }
+    int64_t us = esp_timer_get_time() - start;
+    if (mux_ret == ESP_OK)
+    {
+        printf("  %-10s %8.2f (%u chunks, %u index chunks)\n", "container", (double)m->payload_bytes / us,
+               (unsigned)m->chunks, (unsigned)m->index_chunks);
+    }
+    else
+    {
+        printf("  %-10s failed (%s)\n", "container", esp_err_to_name(mux_ret));
+    }
+
+    start = esp_timer_get_time();
+    esp_err_t sep_ret = bench_separate_write(card, rounds, buf);
+    us = esp_timer_get_time() - start;
+    if (sep_ret == ESP_OK)
+    {
+        printf("  %-10s %8.2f\n", "separate", (double)rounds * round_bytes / us);
+    }
+    else
+    {
+        printf("  %-10s failed (%s)\n", "separate", esp_err_to_name(sep_ret));
+    }
+
+    // 提取单个流：按索引、顺序扫描块头、读取单独的文件
+    printf("  %-10s %6s %8s %8s %8s %8s\n", "extract", "stream", "KB", "ms", "MB/s", "headers");
+    for (size_t i = 0; i < sizeof(extract_streams) / sizeof(extract_streams[0]); i++)
+    {
+        uint16_t s = extract_streams[i];
+        uint64_t bytes = 0;
+        uint32_t headers = 0;
+        if (mux_ret == ESP_OK)
+        {
+            start = esp_timer_get_time();
+            esp_err_t ret = bench_extract_mux(card, s, true, buf, &bytes, &headers);
+            print_extract_row("index", s, ret, bytes, esp_timer_get_time() - start, headers);
+
+            bytes = 0;
+            start = esp_timer_get_time();
+            ret = bench_extract_mux(card, s, false, buf, &bytes, &headers);
+            print_extract_row("scan", s, ret, bytes, esp_timer_get_time() - start, headers);
+        }
+        if (sep_ret == ESP_OK)
+        {
+            bytes = 0;
+            start = esp_timer_get_time();
+            esp_err_t ret = bench_extract_separate(card, s, buf, &bytes);
+            print_extract_row("separate", s, ret, bytes, esp_timer_get_time() - start, 0);
+        }
+    }
+    printf("\n");
+
+    char name[16];
+    char path[24];
+    bench_path(path, sizeof(path), card, MUX_BENCH_NAME);
+    f_unlink(path);
+    for (uint16_t s = 0; s < MUX_BENCH_STREAMS; s++)
+    {
+        snprintf(name, sizeof(name), "MX%02u.BIN", (unsigned)s);
+        bench_path(path, sizeof(path), card, name);
+        f_unlink(path);
+    }
+    free(buf);
+    free(m);
+}
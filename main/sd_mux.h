@@ -0,0 +1,153 @@
+/*
+ * 单文件多路复用流容器
+ *
+ * 多个逻辑流不各写一个文件，而是把数据块按到达顺序交错写入同一个文件，文件只做顺序追加。
+ * 每个块有块头（流号、该流中的序号、长度、CRC），每写入SD_MUX_INDEX_INTERVAL个块后
+ * 追加一个索引块，记录这些块的流号、序号和偏移，并指向上一个索引块。
+ *
+ * 文件布局：
+ *   [块][块]...[索引块][块]...[索引块][尾部]
+ * 尾部固定16字节，记录最后一个索引块的偏移。读取单个流时：
+ * - 文件完整关闭：从尾部沿索引块链找到所有索引块，只读取目标流的块，不读其他流的数据
+ * - 没有尾部（掉电或未关闭）：从文件开头依次读取块头，跳过其他流的块，直到遇到无效的块头
+ *
+ * 写入经过一个写缓冲区，写满时整块写出，写入位置始终按缓冲区大小对齐。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "sdmmc_cmd.h"
+#include "ff.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SD_MUX_MAX_STREAMS 32        // 最多流数
+#define SD_MUX_MAX_CHUNK (64 * 1024) // 单个数据块的最大长度
+#define SD_MUX_INDEX_INTERVAL 256    // 每个索引块覆盖的数据块数
+#define SD_MUX_BUF_SIZE (16 * 1024)  // 写缓冲区大小，也是写入的对齐单位
+
+struct sd_mux_entry;
+
+/**
+ * @brief 容器写入器
+ */
+typedef struct
+{
+    FIL fil;                          // 容器文件
+    uint8_t *buf;                     // 写缓冲区（DMA可用）
+    size_t used;                      // 写缓冲区已填充的字节数
+    size_t cap;                       // 本次最多填充的字节数，使写入结束于对齐位置
+    FSIZE_t written;                  // 已写到文件的字节数
+    uint32_t seq[SD_MUX_MAX_STREAMS]; // 每个流的下一个序号
+    struct sd_mux_entry *entries;     // 上一个索引块之后写入的块
+    uint32_t entry_count;             // entries中的块数
+    uint32_t last_index;              // 上一个索引块的偏移，没有时为UINT32_MAX
+
+    // 统计信息
+    uint32_t chunks;        // 写入的数据块数
+    uint32_t index_chunks;  // 写入的索引块数
+    uint64_t payload_bytes; // 数据块中的有效数据字节数
+} sd_mux_t;
+
+/**
+ * @brief 单个流的读取器
+ */
+typedef struct
+{
+    FIL fil;                      // 容器文件
+    uint16_t stream;              // 目标流
+    bool indexed;                 // 按索引读取；false表示顺序扫描块头
+    uint32_t *index_offsets;      // 所有索引块的偏移（按文件顺序）
+    uint32_t index_count;         // 索引块数
+    uint32_t index_pos;           // 下一个要读取的索引块
+    struct sd_mux_entry *entries; // 当前索引块中属于目标流的块
+    uint32_t entry_count;         // entries中的块数
+    uint32_t entry_pos;           // 下一个要读取的块
+    FSIZE_t scan_pos;             // 扫描模式下下一个块头的偏移
+    uint32_t next_seq;            // 期望的下一个序号
+
+    // 统计信息
+    uint32_t headers; // 读取的块头数（包括跳过的其他流的块）
+} sd_mux_reader_t;
+
+/**
+ * @brief 在卡根目录下创建容器文件（已存在时截断）
+ *
+ * @param m    写入器
+ * @param card 已通过sd_mount挂载的SD卡
+ * @param name 文件名（8.3格式，位于根目录）
+ * @return ESP_OK 成功，ESP_ERR_NOT_FOUND 卡未挂载到FATFS，ESP_ERR_NO_MEM 内存不足，ESP_FAIL 创建失败
+ */
+esp_err_t sd_mux_open(sd_mux_t *m, sdmmc_card_t *card, const char *name);
+
+/**
+ * @brief 把一个数据块追加到流中
+ *
+ * @param m      写入器
+ * @param stream 流号（小于SD_MUX_MAX_STREAMS）
+ * @param data   数据
+ * @param len    长度（1到SD_MUX_MAX_CHUNK）
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 流号错误，ESP_ERR_INVALID_SIZE 长度错误，ESP_FAIL 写入失败
+ */
+esp_err_t sd_mux_write(sd_mux_t *m, uint16_t stream, const void *data, size_t len);
+
+/**
+ * @brief 写出索引块和写缓冲区中的数据并同步文件
+ *
+ * 之后掉电时，顺序扫描可以读到同步之前的所有块。
+ */
+esp_err_t sd_mux_sync(sd_mux_t *m);
+
+/**
+ * @brief 写出最后的索引块和尾部，关闭文件并释放资源
+ */
+esp_err_t sd_mux_close(sd_mux_t *m);
+
+/**
+ * @brief 打开容器文件，准备按顺序读取一个流的数据块
+ *
+ * 文件有有效的尾部时按索引读取，否则顺序扫描块头。
+ *
+ * @param rd     读取器
+ * @param card   已通过sd_mount挂载的SD卡
+ * @param name   文件名
+ * @param stream 流号
+ * @return ESP_OK 成功，ESP_ERR_NOT_FOUND 卡未挂载到FATFS或文件不存在，ESP_ERR_NO_MEM 内存不足，
+ *         ESP_FAIL 读取失败
+ */
+esp_err_t sd_mux_reader_open(sd_mux_reader_t *rd, sdmmc_card_t *card, const char *name, uint16_t stream);
+
+/**
+ * @brief 读取流的下一个数据块
+ *
+ * @param rd   读取器
+ * @param data 输出缓冲区
+ * @param size 缓冲区大小
+ * @param len  输出：块长度
+ * @return ESP_OK 成功，ESP_ERR_NOT_FOUND 已读完，ESP_ERR_INVALID_SIZE 缓冲区太小，
+ *         ESP_ERR_INVALID_CRC 块校验失败或序号不连续，ESP_FAIL 读取失败
+ */
+esp_err_t sd_mux_reader_read(sd_mux_reader_t *rd, void *data, size_t size, size_t *len);
+
+/**
+ * @brief 关闭文件并释放读取器
+ */
+void sd_mux_reader_close(sd_mux_reader_t *rd);
+
+/**
+ * @brief 对比容器与每个流一个文件的写入吞吐量，以及从中提取单个流的速度
+ *
+ * @param card 已通过sd_mount挂载的SD卡
+ */
+void sd_mux_bench_run(sdmmc_card_t *card);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,353 @@
+/*
+ * 单卡多FAT分区挂载实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <sys/unistd.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_vfs_fat.h"
+#include "diskio_impl.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "sd_partition.h"
+#include "sd_diskio.h"
+
+#define PART_WRITER_STACK_SIZE 4096
+
+static const char *TAG = "sd_part";
+
+/**
+ * @brief 逻辑驱动器号转FATFS路径，例如"1:"
+ */
+static void drive_path(BYTE vol, char *out)
+{
+    out[0] = (char)('0' + vol);
+    out[1] = ':';
+    out[2] = '\0';
+}
+
+/**
+ * @brief 按容量平均重新分区，并在每个分区上创建FAT文件系统
+ */
+static esp_err_t partition_card(sd_part_set_t *set)
+{
+    ESP_LOGW(TAG, "Partitioning card into %d FAT volumes, all data will be lost", set->count);
+    void *work = malloc(FF_MAX_SS);
+    if (work == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    // 不大于100的表项表示占总容量的百分比
+    LBA_t plist[4] = {0};
+    for (int i = 0; i < set->count; i++)
+    {
+        plist[i] = 100 / set->count;
+    }
+    FRESULT res = f_fdisk(set->pdrv, plist, work);
+    if (res != FR_OK)
+    {
+        ESP_LOGE(TAG, "f_fdisk failed (%d)", res);
+        free(work);
+        return ESP_FAIL;
+    }
+
+    const MKFS_PARM opt = {(BYTE)FM_ANY, 0, 0, 0, SD_MOUNT_ALLOCATION_UNIT_SIZE};
+    for (int i = 0; i < set->count; i++)
+    {
+        char drv[3];
+        drive_path(set->vol[i], drv);
+        res = f_mkfs(drv, &opt, work, FF_MAX_SS);
+        if (res != FR_OK)
+        {
+            ESP_LOGE(TAG, "f_mkfs on partition %d failed (%d)", i + 1, res);
+            free(work);
+            return ESP_FAIL;
+        }
+    }
+    free(work);
+    return ESP_OK;
+}
+
+/**
+ * @brief 挂载所有卷的FATFS
+ *
+ * @return FR_OK 全部成功，否则为第一个失败的卷的错误码
+ */
+static FRESULT mount_volumes(sd_part_set_t *set)
+{
+    for (int i = 0; i < set->count; i++)
+    {
+        char drv[3];
+        drive_path(set->vol[i], drv);
+        FRESULT res = f_mount(set->fs[i], drv, 1);
+        if (res != FR_OK)
+        {
+            ESP_LOGW(TAG, "Failed to mount partition %d (%d)", i + 1, res);
+            return res;
+        }
+    }
+    return FR_OK;
+}
+
+esp_err_t sd_part_mount(const sd_mount_params_t *params, int count, sd_part_set_t *set)
+{
+    memset(set, 0, sizeof(*set));
+    if (count < 1 || count > SD_PART_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    set->count = count;
+
+    esp_err_t ret = sd_mount_raw(params, &set->mnt);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    // 每个卷占用一个驱动器号。第一个驱动器号同时作为物理驱动器，
+    // 其余驱动器号也注册同一张卡，只是为了不被其他模块占用
+    for (int i = 0; i < count; i++)
+    {
+        BYTE drv = 0xFF;
+        ret = ff_diskio_get_drive(&drv);
+        if (ret != ESP_OK || drv == 0xFF)
+        {
+            ESP_LOGE(TAG, "No free FATFS drive for partition %d, unmount " MOUNT_POINT " first", i + 1);
+            ret = ESP_ERR_NOT_FOUND;
+            goto fail;
+        }
+        ret = sd_diskio_register(drv, set->mnt.card);
+        if (ret != ESP_OK)
+        {
+            goto fail;
+        }
+        set->vol[i] = drv;
+        set->saved[i] = VolToPart[drv];
+        set->registered++;
+    }
+    set->pdrv = set->vol[0];
+    for (int i = 0; i < count; i++)
+    {
+        VolToPart[set->vol[i]].pd = set->pdrv;
+        VolToPart[set->vol[i]].pt = i + 1;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        char drv[3];
+        drive_path(set->vol[i], drv);
+        snprintf(set->base_path[i], sizeof(set->base_path[i]), SD_PART_MOUNT_POINT_FMT, i);
+        ret = esp_vfs_fat_register(set->base_path[i], drv, params->max_files, &set->fs[i]);
+        if (ret != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Failed to register %s (%s)", set->base_path[i], esp_err_to_name(ret));
+            goto fail;
+        }
+        set->mounted++;
+    }
+
+    FRESULT res = mount_volumes(set);
+    if (res == FR_NO_FILESYSTEM && params->format_if_mount_failed)
+    {
+        ret = partition_card(set);
+        if (ret != ESP_OK)
+        {
+            goto fail;
+        }
+        res = mount_volumes(set);
+    }
+    if (res != FR_OK)
+    {
+        ret = ESP_FAIL;
+        goto fail;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        ESP_LOGI(TAG, "Partition %d mounted at %s (drive %d)", i + 1, set->base_path[i], set->vol[i]);
+    }
+    return ESP_OK;
+
+fail:
+    sd_part_unmount(set);
+    return ret;
+}
+
+esp_err_t sd_part_unmount(sd_part_set_t *set)
+{
+    for (int i = 0; i < set->mounted; i++)
+    {
+        char drv[3];
+        drive_path(set->vol[i], drv);
+        f_mount(NULL, drv, 0);
+        esp_vfs_fat_unregister_path(set->base_path[i]);
+    }
+    set->mounted = 0;
+    for (int i = 0; i < set->registered; i++)
+    {
+        VolToPart[set->vol[i]] = set->saved[i];
+        sd_diskio_unregister(set->vol[i]);
+    }
+    set->registered = 0;
+    if (set->mnt.card == NULL)
+    {
+        return ESP_OK;
+    }
+    return sd_unmount(&set->mnt);
+}
+
+/**
+ * @brief 写任务参数和结果
+ */
+typedef struct
+{
+    char path[24];          // 写入的文件
+    size_t buf_size;        // 缓冲区大小
+    size_t file_size;       // 文件大小
+    SemaphoreHandle_t done; // 完成信号（两个写任务共用）
+    esp_err_t ret;          // 写入结果
+    int64_t us;             // 从打开到关闭文件的耗时
+} part_writer_t;
+
+static void writer_task(void *arg)
+{
+    part_writer_t *w = arg;
+    w->ret = ESP_FAIL;
+    uint8_t *buffer = heap_caps_malloc(w->buf_size, MALLOC_CAP_DMA);
+    if (buffer != NULL)
+    {
+        memset(buffer, 0x5A, w->buf_size);
+        int64_t start = esp_timer_get_time();
+        FILE *f = fopen(w->path, "w");
+        if (f == NULL)
+        {
+            ESP_LOGE(TAG, "Failed to open %s (errno: %d)", w->path, errno);
+        }
+        else
+        {
+            size_t written = 0;
+            while (written < w->file_size)
+            {
+                size_t n = w->file_size - written;
+                if (n > w->buf_size)
+                {
+                    n = w->buf_size;
+                }
+                if (fwrite(buffer, 1, n, f) != n)
+                {
+                    break;
+                }
+                written += n;
+            }
+            fsync(fileno(f));
+            if (fclose(f) == 0 && written == w->file_size)
+            {
+                w->ret = ESP_OK;
+            }
+        }
+        w->us = esp_timer_get_time() - start;
+        free(buffer);
+    }
+    xSemaphoreGive(w->done);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief 两个写任务同时写入path0和path1，输出吞吐量和总线争用统计
+ */
+static void run_two_writers(const char *label, const char *path0, const char *path1,
+                            size_t buf_size, size_t file_size)
+{
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(2, 0);
+    if (done == NULL)
+    {
+        return;
+    }
+    part_writer_t writers[2];
+    const char *paths[2] = {path0, path1};
+    for (int i = 0; i < 2; i++)
+    {
+        memset(&writers[i], 0, sizeof(writers[i]));
+        strlcpy(writers[i].path, paths[i], sizeof(writers[i].path));
+        writers[i].buf_size = buf_size;
+        writers[i].file_size = file_size;
+        writers[i].done = done;
+    }
+
+    sd_diskio_take_stats(NULL);
+    int64_t start = esp_timer_get_time();
+    int started = 0;
+    for (int i = 0; i < 2; i++)
+    {
+        if (xTaskCreatePinnedToCore(writer_task, "sd_part_wr", PART_WRITER_STACK_SIZE, &writers[i],
+                                    uxTaskPriorityGet(NULL), NULL, tskNO_AFFINITY) == pdPASS)
+        {
+            started++;
+        }
+    }
+    for (int i = 0; i < started; i++)
+    {
+        xSemaphoreTake(done, portMAX_DELAY);
+    }
+    int64_t wall_us = esp_timer_get_time() - start;
+    sd_diskio_stats_t stats;
+    sd_diskio_take_stats(&stats);
+    vSemaphoreDelete(done);
+
+    bool ok = started == 2 && writers[0].ret == ESP_OK && writers[1].ret == ESP_OK;
+    float total_mb = (2 * file_size) / (1024.0 * 1024.0);
+    printf("  %-12s %8.2f %8.2f %8.2f %8.2f %8u %9u %9.1f %7.1f%s\n", label,
+           wall_us / 1000000.0,
+           total_mb / (wall_us / 1000000.0),
+           (file_size / (1024.0 * 1024.0)) / (writers[0].us / 1000000.0),
+           (file_size / (1024.0 * 1024.0)) / (writers[1].us / 1000000.0),
+           (unsigned)(stats.reads + stats.writes),
+           (unsigned)stats.contended,
+           stats.wait_us / 1000.0,
+           wall_us > 0 ? stats.busy_us * 100.0 / wall_us : 0.0,
+           ok ? "" : "  (write failed)");
+
+    unlink(path0);
+    unlink(path1);
+}
+
+void sd_part_bench_run(const sd_mount_params_t *params, size_t buf_size, size_t file_size)
+{
+    ESP_LOGI(TAG, "Benchmarking two writers on one volume vs two volumes");
+
+    // 只有在允许格式化时才重新分区，不擦除普通的单分区卡
+    sd_part_set_t set;
+    if (sd_part_mount(params, 2, &set) != ESP_OK)
+    {
+        if (!params->format_if_mount_failed)
+        {
+            ESP_LOGW(TAG, "Skipping: needs a card with two FAT partitions "
+                          "(or EXAMPLE_FORMAT_IF_MOUNT_FAILED to repartition it)");
+        }
+        return;
+    }
+
+    char path0[24];
+    char path1[24];
+    char path1_other[24];
+    snprintf(path0, sizeof(path0), "%s/w0.bin", set.base_path[0]);
+    snprintf(path1, sizeof(path1), "%s/w1.bin", set.base_path[0]);
+    snprintf(path1_other, sizeof(path1_other), "%s/w1.bin", set.base_path[1]);
+
+    printf("\nTwo writers, %u bytes each, %u-byte buffer:\n", (unsigned)file_size, (unsigned)buf_size);
+    printf("  %-12s %8s %8s %8s %8s %8s %9s %9s %7s\n",
+           "case", "wall s", "MB/s", "w0 MB/s", "w1 MB/s", "bus req", "contended", "wait ms", "busy %");
+    run_two_writers("one volume", path0, path1, buf_size, file_size);
+    run_two_writers("two volumes", path0, path1_other, buf_size, file_size);
+    printf("  (bus req/contended/wait: sector requests through sd_diskio and time spent waiting for the card)\n\n");
+
+    sd_part_unmount(&set);
+}
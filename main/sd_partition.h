@@ -0,0 +1,86 @@
+/*
+ * 单卡多FAT分区挂载
+ *
+ * FATFS按卷加锁：同一个卷上的两个写任务即使写的是不同文件也会互相等待。
+ * 把SD卡分成多个分区，每个分区作为独立的卷（各自的FATFS对象和互斥锁）
+ * 挂载到不同的挂载点，不同卷上的写任务就只在SD总线上竞争。
+ *
+ * 实现方式：每个卷占用一个FATFS驱动器号，通过VolToPart把这些逻辑驱动器
+ * 映射到同一个物理驱动器的第1、2...个分区，扇区读写经过sd_diskio统计总线争用。
+ *
+ * 注意：ESP-IDF v4.4中FATFS驱动器总数（FF_VOLUMES）固定为2，
+ * 因此最多两个分区，并且挂载前必须先卸载MOUNT_POINT上的主挂载。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stddef.h>
+#include "esp_err.h"
+#include "ff.h"
+#include "sd_mount.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 最大分区（卷）数量
+#define SD_PART_MAX FF_VOLUMES
+
+// 第i个卷的挂载点为"/vol<i>"
+#define SD_PART_MOUNT_POINT_FMT "/vol%d"
+
+/**
+ * @brief 多分区挂载状态
+ */
+typedef struct
+{
+    sd_mount_t mnt;               // SD卡（只初始化，不挂载文件系统）
+    int count;                    // 卷数量
+    int registered;               // 已注册的驱动器号数量
+    int mounted;                  // 已挂载的卷数量
+    BYTE pdrv;                    // 实际读写SD卡的物理驱动器号
+    BYTE vol[SD_PART_MAX];        // 各卷的逻辑驱动器号
+    PARTITION saved[SD_PART_MAX]; // 挂载前的VolToPart表项，卸载时恢复
+    FATFS *fs[SD_PART_MAX];       // 各卷的FATFS对象（各自带一个互斥锁）
+    char base_path[SD_PART_MAX][12]; // 各卷的挂载点
+} sd_part_set_t;
+
+/**
+ * @brief 初始化SD卡，并把前count个分区分别挂载到"/vol0"、"/vol1"...
+ *
+ * 如果某个分区上没有文件系统且params->format_if_mount_failed为true，
+ * 会重新分区（容量平均分配）并格式化所有分区，卡上原有数据全部丢失。
+ *
+ * @param params 挂载参数
+ * @param count  分区数量（1~SD_PART_MAX）
+ * @param set    输出的挂载状态
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_INVALID_ARG 分区数量无效
+ *  - ESP_ERR_NOT_FOUND 没有空闲的FATFS驱动器号（主挂载未卸载）
+ *  - ESP_FAIL 文件系统挂载或格式化失败
+ *  - 其他错误码 SD卡初始化失败
+ */
+esp_err_t sd_part_mount(const sd_mount_params_t *params, int count, sd_part_set_t *set);
+
+/**
+ * @brief 卸载所有卷并释放SD卡
+ */
+esp_err_t sd_part_unmount(sd_part_set_t *set);
+
+/**
+ * @brief 对比两个写任务在同一个卷上和在两个卷上的写入吞吐量，并输出总线争用统计
+ *
+ * 需要主挂载已卸载。如果卡上没有两个FAT分区，params->format_if_mount_failed为true时
+ * 重新分区并格式化，否则跳过测试。
+ *
+ * @param params    挂载参数
+ * @param buf_size  每个写任务的缓冲区大小
+ * @param file_size 每个写任务写入的文件大小
+ */
+void sd_part_bench_run(const sd_mount_params_t *params, size_t buf_size, size_t file_size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,207 @@
+/*
+ * 文件空间预分配实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/unistd.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "diskio_sdmmc.h"
+#include "sd_prealloc.h"
+#include "sd_bench.h"
+#include "sd_raw.h"
+
+static const char *TAG = "sd_prealloc";
+
+esp_err_t sd_prealloc_fat_path(sdmmc_card_t *card, const char *vfs_path, char *out, size_t size)
+{
+    size_t prefix = strlen(MOUNT_POINT);
+    if (strncmp(vfs_path, MOUNT_POINT "/", prefix + 1) != 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    BYTE pdrv = ff_diskio_get_pdrv_card(card);
+    if (pdrv == 0xFF)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    int n = snprintf(out, size, "%d:%s", pdrv, vfs_path + prefix);
+    return n > 0 && (size_t)n < size ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+bool sd_prealloc_is_contiguous(FIL *fil, FSIZE_t size)
+{
+    // FF_MAX_SS == FF_MIN_SS（如sdkconfig.lowram）时FATFS没有ssize成员，SD卡扇区固定为512字节
+    FSIZE_t cluster_bytes = (FSIZE_t)fil->obj.fs->csize * SD_RAW_SECTOR_SIZE;
+    DWORD clusters = (size + cluster_bytes - 1) / cluster_bytes;
+    DWORD sclust = fil->obj.sclust;
+    for (DWORD k = 1; k < clusters; k++)
+    {
+        // 定位到第k个簇内的第一个字节后，fil->clust即为该簇的簇号
+        if (f_lseek(fil, k * cluster_bytes + 1) != FR_OK || fil->clust != sclust + k)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 把已以写方式打开的文件扩展到size字节，不写入数据
+ */
+static FRESULT extend(FIL *fil, FSIZE_t size)
+{
+#if FF_USE_EXPAND
+    // f_expand只能用于空文件，一次分配一段连续的簇
+    if (f_size(fil) == 0)
+    {
+        return f_expand(fil, size, 1);
+    }
+#endif
+    // 写模式下定位到文件末尾之后会分配簇并扩大文件
+    FRESULT res = f_lseek(fil, size);
+    if (res == FR_OK && f_tell(fil) != size)
+    {
+        res = FR_DENIED; // 空间不足
+    }
+    return res;
+}
+
+esp_err_t sd_prealloc_fallocate(const char *fat_path, uint32_t offset, uint32_t len, bool *contiguous)
+{
+    // FIL带有扇区缓冲区，放在堆上以免占用调用者的栈
+    FIL *fil = calloc(1, sizeof(FIL));
+    if (fil == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    FRESULT res = f_open(fil, fat_path, FA_OPEN_ALWAYS | FA_WRITE | FA_READ);
+    if (res != FR_OK)
+    {
+        ESP_LOGE(TAG, "Failed to open %s (%d)", fat_path, res);
+        free(fil);
+        return ESP_FAIL;
+    }
+    FSIZE_t end = (FSIZE_t)offset + len;
+    if (end > f_size(fil))
+    {
+        res = extend(fil, end);
+    }
+    if (res == FR_OK && contiguous != NULL)
+    {
+        *contiguous = sd_prealloc_is_contiguous(fil, f_size(fil));
+    }
+    FRESULT close_res = f_close(fil);
+    free(fil);
+    if (res != FR_OK || close_res != FR_OK)
+    {
+        ESP_LOGE(TAG, "Failed to allocate %u bytes for %s (%d)", (unsigned)end, fat_path, res);
+        return res == FR_DENIED ? ESP_ERR_NO_MEM : ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t sd_prealloc_truncate(const char *fat_path, uint32_t size)
+{
+    FIL *fil = calloc(1, sizeof(FIL));
+    if (fil == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    FRESULT res = f_open(fil, fat_path, FA_OPEN_EXISTING | FA_WRITE);
+    if (res != FR_OK)
+    {
+        free(fil);
+        return res == FR_NO_FILE ? ESP_ERR_NOT_FOUND : ESP_FAIL;
+    }
+    if (size < f_size(fil))
+    {
+        res = f_lseek(fil, size);
+        if (res == FR_OK)
+        {
+            res = f_truncate(fil);
+        }
+    }
+    else if (size > f_size(fil))
+    {
+        res = extend(fil, size);
+    }
+    FRESULT close_res = f_close(fil);
+    free(fil);
+    if (res != FR_OK || close_res != FR_OK)
+    {
+        ESP_LOGE(TAG, "Failed to resize %s to %u bytes (%d)", fat_path, (unsigned)size, res);
+        return res == FR_DENIED ? ESP_ERR_NO_MEM : ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+void sd_prealloc_bench_run(sdmmc_card_t *card)
+{
+    sd_bench_params_t params = SD_BENCH_PARAMS_DEFAULT();
+    params.cold_read = false;
+    char fat_path[32];
+    if (sd_prealloc_fat_path(card, params.path, fat_path, sizeof(fat_path)) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "%s is not on the FAT volume", params.path);
+        return;
+    }
+
+    printf("\nPreallocated writes (%u KB file, %u KB writes):\n", (unsigned)(params.file_size / 1024),
+           (unsigned)(params.buf_size / 1024));
+    printf("  %-10s %11s %8s %13s %10s\n", "mode", "prealloc ms", "MB/s", "max write ms", "contiguous");
+    static const char *const modes[] = {"grow", "fallocate", "truncate"};
+    for (int m = 0; m < 3; m++)
+    {
+        unlink(params.path);
+        esp_err_t ret = ESP_OK;
+        bool contiguous = false;
+        int64_t start = esp_timer_get_time();
+        if (m == 1)
+        {
+            ret = sd_prealloc_fallocate(fat_path, 0, params.file_size, &contiguous);
+        }
+        else if (m == 2)
+        {
+            // 先创建空文件，再像ftruncate一样直接设置文件大小
+            FILE *f = fopen(params.path, "w");
+            ret = f != NULL && fclose(f) == 0 ? ESP_OK : ESP_FAIL;
+            if (ret == ESP_OK)
+            {
+                ret = sd_prealloc_truncate(fat_path, params.file_size);
+            }
+        }
+        int64_t prealloc_us = esp_timer_get_time() - start;
+
+        sd_bench_result_t result;
+        if (ret == ESP_OK)
+        {
+            params.preallocated = m != 0;
+            ret = sd_bench_write(&params, &result);
+        }
+        if (ret != ESP_OK)
+        {
+            printf("  %-10s failed (%s)\n", modes[m], esp_err_to_name(ret));
+            continue;
+        }
+        if (m == 2)
+        {
+            // truncate不返回连续性，写完后再打开检查
+            FIL *fil = calloc(1, sizeof(FIL));
+            if (fil != NULL && f_open(fil, fat_path, FA_READ) == FR_OK)
+            {
+                contiguous = sd_prealloc_is_contiguous(fil, f_size(fil));
+                f_close(fil);
+            }
+            free(fil);
+        }
+        printf("  %-10s %11.1f %8.2f %13.1f %10s\n", modes[m], m ? prealloc_us / 1000.0 : 0.0,
+               result.speed_mb, result.max_op_us / 1000.0, m ? (contiguous ? "yes" : "no") : "-");
+    }
+    printf("\n");
+    unlink(params.path);
+}
@@ -0,0 +1,77 @@
+/*
+ * 文件空间预分配
+ *
+ * ESP-IDF的FAT VFS没有posix_fallocate，文件在fwrite过程中逐簇增长，
+ * 每次跨簇都要查找空闲簇并更新FAT表。本模块直接通过FatFs提供：
+ * - sd_prealloc_fallocate：类似posix_fallocate，为指定范围分配簇，空闲空间连续时分配结果也连续
+ * - sd_prealloc_truncate：类似ftruncate，缩短文件或快速扩展文件
+ *
+ * 注意：
+ * - 扩展出的区域不写入数据（不清零），读取时得到的是簇中原有的内容，
+ *   这与POSIX要求的读出为0不同
+ * - 调用时文件不能通过VFS或其他FatFs句柄同时打开
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "sdmmc_cmd.h"
+#include "ff.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 把主挂载点下的VFS路径转换为FatFs路径，例如"/sdcard/test.txt"转换为"0:/test.txt"
+ *
+ * @param card     已通过sd_mount挂载的SD卡
+ * @param vfs_path MOUNT_POINT下的路径
+ * @param out      输出缓冲区
+ * @param size     输出缓冲区大小
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 路径不在MOUNT_POINT下或缓冲区太小，ESP_ERR_NOT_FOUND 卡未挂载到FATFS
+ */
+esp_err_t sd_prealloc_fat_path(sdmmc_card_t *card, const char *vfs_path, char *out, size_t size);
+
+/**
+ * @brief 为文件的[offset, offset + len)分配空间，文件不存在时创建
+ *
+ * 超出当前文件大小时文件大小变为offset + len。已有数据不受影响。
+ * FatFs启用FF_USE_EXPAND且文件为空时使用f_expand保证连续，否则从上一次分配的簇之后顺序分配。
+ *
+ * @param fat_path   FatFs路径（见sd_prealloc_fat_path）
+ * @param offset     起始偏移
+ * @param len        长度
+ * @param contiguous 输出：文件的簇是否在物理上连续，可为NULL
+ * @return ESP_OK 成功，ESP_ERR_NO_MEM 内存或空间不足，ESP_FAIL 文件操作失败
+ */
+esp_err_t sd_prealloc_fallocate(const char *fat_path, uint32_t offset, uint32_t len, bool *contiguous);
+
+/**
+ * @brief 把文件大小设置为size：缩短时释放多余的簇，扩展时只分配簇不写数据
+ *
+ * @return ESP_OK 成功，ESP_ERR_NOT_FOUND 文件不存在，ESP_ERR_NO_MEM 内存或空间不足，ESP_FAIL 文件操作失败
+ */
+esp_err_t sd_prealloc_truncate(const char *fat_path, uint32_t size);
+
+/**
+ * @brief 检查已打开文件的前size字节所在的簇是否在物理上连续
+ *
+ * 会移动文件读写位置。
+ */
+bool sd_prealloc_is_contiguous(FIL *fil, FSIZE_t size);
+
+/**
+ * @brief 对比写入时逐簇增长、fallocate预分配和truncate扩展后的写入速度与单次fwrite最长耗时
+ *
+ * @param card 已通过sd_mount挂载的SD卡
+ */
+void sd_prealloc_bench_run(sdmmc_card_t *card);
+
+#ifdef __cplusplus
+}
+#endif
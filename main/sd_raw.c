@@ -0,0 +1,416 @@
+/*
+ * 命令级原始读写实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "driver/sdmmc_defs.h"
+#include "diskio_sdmmc.h"
+#include "ff.h"
+#include "sd_raw.h"
+
+#define RAW_WRITE_TIMEOUT_US (1000 * 1000)        // 等待卡编程完成的超时时间
+#define RAW_BENCH_NAME "RAWBENCH.BIN"             // 测试区域占位文件
+#define RAW_BENCH_REGION_SIZE (4 * 1024 * 1024)   // 测试区域大小
+#define RAW_BENCH_MAX_BLOCKS 1024                 // 扫描的最大每命令块数
+#define RAW_BENCH_BYTES_PER_POINT (1024 * 1024)   // 每个扫描点至少传输的数据量
+#define RAW_BENCH_MIN_CMDS 8                      // 每个扫描点至少发送的命令数
+#define RAW_BENCH_BAR_WIDTH 40                    // 吞吐量柱状图宽度
+#define RAW_BENCH_DMA_RESERVE (16 * 1024)         // 分配测试缓冲区后至少保留的DMA内存
+
+static const char *TAG = "sd_raw";
+
+/**
+ * @brief 创建region->path并分配size字节的连续簇，成功时填写区域的位置（fil为FIL对象的存储空间）
+ */
+static esp_err_t reserve_file(sdmmc_card_t *card, FIL *fil, size_t size, sd_raw_region_t *region)
+{
+    // 扩展文件大小来分配簇：FATFS从上一个簇之后查找空闲簇，空闲空间连续时得到的簇也连续
+    FRESULT res = f_open(fil, region->path, FA_CREATE_ALWAYS | FA_WRITE);
+    if (res != FR_OK)
+    {
+        ESP_LOGE(TAG, "Failed to create %s (%d)", region->path, res);
+        return ESP_FAIL;
+    }
+#if FF_USE_EXPAND
+    res = f_expand(fil, size, 1);
+#else
+    res = f_lseek(fil, size);
+    if (res == FR_OK && f_tell(fil) != size)
+    {
+        res = FR_DENIED; // 空间不足
+    }
+#endif
+    FRESULT close_res = f_close(fil);
+    if (res != FR_OK || close_res != FR_OK)
+    {
+        ESP_LOGE(TAG, "Failed to allocate %u bytes for %s (%d)", (unsigned)size, region->path, res);
+        f_unlink(region->path);
+        return res == FR_DENIED ? ESP_ERR_NO_MEM : ESP_FAIL;
+    }
+
+    // 逐簇检查文件的簇号是否连续
+    res = f_open(fil, region->path, FA_READ);
+    if (res != FR_OK)
+    {
+        f_unlink(region->path);
+        return ESP_FAIL;
+    }
+    FATFS *fs = fil->obj.fs;
+    DWORD sclust = fil->obj.sclust;
+    FSIZE_t cluster_bytes = (FSIZE_t)fs->csize * SD_RAW_SECTOR_SIZE;
+    DWORD clusters = (size + cluster_bytes - 1) / cluster_bytes;
+    esp_err_t ret = ESP_OK;
+    for (DWORD k = 1; k < clusters; k++)
+    {
+        // 定位到第k个簇内的第一个字节后，fil->clust即为该簇的簇号
+        if (f_lseek(fil, k * cluster_bytes + 1) != FR_OK || fil->clust != sclust + k)
+        {
+            ESP_LOGE(TAG, "%s is fragmented at cluster %u, free space is not contiguous", region->path, (unsigned)k);
+            ret = ESP_ERR_INVALID_STATE;
+            break;
+        }
+    }
+    f_close(fil);
+    if (ret != ESP_OK)
+    {
+        f_unlink(region->path);
+        return ret;
+    }
+
+    region->card = card;
+    region->start = fs->database + (sclust - 2) * fs->csize;
+    region->sectors = clusters * fs->csize;
+    ESP_LOGI(TAG, "Reserved %u sectors at LBA %u (%s)", (unsigned)region->sectors, (unsigned)region->start,
+             region->path);
+    return ESP_OK;
+}
+
+esp_err_t sd_raw_reserve(sdmmc_card_t *card, const char *name, size_t size, sd_raw_region_t *region)
+{
+    memset(region, 0, sizeof(*region));
+    BYTE pdrv = ff_diskio_get_pdrv_card(card);
+    if (pdrv == 0xFF)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    snprintf(region->path, sizeof(region->path), "%d:/%s", pdrv, name);
+
+    // FIL带有扇区缓冲区，放在堆上以免占用调用者（如主任务）的栈
+    FIL *fil = calloc(1, sizeof(FIL));
+    if (fil == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = reserve_file(card, fil, size, region);
+    free(fil);
+    return ret;
+}
+
+esp_err_t sd_raw_release(sd_raw_region_t *region)
+{
+    if (region->card == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    region->card = NULL;
+    return f_unlink(region->path) == FR_OK ? ESP_OK : ESP_FAIL;
+}
+
+/**
+ * @brief 通过主机驱动发送一条命令，同时检查传输错误和命令错误
+ */
+static esp_err_t send_cmd(sdmmc_card_t *card, sdmmc_command_t *cmd)
+{
+    esp_err_t ret = card->host.do_transaction(card->host.slot, cmd);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    return cmd->error;
+}
+
+/**
+ * @brief 写入后等待卡退出编程状态，与sdmmc_write_sectors的处理相同
+ */
+static esp_err_t wait_ready(sdmmc_card_t *card)
+{
+    if (card->host.flags & SDMMC_HOST_FLAG_SPI)
+    {
+        return ESP_OK;
+    }
+    int64_t deadline = esp_timer_get_time() + RAW_WRITE_TIMEOUT_US;
+    while (true)
+    {
+        sdmmc_command_t cmd = {
+            .opcode = MMC_SEND_STATUS,
+            .arg = MMC_ARG_RCA(card->rca),
+            .flags = SCF_CMD_AC | SCF_RSP_R1,
+        };
+        esp_err_t ret = send_cmd(card, &cmd);
+        if (ret != ESP_OK)
+        {
+            return ret;
+        }
+        if (MMC_R1(cmd.response) & MMC_R1_READY_FOR_DATA)
+        {
+            return ESP_OK;
+        }
+        if (esp_timer_get_time() > deadline)
+        {
+            return ESP_ERR_TIMEOUT;
+        }
+    }
+}
+
+esp_err_t sd_raw_set_pre_erase(const sd_raw_region_t *region, size_t count)
+{
+    if (region->card == NULL || count == 0 || count > 0x7FFFFF)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sdmmc_card_t *card = region->card;
+    sdmmc_command_t app_cmd = {
+        .opcode = MMC_APP_CMD,
+        .arg = MMC_ARG_RCA(card->rca),
+        .flags = SCF_CMD_AC | SCF_RSP_R1,
+    };
+    esp_err_t ret = send_cmd(card, &app_cmd);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    sdmmc_command_t cmd = {
+        .opcode = SD_APP_SET_WR_BLK_ERASE_COUNT,
+        .arg = count,
+        .flags = SCF_CMD_AC | SCF_RSP_R1,
+    };
+    return send_cmd(card, &cmd);
+}
+
+/**
+ * @brief 对区域内的扇区发送一条多块读写命令
+ */
+static esp_err_t raw_transfer(const sd_raw_region_t *region, uint32_t opcode, int flags,
+                              uint32_t sector, void *buf, size_t count)
+{
+    if (region->card == NULL || count == 0 || sector + count > region->sectors)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sdmmc_card_t *card = region->card;
+    uint32_t addr = region->start + sector;
+    if ((card->ocr & SD_OCR_SDHC_CAP) == 0)
+    {
+        addr *= SD_RAW_SECTOR_SIZE; // 标准容量卡使用字节地址
+    }
+    sdmmc_command_t cmd = {
+        .opcode = opcode,
+        .arg = addr,
+        .flags = flags,
+        .data = buf,
+        .datalen = count * SD_RAW_SECTOR_SIZE,
+        .blklen = SD_RAW_SECTOR_SIZE,
+    };
+    // 多块命令由主机驱动在数据传输结束后自动发送CMD12
+    return send_cmd(card, &cmd);
+}
+
+esp_err_t sd_raw_read(const sd_raw_region_t *region, uint32_t sector, void *buf, size_t count)
+{
+    return raw_transfer(region, MMC_READ_BLOCK_MULTIPLE, SCF_CMD_ADTC | SCF_CMD_READ | SCF_RSP_R1,
+                        sector, buf, count);
+}
+
+esp_err_t sd_raw_write(const sd_raw_region_t *region, uint32_t sector, const void *buf, size_t count)
+{
+    esp_err_t ret = raw_transfer(region, MMC_WRITE_BLOCK_MULTIPLE, SCF_CMD_ADTC | SCF_RSP_R1,
+                                 sector, (void *)buf, count);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    return wait_ready(region->card);
+}
+
+/**
+ * @brief 一个扫描点的结果
+ */
+typedef struct
+{
+    int blocks;     // 每条命令的块数
+    bool valid;     // 是否完成测试
+    float read_us;  // CMD18平均每条命令耗时
+    float write_us; // CMD25平均每条命令耗时（含等待编程完成）
+} sweep_point_t;
+
+/**
+ * @brief 在区域内顺序发送多条相同大小的命令，返回平均每条命令的耗时
+ */
+static esp_err_t time_commands(const sd_raw_region_t *region, uint8_t *buf, int blocks, bool write, float *us_per_cmd)
+{
+    int cmds = RAW_BENCH_BYTES_PER_POINT / (blocks * SD_RAW_SECTOR_SIZE);
+    if (cmds < RAW_BENCH_MIN_CMDS)
+    {
+        cmds = RAW_BENCH_MIN_CMDS;
+    }
+    uint32_t sector = 0;
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < cmds; i++)
+    {
+        if (sector + blocks > region->sectors)
+        {
+            sector = 0;
+        }
+        esp_err_t ret = write ? sd_raw_write(region, sector, buf, blocks) : sd_raw_read(region, sector, buf, blocks);
+        if (ret != ESP_OK)
+        {
+            ESP_LOGE(TAG, "CMD%d with %d blocks failed (%s)", write ? 25 : 18, blocks, esp_err_to_name(ret));
+            return ret;
+        }
+        sector += blocks;
+    }
+    *us_per_cmd = (float)(esp_timer_get_time() - start) / cmds;
+    return ESP_OK;
+}
+
+/**
+ * @brief 最小二乘拟合 t = a + b * blocks：a为每条命令的固定开销，b为每块的传输时间
+ */
+static void fit_overhead(const sweep_point_t *points, int count, bool write, float *a, float *b)
+{
+    float sx = 0, sy = 0, sxx = 0, sxy = 0;
+    int n = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (!points[i].valid)
+        {
+            continue;
+        }
+        float x = points[i].blocks;
+        float y = write ? points[i].write_us : points[i].read_us;
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+        n++;
+    }
+    float den = n * sxx - sx * sx;
+    if (n < 2 || den == 0)
+    {
+        *a = 0;
+        *b = 0;
+        return;
+    }
+    *b = (n * sxy - sx * sy) / den;
+    *a = (sy - *b * sx) / n;
+}
+
+static float to_mb_per_s(int blocks, float us)
+{
+    return us > 0 ? (blocks * SD_RAW_SECTOR_SIZE / (1024.0f * 1024.0f)) / (us / 1000000.0f) : 0;
+}
+
+/**
+ * @brief 打印吞吐量柱状图
+ */
+static void print_chart(const char *title, const sweep_point_t *points, int count, bool write)
+{
+    float max_mb = 0;
+    for (int i = 0; i < count; i++)
+    {
+        float mb = points[i].valid ? to_mb_per_s(points[i].blocks, write ? points[i].write_us : points[i].read_us) : 0;
+        max_mb = mb > max_mb ? mb : max_mb;
+    }
+    printf("  %s MB/s:\n", title);
+    for (int i = 0; i < count; i++)
+    {
+        if (!points[i].valid)
+        {
+            continue;
+        }
+        float mb = to_mb_per_s(points[i].blocks, write ? points[i].write_us : points[i].read_us);
+        int width = max_mb > 0 ? (int)(mb * RAW_BENCH_BAR_WIDTH / max_mb + 0.5f) : 0;
+        char bar[RAW_BENCH_BAR_WIDTH + 1];
+        memset(bar, '#', width);
+        bar[width] = '\0';
+        printf("  %5d |%-*s %6.2f\n", points[i].blocks, RAW_BENCH_BAR_WIDTH, bar, mb);
+    }
+}
+
+void sd_raw_bench_run(sdmmc_card_t *card)
+{
+    ESP_LOGI(TAG, "Sweeping blocks per CMD18/CMD25");
+
+    // 单条命令的数据必须位于一块连续的DMA缓冲区中，最大块数受最大可分配DMA内存限制
+    size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_DMA);
+    size_t usable = largest > RAW_BENCH_DMA_RESERVE ? largest - RAW_BENCH_DMA_RESERVE : 0;
+    int max_blocks = 1;
+    while (max_blocks * 2 <= RAW_BENCH_MAX_BLOCKS && (size_t)max_blocks * 2 * SD_RAW_SECTOR_SIZE <= usable)
+    {
+        max_blocks *= 2;
+    }
+    uint8_t *buf = heap_caps_malloc(max_blocks * SD_RAW_SECTOR_SIZE, MALLOC_CAP_DMA);
+    if (buf == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate buffer");
+        return;
+    }
+    memset(buf, 0xA5, max_blocks * SD_RAW_SECTOR_SIZE);
+
+    sd_raw_region_t region;
+    if (sd_raw_reserve(card, RAW_BENCH_NAME, RAW_BENCH_REGION_SIZE, &region) != ESP_OK)
+    {
+        free(buf);
+        return;
+    }
+
+    sweep_point_t points[11];
+    int count = 0;
+    for (int blocks = 1; blocks <= RAW_BENCH_MAX_BLOCKS; blocks *= 2)
+    {
+        sweep_point_t *p = &points[count++];
+        memset(p, 0, sizeof(*p));
+        p->blocks = blocks;
+        if (blocks > max_blocks)
+        {
+            continue;
+        }
+        p->valid = time_commands(&region, buf, blocks, true, &p->write_us) == ESP_OK &&
+                   time_commands(&region, buf, blocks, false, &p->read_us) == ESP_OK;
+    }
+    sd_raw_release(&region);
+    free(buf);
+
+    float read_a, read_b, write_a, write_b;
+    fit_overhead(points, count, false, &read_a, &read_b);
+    fit_overhead(points, count, true, &write_a, &write_b);
+
+    printf("\nRaw transfer size sweep (%d kHz, %u-sector region at LBA %u):\n",
+           card->max_freq_khz, (unsigned)region.sectors, (unsigned)region.start);
+    printf("  %6s %11s %9s %6s %11s %9s %6s\n", "blocks", "CMD18 MB/s", "us/cmd", "ovh%", "CMD25 MB/s", "us/cmd", "ovh%");
+    for (int i = 0; i < count; i++)
+    {
+        const sweep_point_t *p = &points[i];
+        if (!p->valid)
+        {
+            printf("  %6d %s\n", p->blocks, p->blocks > max_blocks ? "skipped (DMA buffer too small)" : "failed");
+            continue;
+        }
+        printf("  %6d %11.2f %9.1f %6.1f %11.2f %9.1f %6.1f\n", p->blocks,
+               to_mb_per_s(p->blocks, p->read_us), p->read_us, read_a * 100.0f / p->read_us,
+               to_mb_per_s(p->blocks, p->write_us), p->write_us, write_a * 100.0f / p->write_us);
+    }
+    printf("  fit t = a + b*blocks: CMD18 a=%.1f us, b=%.2f us/block; CMD25 a=%.1f us, b=%.2f us/block\n",
+           read_a, read_b, write_a, write_b);
+    printf("  (ovh%%: share of each command spent on the fixed per-command cost a)\n\n");
+    print_chart("CMD18", points, count, false);
+    print_chart("CMD25", points, count, true);
+    printf("\n");
+}
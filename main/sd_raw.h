@@ -0,0 +1,109 @@
+/*
+ * 命令级原始读写
+ *
+ * 绕过FATFS，直接通过主机驱动的do_transaction发送CMD18/CMD25多块读写命令，
+ * 用于测量命令开销与每块传输时间，以及其他需要直接控制命令的场景。
+ *
+ * 为了不破坏文件系统，原始读写只允许在一个预留区域内进行：
+ * 预留区域是卡上的一个文件，创建时检查其簇在物理上连续，
+ * 因此区域内的扇区号可以直接换算为卡上的绝对扇区号。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdmmc_cmd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 原始读写的扇区大小
+#define SD_RAW_SECTOR_SIZE 512
+
+/**
+ * @brief 预留的连续扇区区域
+ */
+typedef struct
+{
+    sdmmc_card_t *card; // SD卡
+    uint32_t start;     // 区域在卡上的起始扇区（绝对扇区号）
+    uint32_t sectors;   // 区域扇区数
+    char path[24];      // 占位文件的FATFS路径，例如"0:/RAWBENCH.BIN"
+} sd_raw_region_t;
+
+/**
+ * @brief 在已挂载的卡上创建占位文件，并确认其在物理上连续
+ *
+ * 文件通过扩展文件大小分配簇（不写入数据），因此创建很快。
+ * 如果空闲空间碎片化导致文件不连续，则删除文件并返回错误。
+ *
+ * @param card   已通过sd_mount挂载的SD卡
+ * @param name   文件名（8.3格式，位于根目录）
+ * @param size   区域大小（字节，向上取整到簇）
+ * @param region 输出的区域
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_NOT_FOUND 卡未挂载到FATFS
+ *  - ESP_ERR_NO_MEM 内存或空间不足
+ *  - ESP_ERR_INVALID_STATE 空闲空间碎片化，无法得到连续区域
+ *  - ESP_FAIL 文件操作失败
+ */
+esp_err_t sd_raw_reserve(sdmmc_card_t *card, const char *name, size_t size, sd_raw_region_t *region);
+
+/**
+ * @brief 删除占位文件，释放区域
+ */
+esp_err_t sd_raw_release(sd_raw_region_t *region);
+
+/**
+ * @brief 用一条CMD18从区域内读取count个扇区（count为1时也使用多块命令）
+ *
+ * @param region 预留区域
+ * @param sector 区域内的扇区偏移
+ * @param buf    DMA可用的缓冲区，至少count * SD_RAW_SECTOR_SIZE字节
+ * @param count  扇区数
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 超出区域，其他错误码来自主机驱动
+ */
+esp_err_t sd_raw_read(const sd_raw_region_t *region, uint32_t sector, void *buf, size_t count);
+
+/**
+ * @brief 用一条CMD25向区域内写入count个扇区，并等待卡编程完成
+ *
+ * SDMMC模式下通过CMD13轮询卡状态直到READY_FOR_DATA；
+ * SDSPI模式下主机驱动在数据响应后已等待忙信号结束。
+ *
+ * @param region 预留区域
+ * @param sector 区域内的扇区偏移
+ * @param buf    DMA可用的缓冲区
+ * @param count  扇区数
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 超出区域，ESP_ERR_TIMEOUT 卡编程超时，其他错误码来自主机驱动
+ */
+esp_err_t sd_raw_write(const sd_raw_region_t *region, uint32_t sector, const void *buf, size_t count);
+
+/**
+ * @brief 发送ACMD23，告诉卡下一条CMD25将写入count个扇区
+ *
+ * 卡可以据此在接收数据前预先擦除这些块。设置只对紧接着的一条多块写命令有效。
+ *
+ * @param region 预留区域
+ * @param count  下一条CMD25的扇区数（1~0x7FFFFF）
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数错误，其他错误码来自主机驱动
+ */
+esp_err_t sd_raw_set_pre_erase(const sd_raw_region_t *region, size_t count);
+
+/**
+ * @brief 以每条命令1~1024块扫描CMD18和CMD25的吞吐量，并拟合每条命令的固定开销
+ *
+ * 受DMA内存限制，单条命令的最大块数不超过最大可分配DMA缓冲区。
+ *
+ * @param card 已通过sd_mount挂载的SD卡
+ */
+void sd_raw_bench_run(sdmmc_card_t *card);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,582 @@
+/*
+ * 固定大小的循环日志文件实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <sys/unistd.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_rom_crc.h"
+#include "diskio_sdmmc.h"
+#include "sd_ringlog.h"
+#include "sd_mount.h"
+
+#define RINGLOG_MAGIC 0x474C4E52u                 // "RNLG"
+#define RINGLOG_BLOCK_MAGIC 0x4B4C4252u           // "RBLK"
+#define RINGLOG_HDR_SIZE 512                      // 每份文件头的大小
+#define RINGLOG_DATA_OFFSET SD_RINGLOG_BLOCK_SIZE // 数据区起始偏移（两份文件头之后，按块对齐）
+#define RINGLOG_HDR_INTERVAL 64                   // 每写完多少块更新一次文件头，也是打开时向后检查的典型块数
+#define RINGLOG_BENCH_NAME "RING.LOG"             // 测试用循环日志
+#define RINGLOG_BENCH_SIZE (256 * 1024)           // 保留的数据量
+#define RINGLOG_BENCH_RECORD 100                  // 每条记录的字节数
+#define RINGLOG_BENCH_FLUSH_EVERY 10              // 每多少条记录刷新一次
+#define RINGLOG_BENCH_WRAPS 4                     // 写入的数据量为保留量的倍数
+#define RINGLOG_BENCH_ROTATE_SIZE (16 * 1024)     // 轮换方式中每个文件的大小
+#define RINGLOG_BENCH_SLOW_US (10 * 1000)         // 统计超过该延迟的追加次数
+
+static const char *TAG = "sd_ringlog";
+
+/**
+ * @brief 文件头
+ */
+typedef struct
+{
+    uint32_t magic;      // RINGLOG_MAGIC
+    uint32_t block_size; // SD_RINGLOG_BLOCK_SIZE
+    uint32_t blocks;     // 数据块数
+    uint32_t head;       // 当前块
+    uint32_t tail;       // 最旧的块
+    uint32_t wraps;      // 回绕次数
+    uint32_t seq;        // 当前块的序列号
+    uint32_t writes;     // 文件头的写入次数，两份中较大的为最新
+    uint32_t crc;        // 以上字段的CRC32
+} ring_header_t;
+
+/**
+ * @brief 块头，位于每个块的开头
+ */
+typedef struct
+{
+    uint32_t magic; // RINGLOG_BLOCK_MAGIC
+    uint32_t seq;   // 块序列号
+    uint32_t used;  // 已用字节数（含块头）
+    uint32_t crc;   // 块头（crc为0时）和记录的CRC32
+} ring_block_t;
+
+static uint32_t block_crc(const uint8_t *buf, size_t used)
+{
+    ring_block_t blk;
+    memcpy(&blk, buf, sizeof(blk));
+    blk.crc = 0;
+    uint32_t crc = esp_rom_crc32_le(0, (const uint8_t *)&blk, sizeof(blk));
+    return esp_rom_crc32_le(crc, buf + sizeof(blk), used - sizeof(blk));
+}
+
+/**
+ * @brief 块缓冲区中是否为序列号seq的有效块
+ */
+static bool block_valid(const uint8_t *buf, uint32_t seq)
+{
+    const ring_block_t *blk = (const ring_block_t *)buf;
+    return blk->magic == RINGLOG_BLOCK_MAGIC && blk->seq == seq && blk->used >= sizeof(ring_block_t) &&
+           blk->used <= SD_RINGLOG_BLOCK_SIZE && blk->crc == block_crc(buf, blk->used);
+}
+
+static FSIZE_t block_offset(const sd_ringlog_t *r, uint32_t seq)
+{
+    return RINGLOG_DATA_OFFSET + (FSIZE_t)(seq % r->blocks) * SD_RINGLOG_BLOCK_SIZE;
+}
+
+static esp_err_t read_block(sd_ringlog_t *r, uint32_t seq, uint8_t *buf)
+{
+    UINT br;
+    if (f_lseek(&r->fil, block_offset(r, seq)) != FR_OK ||
+        f_read(&r->fil, buf, SD_RINGLOG_BLOCK_SIZE, &br) != FR_OK || br != SD_RINGLOG_BLOCK_SIZE)
+    {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 整块写出当前块
+ */
+static esp_err_t write_block(sd_ringlog_t *r)
+{
+    ring_block_t *blk = (ring_block_t *)r->buf;
+    blk->magic = RINGLOG_BLOCK_MAGIC;
+    blk->seq = r->seq;
+    blk->used = r->used;
+    blk->crc = block_crc(r->buf, r->used);
+    UINT bw;
+    if (f_lseek(&r->fil, block_offset(r, r->seq)) != FR_OK ||
+        f_write(&r->fil, r->buf, SD_RINGLOG_BLOCK_SIZE, &bw) != FR_OK || bw != SD_RINGLOG_BLOCK_SIZE)
+    {
+        return ESP_FAIL;
+    }
+    r->dirty = false;
+    r->block_writes++;
+    return ESP_OK;
+}
+
+/**
+ * @brief 把head、tail和回绕次数写到较旧的一份文件头
+ */
+static esp_err_t write_header(sd_ringlog_t *r)
+{
+    uint8_t *sector = r->hdr_buf;
+    memset(sector, 0, RINGLOG_HDR_SIZE);
+    ring_header_t *hdr = (ring_header_t *)sector;
+    hdr->magic = RINGLOG_MAGIC;
+    hdr->block_size = SD_RINGLOG_BLOCK_SIZE;
+    hdr->blocks = r->blocks;
+    hdr->head = r->seq % r->blocks;
+    hdr->tail = r->seq + 1 >= r->blocks ? (r->seq + 1) % r->blocks : 0;
+    hdr->wraps = r->seq / r->blocks;
+    hdr->seq = r->seq;
+    hdr->writes = r->hdr_writes + 1;
+    hdr->crc = esp_rom_crc32_le(0, sector, offsetof(ring_header_t, crc));
+    UINT bw;
+    if (f_lseek(&r->fil, (FSIZE_t)(hdr->writes % 2) * RINGLOG_HDR_SIZE) != FR_OK ||
+        f_write(&r->fil, sector, RINGLOG_HDR_SIZE, &bw) != FR_OK || bw != RINGLOG_HDR_SIZE)
+    {
+        return ESP_FAIL;
+    }
+    r->hdr_writes++;
+    r->blocks_since_hdr = 0;
+    return ESP_OK;
+}
+
+/**
+ * @brief 读取第index份文件头，无效时返回false
+ */
+static bool read_header(sd_ringlog_t *r, int index, ring_header_t *hdr)
+{
+    uint8_t *sector = r->hdr_buf;
+    UINT br;
+    if (f_lseek(&r->fil, (FSIZE_t)index * RINGLOG_HDR_SIZE) != FR_OK ||
+        f_read(&r->fil, sector, RINGLOG_HDR_SIZE, &br) != FR_OK || br != RINGLOG_HDR_SIZE)
+    {
+        return false;
+    }
+    memcpy(hdr, sector, sizeof(*hdr));
+    return hdr->magic == RINGLOG_MAGIC && hdr->crc == esp_rom_crc32_le(0, sector, offsetof(ring_header_t, crc)) &&
+           hdr->block_size == SD_RINGLOG_BLOCK_SIZE && hdr->blocks == r->blocks;
+}
+
+static void free_buffers(sd_ringlog_t *r)
+{
+    free(r->buf);
+    free(r->hdr_buf);
+    r->buf = NULL;
+    r->hdr_buf = NULL;
+}
+
+static void start_block(sd_ringlog_t *r, uint32_t seq)
+{
+    r->seq = seq;
+    memset(r->buf, 0, SD_RINGLOG_BLOCK_SIZE);
+    r->used = sizeof(ring_block_t);
+    r->dirty = false;
+}
+
+/**
+ * @brief 从文件头记录的序列号向后检查块，返回下一个可用的序列号
+ */
+static uint32_t recover_seq(sd_ringlog_t *r, uint32_t seq)
+{
+    uint32_t next = seq;
+    for (uint32_t n = 0; n < r->blocks; n++)
+    {
+        if (read_block(r, seq + n, r->buf) != ESP_OK || !block_valid(r->buf, seq + n))
+        {
+            break;
+        }
+        next = seq + n + 1;
+    }
+    return next;
+}
+
+esp_err_t sd_ringlog_open(sd_ringlog_t *r, sdmmc_card_t *card, const char *name, size_t size)
+{
+    memset(r, 0, sizeof(*r));
+    r->blocks = size / SD_RINGLOG_BLOCK_SIZE;
+    if (r->blocks < 2)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    BYTE pdrv = ff_diskio_get_pdrv_card(card);
+    if (pdrv == 0xFF)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    char path[24];
+    snprintf(path, sizeof(path), "%d:/%s", pdrv, name);
+    r->buf = malloc(SD_RINGLOG_BLOCK_SIZE);
+    r->hdr_buf = malloc(RINGLOG_HDR_SIZE);
+    if (r->buf == NULL || r->hdr_buf == NULL)
+    {
+        free_buffers(r);
+        return ESP_ERR_NO_MEM;
+    }
+    FRESULT res = f_open(&r->fil, path, FA_OPEN_ALWAYS | FA_READ | FA_WRITE);
+    if (res != FR_OK)
+    {
+        ESP_LOGE(TAG, "Failed to open %s (%d)", path, res);
+        free_buffers(r);
+        return ESP_FAIL;
+    }
+
+    // 两份文件头中取有效且写入次数较大的一份
+    FSIZE_t total = RINGLOG_DATA_OFFSET + (FSIZE_t)r->blocks * SD_RINGLOG_BLOCK_SIZE;
+    bool found = false;
+    uint32_t seq = 0;
+    if (f_size(&r->fil) == total)
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            ring_header_t hdr;
+            if (read_header(r, i, &hdr) && (!found || hdr.writes > r->hdr_writes))
+            {
+                found = true;
+                r->hdr_writes = hdr.writes;
+                seq = hdr.seq;
+            }
+        }
+    }
+    else
+    {
+        // 新文件或大小改变：一次性分配全部空间，之后文件大小不再改变
+        res = f_lseek(&r->fil, total);
+        if (res == FR_OK && f_tell(&r->fil) != total)
+        {
+            res = FR_DENIED; // 空间不足
+        }
+        if (res == FR_OK)
+        {
+            res = f_truncate(&r->fil);
+        }
+        if (res == FR_OK)
+        {
+            res = f_sync(&r->fil);
+        }
+        if (res != FR_OK)
+        {
+            ESP_LOGE(TAG, "Failed to allocate %u bytes for %s (%d)", (unsigned)total, path, res);
+            f_close(&r->fil);
+            free_buffers(r);
+            return res == FR_DENIED ? ESP_ERR_NO_MEM : ESP_FAIL;
+        }
+    }
+
+    if (found)
+    {
+        seq = recover_seq(r, seq);
+    }
+    start_block(r, seq);
+    if (write_header(r) != ESP_OK)
+    {
+        sd_ringlog_close(r);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t sd_ringlog_append(sd_ringlog_t *r, const void *data, size_t len)
+{
+    if (len > SD_RINGLOG_MAX_RECORD)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (r->used + 2 + len > SD_RINGLOG_BLOCK_SIZE)
+    {
+        // 当前块已满：写出后开始下一块，覆盖其中最旧的数据
+        if (write_block(r) != ESP_OK)
+        {
+            return ESP_FAIL;
+        }
+        start_block(r, r->seq + 1);
+        r->blocks_since_hdr++;
+        if (r->seq % r->blocks == 0 || r->blocks_since_hdr >= RINGLOG_HDR_INTERVAL)
+        {
+            if (write_header(r) != ESP_OK)
+            {
+                return ESP_FAIL;
+            }
+        }
+    }
+    uint16_t n = len;
+    memcpy(r->buf + r->used, &n, sizeof(n));
+    memcpy(r->buf + r->used + sizeof(n), data, len);
+    r->used += sizeof(n) + len;
+    r->dirty = true;
+    r->records++;
+    return ESP_OK;
+}
+
+esp_err_t sd_ringlog_flush(sd_ringlog_t *r)
+{
+    // 块和文件头都是整扇区写入，直接写到卡上；文件大小不变，不需要f_sync更新目录项
+    if (r->dirty && write_block(r) != ESP_OK)
+    {
+        return ESP_FAIL;
+    }
+    return write_header(r);
+}
+
+esp_err_t sd_ringlog_close(sd_ringlog_t *r)
+{
+    if (r->buf == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t ret = sd_ringlog_flush(r);
+    if (f_close(&r->fil) != FR_OK)
+    {
+        ret = ESP_FAIL;
+    }
+    free_buffers(r);
+    return ret;
+}
+
+esp_err_t sd_ringlog_reader_open(sd_ringlog_reader_t *rd, sd_ringlog_t *r)
+{
+    memset(rd, 0, sizeof(*rd));
+    esp_err_t ret = sd_ringlog_flush(r);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    rd->buf = malloc(SD_RINGLOG_BLOCK_SIZE);
+    if (rd->buf == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    rd->log = r;
+    // 最旧的块是当前块的下一块，未回绕时为第一块
+    rd->seq = r->seq + 1 >= r->blocks ? r->seq + 1 - r->blocks : 0;
+    return ESP_OK;
+}
+
+esp_err_t sd_ringlog_read(sd_ringlog_reader_t *rd, void *data, size_t size, size_t *len)
+{
+    while (true)
+    {
+        if (rd->used == 0)
+        {
+            if (rd->seq > rd->log->seq)
+            {
+                return ESP_ERR_NOT_FOUND;
+            }
+            if (read_block(rd->log, rd->seq, rd->buf) != ESP_OK)
+            {
+                return ESP_FAIL;
+            }
+            const ring_block_t *blk = (const ring_block_t *)rd->buf;
+            if (!block_valid(rd->buf, rd->seq))
+            {
+                // 序列号不符是还没写过的当前块，其他情况是写到一半的块
+                if (blk->magic == RINGLOG_BLOCK_MAGIC && blk->seq == rd->seq)
+                {
+                    rd->skipped++;
+                }
+                rd->seq++;
+                continue;
+            }
+            rd->pos = sizeof(ring_block_t);
+            rd->used = blk->used;
+        }
+        if (rd->pos + 2 > rd->used)
+        {
+            rd->used = 0;
+            rd->seq++;
+            continue;
+        }
+        uint16_t n;
+        memcpy(&n, rd->buf + rd->pos, sizeof(n));
+        if (n > size)
+        {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        memcpy(data, rd->buf + rd->pos + sizeof(n), n);
+        rd->pos += sizeof(n) + n;
+        *len = n;
+        return ESP_OK;
+    }
+}
+
+void sd_ringlog_reader_close(sd_ringlog_reader_t *rd)
+{
+    free(rd->buf);
+    rd->buf = NULL;
+}
+
+/**
+ * @brief 追加延迟统计
+ */
+typedef struct
+{
+    uint32_t ops;   // 追加次数
+    int64_t sum_us; // 总延迟
+    int64_t max_us; // 最大延迟
+    uint32_t slow;  // 超过RINGLOG_BENCH_SLOW_US的次数
+} append_stats_t;
+
+static void stats_add(append_stats_t *s, int64_t us)
+{
+    s->ops++;
+    s->sum_us += us;
+    s->max_us = us > s->max_us ? us : s->max_us;
+    s->slow += us > RINGLOG_BENCH_SLOW_US;
+}
+
+static void print_row(const char *label, esp_err_t ret, const append_stats_t *s)
+{
+    if (ret != ESP_OK)
+    {
+        printf("  %-10s failed\n", label);
+        return;
+    }
+    printf("  %-10s %8u %8.1f %8.2f %6u\n", label, (unsigned)s->ops, (double)s->sum_us / s->ops,
+           s->max_us / 1000.0, (unsigned)s->slow);
+}
+
+static void make_record(uint8_t *record, uint32_t n)
+{
+    memset(record, 'a' + n % 26, RINGLOG_BENCH_RECORD);
+    memcpy(record, &n, sizeof(n));
+}
+
+/**
+ * @brief 按大小轮换文件，保留的文件总大小与循环日志相同，超出时删除最旧的文件
+ */
+static esp_err_t bench_rotation(uint32_t records, append_stats_t *s)
+{
+    const uint32_t keep = RINGLOG_BENCH_SIZE / RINGLOG_BENCH_ROTATE_SIZE;
+    uint8_t record[RINGLOG_BENCH_RECORD];
+    char path[32];
+    uint32_t file = 0;
+    size_t file_bytes = 0;
+    esp_err_t ret = ESP_OK;
+    snprintf(path, sizeof(path), MOUNT_POINT "/RL%06u.LOG", (unsigned)file);
+    FILE *f = fopen(path, "w");
+    if (f == NULL)
+    {
+        return ESP_FAIL;
+    }
+    for (uint32_t n = 0; n < records && ret == ESP_OK; n++)
+    {
+        make_record(record, n);
+        int64_t start = esp_timer_get_time();
+        if (file_bytes + RINGLOG_BENCH_RECORD > RINGLOG_BENCH_ROTATE_SIZE)
+        {
+            fclose(f);
+            file++;
+            file_bytes = 0;
+            snprintf(path, sizeof(path), MOUNT_POINT "/RL%06u.LOG", (unsigned)file);
+            f = fopen(path, "w");
+            if (file >= keep)
+            {
+                snprintf(path, sizeof(path), MOUNT_POINT "/RL%06u.LOG", (unsigned)(file - keep));
+                unlink(path);
+            }
+            if (f == NULL)
+            {
+                return ESP_FAIL;
+            }
+        }
+        if (fwrite(record, 1, sizeof(record), f) != sizeof(record))
+        {
+            ret = ESP_FAIL;
+        }
+        file_bytes += sizeof(record);
+        if ((n + 1) % RINGLOG_BENCH_FLUSH_EVERY == 0 && (fflush(f) != 0 || fsync(fileno(f)) != 0))
+        {
+            ret = ESP_FAIL;
+        }
+        stats_add(s, esp_timer_get_time() - start);
+    }
+    fclose(f);
+    for (uint32_t i = file >= keep ? file - keep + 1 : 0; i <= file; i++)
+    {
+        snprintf(path, sizeof(path), MOUNT_POINT "/RL%06u.LOG", (unsigned)i);
+        unlink(path);
+    }
+    return ret;
+}
+
+void sd_ringlog_bench_run(sdmmc_card_t *card)
+{
+    const uint32_t records = (uint32_t)((uint64_t)RINGLOG_BENCH_SIZE * RINGLOG_BENCH_WRAPS / RINGLOG_BENCH_RECORD);
+    uint8_t record[RINGLOG_BENCH_RECORD];
+
+    printf("\nRing log vs file rotation (%u KB retained, %u B records, flush every %u, %u wraps):\n",
+           RINGLOG_BENCH_SIZE / 1024, RINGLOG_BENCH_RECORD, RINGLOG_BENCH_FLUSH_EVERY, RINGLOG_BENCH_WRAPS);
+    printf("  %-10s %8s %8s %8s %6s\n", "method", "appends", "avg us", "max ms", ">10ms");
+
+    // 日志对象包含FIL，放在堆上以免占用主任务的栈
+    sd_ringlog_t *r = calloc(1, sizeof(sd_ringlog_t));
+    append_stats_t ring_stats = {0};
+    esp_err_t ret = r == NULL ? ESP_ERR_NO_MEM : sd_ringlog_open(r, card, RINGLOG_BENCH_NAME, RINGLOG_BENCH_SIZE);
+    if (ret == ESP_OK)
+    {
+        for (uint32_t n = 0; n < records && ret == ESP_OK; n++)
+        {
+            make_record(record, n);
+            int64_t start = esp_timer_get_time();
+            ret = sd_ringlog_append(r, record, sizeof(record));
+            if (ret == ESP_OK && (n + 1) % RINGLOG_BENCH_FLUSH_EVERY == 0)
+            {
+                ret = sd_ringlog_flush(r);
+            }
+            stats_add(&ring_stats, esp_timer_get_time() - start);
+        }
+    }
+    print_row("ring log", ret, &ring_stats);
+
+    append_stats_t rotate_stats = {0};
+    print_row("rotation", bench_rotation(records, &rotate_stats), &rotate_stats);
+
+    // 从最旧到最新读回，记录编号应连续且以最后写入的记录结束
+    if (ret == ESP_OK)
+    {
+        sd_ringlog_reader_t rd;
+        uint32_t count = 0;
+        uint32_t first = 0;
+        uint32_t prev = 0;
+        bool ordered = true;
+        int64_t start = esp_timer_get_time();
+        ret = sd_ringlog_reader_open(&rd, r);
+        size_t len;
+        while (ret == ESP_OK && (ret = sd_ringlog_read(&rd, record, sizeof(record), &len)) == ESP_OK)
+        {
+            uint32_t n;
+            memcpy(&n, record, sizeof(n));
+            if (count == 0)
+            {
+                first = n;
+            }
+            else if (n != prev + 1)
+            {
+                ordered = false;
+            }
+            prev = n;
+            count++;
+        }
+        int64_t read_us = esp_timer_get_time() - start;
+        if (ret == ESP_ERR_NOT_FOUND)
+        {
+            printf("  reader: %u records #%u..#%u in %.1f ms, %s, %u blocks skipped\n", (unsigned)count,
+                   (unsigned)first, (unsigned)prev, read_us / 1000.0,
+                   ordered && prev == records - 1 ? "in order" : "OUT OF ORDER", (unsigned)rd.skipped);
+        }
+        sd_ringlog_reader_close(&rd);
+    }
+    if (r != NULL && r->buf != NULL)
+    {
+        printf("  ring log: %u block writes, header updated %u times\n", (unsigned)r->block_writes,
+               (unsigned)r->hdr_writes);
+        sd_ringlog_close(r);
+    }
+    printf("\n");
+
+    char path[24];
+    snprintf(path, sizeof(path), "%d:/%s", ff_diskio_get_pdrv_card(card), RINGLOG_BENCH_NAME);
+    f_unlink(path);
+    free(r);
+}
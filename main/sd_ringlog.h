@@ -0,0 +1,128 @@
+/*
+ * 固定大小的循环日志文件
+ *
+ * 一个预先分配好的文件用作环形缓冲区，写满后覆盖最旧的数据。
+ * 文件大小不变，FAT和目录项在打开后不再修改，不会像删除旧文件那样反复分配和释放簇。
+ *
+ * 文件布局：
+ *   [头（两份，各512字节）][块0][块1]...[块N-1]
+ * 记录按到达顺序打包在4KB的块中，不跨块。每个块有自己的块头（块序列号、已用字节数、CRC），
+ * 序列号为s的块位于第(s % N)块，因此：
+ * - 当前块（head）为最新序列号所在的块，最旧的块（tail）为head的下一块
+ * - 回绕次数为序列号除以N
+ * 文件头记录head、tail、回绕次数和最新序列号，两份交替写入，每隔若干块以及刷新和关闭时更新。
+ * 打开时从文件头记录的位置向后检查块序列号，找回文件头之后写入的块。
+ *
+ * 写入只以整块为单位（块对齐，直接写入卡），刷新时把不满的当前块整块写出，之后继续填充并重写。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "sdmmc_cmd.h"
+#include "ff.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SD_RINGLOG_BLOCK_SIZE 4096                        // 块大小
+#define SD_RINGLOG_MAX_RECORD (SD_RINGLOG_BLOCK_SIZE - 18) // 单条记录的最大长度（块头16字节，长度2字节）
+
+/**
+ * @brief 循环日志
+ */
+typedef struct
+{
+    FIL fil;                   // 日志文件
+    uint32_t blocks;           // 数据块数
+    uint32_t seq;              // 当前块的序列号（从0开始）
+    uint8_t *buf;              // 当前块缓冲区
+    uint8_t *hdr_buf;          // 读写文件头用的扇区缓冲区
+    size_t used;               // 当前块已用字节数（含块头）
+    bool dirty;                // 当前块有未写出的记录
+    uint32_t hdr_writes;       // 文件头的写入次数，决定下一次写哪一份
+    uint32_t blocks_since_hdr; // 上次更新文件头之后写完的块数
+
+    // 统计信息
+    uint32_t records;      // 追加的记录数
+    uint32_t block_writes; // 写卡的块数（包括刷新时写出的不满的块）
+} sd_ringlog_t;
+
+/**
+ * @brief 从最旧到最新遍历记录的读取器
+ */
+typedef struct
+{
+    sd_ringlog_t *log; // 日志
+    uint8_t *buf;      // 当前读取的块
+    uint32_t seq;      // 当前块的序列号
+    size_t pos;        // 当前块中下一条记录的位置
+    size_t used;       // 当前块的已用字节数，0表示需要读取下一块
+    uint32_t skipped;  // 因校验失败跳过的块数
+} sd_ringlog_reader_t;
+
+/**
+ * @brief 打开卡根目录下的循环日志，不存在或大小不同时按size重新创建
+ *
+ * @param r    日志
+ * @param card 已通过sd_mount挂载的SD卡
+ * @param name 文件名（8.3格式，位于根目录）
+ * @param size 数据区大小（字节，向下取整到块）
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 少于两块，ESP_ERR_NOT_FOUND 卡未挂载到FATFS，
+ *         ESP_ERR_NO_MEM 内存或空间不足，ESP_FAIL 文件操作失败
+ */
+esp_err_t sd_ringlog_open(sd_ringlog_t *r, sdmmc_card_t *card, const char *name, size_t size);
+
+/**
+ * @brief 追加一条记录，当前块写满时写卡，必要时覆盖最旧的块
+ *
+ * @return ESP_OK 成功，ESP_ERR_INVALID_SIZE 记录过长，ESP_FAIL 写入失败
+ */
+esp_err_t sd_ringlog_append(sd_ringlog_t *r, const void *data, size_t len);
+
+/**
+ * @brief 写出不满的当前块并更新文件头
+ */
+esp_err_t sd_ringlog_flush(sd_ringlog_t *r);
+
+/**
+ * @brief 刷新并关闭日志
+ */
+esp_err_t sd_ringlog_close(sd_ringlog_t *r);
+
+/**
+ * @brief 从最旧的记录开始读取（先刷新日志，读取期间不能追加）
+ */
+esp_err_t sd_ringlog_reader_open(sd_ringlog_reader_t *rd, sd_ringlog_t *r);
+
+/**
+ * @brief 读取下一条记录
+ *
+ * @param rd   读取器
+ * @param data 输出缓冲区
+ * @param size 缓冲区大小
+ * @param len  输出：记录长度
+ * @return ESP_OK 成功，ESP_ERR_NOT_FOUND 已读完，ESP_ERR_INVALID_SIZE 缓冲区太小，ESP_FAIL 读取失败
+ */
+esp_err_t sd_ringlog_read(sd_ringlog_reader_t *rd, void *data, size_t size, size_t *len);
+
+/**
+ * @brief 释放读取器
+ */
+void sd_ringlog_reader_close(sd_ringlog_reader_t *rd);
+
+/**
+ * @brief 对比循环日志与按大小轮换、删除最旧文件的方式在多次回绕下的追加延迟
+ *
+ * @param card 已通过sd_mount挂载的SD卡
+ */
+void sd_ringlog_bench_run(sdmmc_card_t *card);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,325 @@
+/*
+ * 连续录制的流式写入会话实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "sd_stream.h"
+
+#define STREAM_WRITER_STACK_SIZE 3072
+#define STREAM_BENCH_NAME "STREAM.BIN"             // 测试区域占位文件
+#define STREAM_BENCH_REGION_SIZE (4 * 1024 * 1024) // 测试区域大小
+#define STREAM_BENCH_FEED_BLOCKS 16                // 测试中每次送入的扇区数
+
+static const char *TAG = "sd_stream";
+
+typedef struct
+{
+    uint8_t *buf;    // 缓冲区，NULL表示退出
+    uint32_t sector; // 区域内起始扇区
+    size_t count;    // 扇区数
+} stream_chunk_t;
+
+/**
+ * @brief 把当前缓冲区交给写入任务并取一个空闲缓冲区（可能阻塞）
+ *
+ * 调用者必须持有s->lock。
+ */
+static void submit_current(sd_stream_t *s)
+{
+    if (s->cur_blocks == 0)
+    {
+        return;
+    }
+    stream_chunk_t chunk = {.buf = s->cur, .sector = s->cur_sector, .count = s->cur_blocks};
+    xQueueSend(s->full_q, &chunk, portMAX_DELAY);
+    s->cur_sector += s->cur_blocks;
+    s->cur_blocks = 0;
+    int64_t start = esp_timer_get_time();
+    xQueueReceive(s->free_q, &s->cur, portMAX_DELAY);
+    s->stall_us += esp_timer_get_time() - start;
+}
+
+/**
+ * @brief 后台写入任务：每个缓冲区用一条CMD25写入，空闲时写出不满的缓冲区
+ */
+static void writer_task(void *arg)
+{
+    sd_stream_t *s = arg;
+    TickType_t idle_ticks = portMAX_DELAY;
+    if (s->config.idle_ms > 0)
+    {
+        idle_ticks = pdMS_TO_TICKS(s->config.idle_ms);
+        idle_ticks = idle_ticks > 0 ? idle_ticks : 1;
+    }
+
+    stream_chunk_t chunk;
+    while (true)
+    {
+        if (xQueueReceive(s->full_q, &chunk, idle_ticks) != pdTRUE)
+        {
+            // 写入任务空闲时另一个缓冲区一定在空闲队列中，submit_current不会阻塞；
+            // 调用者正持有锁时说明有新数据，跳过本次检查
+            if (xSemaphoreTake(s->lock, 0) == pdTRUE)
+            {
+                if (s->cur_blocks > 0 &&
+                    esp_timer_get_time() - s->last_feed_us >= (int64_t)s->config.idle_ms * 1000)
+                {
+                    s->idle_flushes++;
+                    submit_current(s);
+                }
+                xSemaphoreGive(s->lock);
+            }
+            continue;
+        }
+        if (chunk.buf == NULL)
+        {
+            break;
+        }
+        if (s->write_err == ESP_OK)
+        {
+            int64_t start = esp_timer_get_time();
+            esp_err_t ret = ESP_OK;
+            if (s->config.pre_erase)
+            {
+                ret = sd_raw_set_pre_erase(&s->region, chunk.count);
+            }
+            if (ret == ESP_OK)
+            {
+                ret = sd_raw_write(&s->region, chunk.sector, chunk.buf, chunk.count);
+            }
+            s->write_us += esp_timer_get_time() - start;
+            if (ret != ESP_OK)
+            {
+                ESP_LOGE(TAG, "Write of %u sectors at %u failed (%s)", (unsigned)chunk.count,
+                         (unsigned)chunk.sector, esp_err_to_name(ret));
+                s->write_err = ret;
+            }
+            s->cmds++;
+            s->blocks += chunk.count;
+        }
+        xQueueSend(s->free_q, &chunk.buf, portMAX_DELAY);
+    }
+    xSemaphoreGive(s->done);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief 释放会话资源
+ */
+static void release_session(sd_stream_t *s)
+{
+    for (int i = 0; i < SD_STREAM_NBUFS; i++)
+    {
+        free(s->bufs[i]);
+        s->bufs[i] = NULL;
+    }
+    if (s->free_q)
+    {
+        vQueueDelete(s->free_q);
+        s->free_q = NULL;
+    }
+    if (s->full_q)
+    {
+        vQueueDelete(s->full_q);
+        s->full_q = NULL;
+    }
+    if (s->lock)
+    {
+        vSemaphoreDelete(s->lock);
+        s->lock = NULL;
+    }
+    if (s->done)
+    {
+        vSemaphoreDelete(s->done);
+        s->done = NULL;
+    }
+}
+
+esp_err_t sd_stream_open(sd_stream_t *s, const sd_raw_region_t *region, const sd_stream_config_t *config)
+{
+    memset(s, 0, sizeof(*s));
+    if (region->card == NULL || config->span_blocks == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s->region = *region;
+    s->config = *config;
+    s->write_err = ESP_OK;
+
+    for (int i = 0; i < SD_STREAM_NBUFS; i++)
+    {
+        s->bufs[i] = heap_caps_malloc(config->span_blocks * SD_RAW_SECTOR_SIZE, MALLOC_CAP_DMA);
+        if (s->bufs[i] == NULL)
+        {
+            ESP_LOGE(TAG, "Failed to allocate %u-sector staging buffer", (unsigned)config->span_blocks);
+            release_session(s);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    s->cur = s->bufs[0];
+
+    s->free_q = xQueueCreate(SD_STREAM_NBUFS, sizeof(uint8_t *));
+    s->full_q = xQueueCreate(SD_STREAM_NBUFS + 1, sizeof(stream_chunk_t));
+    s->lock = xSemaphoreCreateMutex();
+    s->done = xSemaphoreCreateBinary();
+    if (s->free_q == NULL || s->full_q == NULL || s->lock == NULL || s->done == NULL)
+    {
+        release_session(s);
+        return ESP_ERR_NO_MEM;
+    }
+    for (int i = 1; i < SD_STREAM_NBUFS; i++)
+    {
+        xQueueSend(s->free_q, &s->bufs[i], 0);
+    }
+    if (xTaskCreatePinnedToCore(writer_task, "sd_stream_wr", STREAM_WRITER_STACK_SIZE, s,
+                                uxTaskPriorityGet(NULL), NULL, tskNO_AFFINITY) != pdPASS)
+    {
+        release_session(s);
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t sd_stream_write(sd_stream_t *s, const void *buf, size_t count)
+{
+    if (s->write_err != ESP_OK)
+    {
+        return s->write_err;
+    }
+    xSemaphoreTake(s->lock, portMAX_DELAY);
+    if (s->cur_sector + s->cur_blocks + count > s->region.sectors)
+    {
+        xSemaphoreGive(s->lock);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    const uint8_t *src = buf;
+    while (count > 0)
+    {
+        size_t n = s->config.span_blocks - s->cur_blocks;
+        if (n > count)
+        {
+            n = count;
+        }
+        memcpy(s->cur + s->cur_blocks * SD_RAW_SECTOR_SIZE, src, n * SD_RAW_SECTOR_SIZE);
+        s->cur_blocks += n;
+        src += n * SD_RAW_SECTOR_SIZE;
+        count -= n;
+        // 缓冲区满或到达区域末尾时结束这条命令
+        if (s->cur_blocks == s->config.span_blocks || s->cur_sector + s->cur_blocks == s->region.sectors)
+        {
+            submit_current(s);
+        }
+    }
+    s->last_feed_us = esp_timer_get_time();
+    xSemaphoreGive(s->lock);
+    return s->write_err;
+}
+
+esp_err_t sd_stream_close(sd_stream_t *s)
+{
+    xSemaphoreTake(s->lock, portMAX_DELAY);
+    submit_current(s);
+    xSemaphoreGive(s->lock);
+
+    // 通知写入任务退出并等待剩余数据写完
+    stream_chunk_t stop = {.buf = NULL};
+    xQueueSend(s->full_q, &stop, portMAX_DELAY);
+    xSemaphoreTake(s->done, portMAX_DELAY);
+    esp_err_t ret = s->write_err;
+    release_session(s);
+    return ret;
+}
+
+static void print_row(const char *label, esp_err_t ret, size_t blocks, int64_t us, uint32_t cmds,
+                      int64_t stall_us)
+{
+    if (ret != ESP_OK)
+    {
+        printf("  %-18s failed (%s)\n", label, esp_err_to_name(ret));
+        return;
+    }
+    printf("  %-18s %8.2f %8u %10.1f %9.1f\n", label,
+           (blocks * (double)SD_RAW_SECTOR_SIZE / (1024 * 1024)) / (us / 1000000.0), (unsigned)cmds,
+           cmds ? (double)blocks / cmds : 0.0, stall_us / 1000.0);
+}
+
+void sd_stream_bench_run(sdmmc_card_t *card)
+{
+    sd_raw_region_t region;
+    if (sd_raw_reserve(card, STREAM_BENCH_NAME, STREAM_BENCH_REGION_SIZE, &region) != ESP_OK)
+    {
+        return;
+    }
+    uint8_t *feed = heap_caps_malloc(STREAM_BENCH_FEED_BLOCKS * SD_RAW_SECTOR_SIZE, MALLOC_CAP_DMA);
+    if (feed == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate feed buffer");
+        sd_raw_release(&region);
+        return;
+    }
+    for (size_t i = 0; i < STREAM_BENCH_FEED_BLOCKS * SD_RAW_SECTOR_SIZE; i++)
+    {
+        feed[i] = i & 0xFF;
+    }
+    size_t total = region.sectors - region.sectors % STREAM_BENCH_FEED_BLOCKS;
+
+    printf("\nStreaming write (%u KB region, %u KB per feed):\n", (unsigned)(total / 2),
+           (unsigned)(STREAM_BENCH_FEED_BLOCKS / 2));
+    printf("  %-18s %8s %8s %10s %9s\n", "mode", "MB/s", "CMD25", "blocks/cmd", "stall ms");
+
+    // 基准：每次送入的数据用一条CMD25写入，写完再送下一块
+    esp_err_t ret = ESP_OK;
+    uint32_t cmds = 0;
+    int64_t start = esp_timer_get_time();
+    for (size_t sector = 0; sector < total && ret == ESP_OK; sector += STREAM_BENCH_FEED_BLOCKS)
+    {
+        ret = sd_raw_write(&region, sector, feed, STREAM_BENCH_FEED_BLOCKS);
+        cmds++;
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    print_row("chunked", ret, total, elapsed, cmds, elapsed);
+
+    static const struct
+    {
+        const char *label;
+        size_t span_blocks;
+        bool pre_erase;
+    } modes[] = {
+        {"stream 32K", 64, false},
+        {"stream 64K", 128, false},
+        {"stream 64K+erase", 128, true},
+    };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+    {
+        sd_stream_config_t config = SD_STREAM_CONFIG_DEFAULT();
+        config.span_blocks = modes[m].span_blocks;
+        config.pre_erase = modes[m].pre_erase;
+        sd_stream_t s;
+        start = esp_timer_get_time();
+        ret = sd_stream_open(&s, &region, &config);
+        if (ret != ESP_OK)
+        {
+            print_row(modes[m].label, ret, 0, 0, 0, 0);
+            continue;
+        }
+        for (size_t sector = 0; sector < total && ret == ESP_OK; sector += STREAM_BENCH_FEED_BLOCKS)
+        {
+            ret = sd_stream_write(&s, feed, STREAM_BENCH_FEED_BLOCKS);
+        }
+        // 关闭后统计信息仍保留在会话结构体中
+        esp_err_t close_ret = sd_stream_close(&s);
+        elapsed = esp_timer_get_time() - start;
+        print_row(modes[m].label, ret != ESP_OK ? ret : close_ret, s.blocks, elapsed, s.cmds, s.stall_us);
+    }
+    printf("  stall ms: time the feeding task waited for the card\n\n");
+
+    free(feed);
+    sd_raw_release(&region);
+}
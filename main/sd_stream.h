@@ -0,0 +1,115 @@
+/*
+ * 连续录制的流式写入会话
+ *
+ * 向预留区域（见sd_raw.h）顺序追加扇区。调用者按到达顺序送入数据块，
+ * 会话把它们拼接到暂存缓冲区中，只在以下情况结束一条CMD25：
+ * - 暂存缓冲区已满（span_blocks个扇区）
+ * - 超过idle_ms没有新数据
+ * - 到达区域末尾，或关闭会话
+ *
+ * 后台写入任务写一个缓冲区的同时调用者填充另一个，总线在持续录制时几乎不空闲。
+ *
+ * 注意：ESP-IDF的主机驱动要求一条多块命令的全部数据在发出命令时已经就绪，
+ * 并在传输结束后自动发送CMD12，因此无法在一条CMD25进行中追加数据。
+ * 会话用尽可能长的命令加双缓冲来接近不间断的多块写入，并可用ACMD23预擦除。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "sd_raw.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SD_STREAM_NBUFS 2 // 暂存缓冲区数量
+
+/**
+ * @brief 会话配置
+ */
+typedef struct
+{
+    size_t span_blocks; // 每个暂存缓冲区的扇区数，即一条CMD25最多写入的扇区数
+    uint32_t idle_ms;   // 超过该时间没有新数据时写出不满的缓冲区，0表示只在满或关闭时写出
+    bool pre_erase;     // 每条CMD25之前发送ACMD23预擦除
+} sd_stream_config_t;
+
+#define SD_STREAM_CONFIG_DEFAULT() { \
+    .span_blocks = 128,              \
+    .idle_ms = 100,                  \
+    .pre_erase = true,               \
+}
+
+/**
+ * @brief 流式写入会话
+ */
+typedef struct
+{
+    sd_raw_region_t region;            // 目标区域
+    sd_stream_config_t config;         // 配置
+    uint8_t *bufs[SD_STREAM_NBUFS];    // 暂存缓冲区（DMA可用）
+    uint8_t *cur;                      // 当前正在填充的缓冲区
+    size_t cur_blocks;                 // 当前缓冲区已填充的扇区数
+    uint32_t cur_sector;               // 当前缓冲区对应的区域内起始扇区
+    int64_t last_feed_us;              // 最近一次送入数据的时刻
+    SemaphoreHandle_t lock;            // 保护当前缓冲区，调用者与空闲写出互斥
+    QueueHandle_t free_q;              // 空闲缓冲区队列
+    QueueHandle_t full_q;              // 待写入缓冲区队列
+    SemaphoreHandle_t done;            // 写入任务退出信号
+    volatile esp_err_t write_err;      // 后台写入任务遇到的错误
+
+    // 统计信息
+    uint32_t cmds;         // 发出的CMD25数
+    uint32_t blocks;       // 写入的扇区数
+    uint32_t idle_flushes; // 因空闲写出不满缓冲区的次数
+    int64_t stall_us;      // 调用者等待空闲缓冲区的累计时间
+    int64_t write_us;      // 后台任务写卡累计时间
+} sd_stream_t;
+
+/**
+ * @brief 在区域开头打开会话并启动后台写入任务
+ *
+ * @param s      会话
+ * @param region 已预留的区域（复制到会话中）
+ * @param config 配置
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数错误，ESP_ERR_NO_MEM 内存不足
+ */
+esp_err_t sd_stream_open(sd_stream_t *s, const sd_raw_region_t *region, const sd_stream_config_t *config);
+
+/**
+ * @brief 追加count个扇区
+ *
+ * 数据被复制到暂存缓冲区，调用返回后buf即可重用。两个缓冲区都在写卡时阻塞。
+ *
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_INVALID_SIZE 区域剩余空间不足，本次数据没有写入
+ *  - 其他错误码来自之前的写入
+ */
+esp_err_t sd_stream_write(sd_stream_t *s, const void *buf, size_t count);
+
+/**
+ * @brief 写出剩余数据，等待写入任务退出并释放资源
+ *
+ * @return 会话期间第一个写入错误，或ESP_OK
+ */
+esp_err_t sd_stream_close(sd_stream_t *s);
+
+/**
+ * @brief 对比逐块调用sd_raw_write（每块一条CMD25和CMD12）与流式会话的持续写入吞吐量
+ *
+ * @param card 已通过sd_mount挂载的SD卡
+ */
+void sd_stream_bench_run(sdmmc_card_t *card);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,59 @@
+/*
+ * I/O热路径跟踪宏
+ *
+ * ESP_LOGD即使被运行时日志级别过滤，每次调用仍需要检查日志级别并计算参数，
+ * 在逐块读写的循环中会累积可观的开销。SD_TRACE按模块在编译期开关：
+ * 未启用的模块中，SD_TRACE展开为if (0)语句，参数不会被计算，
+ * 编译器会将其完全删除，但格式字符串和参数类型仍会被检查。
+ *
+ * 用法：
+ *   SD_TRACE(BENCH, TAG, "Read %d bytes", n);
+ *
+ * 每个模块对应一个SD_TRACE_<模块名>宏（取值0或1），
+ * 由menuconfig中的EXAMPLE_TRACE_<模块名>选项控制。
+ * 启用后以DEBUG级别输出，仍受运行时日志级别过滤，
+ * 需要调用esp_log_level_set(TAG, ESP_LOG_DEBUG)才能看到输出。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 速度测试读写循环（sd_bench.c）
+#ifdef CONFIG_EXAMPLE_TRACE_BENCH
+#define SD_TRACE_BENCH 1
+#else
+#define SD_TRACE_BENCH 0
+#endif
+
+/**
+ * @brief 热路径跟踪输出，模块未启用时编译为空
+ *
+ * 注意：不使用ESP_LOGD，因为它还受CONFIG_LOG_MAXIMUM_LEVEL限制；
+ * 这里编译期开关只由模块选项决定。
+ */
+#define SD_TRACE(module, tag, format, ...)                                \
+    do                                                                    \
+    {                                                                     \
+        if (SD_TRACE_##module)                                            \
+        {                                                                 \
+            ESP_LOG_LEVEL(ESP_LOG_DEBUG, tag, format, ##__VA_ARGS__);     \
+        }                                                                 \
+    } while (0)
+
+/**
+ * @brief 测量每个数据块的日志开销：启用、运行时过滤、编译期移除三种情况
+ *
+ * 不需要挂载SD卡，结果通过printf输出。
+ */
+void sd_trace_bench_run(void);
+
+#ifdef __cplusplus
+}
+#endif
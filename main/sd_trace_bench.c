@@ -0,0 +1,142 @@
+/*
+ * 热路径日志开销测试
+ *
+ * 在模拟逐块读写的循环（每块拷贝512字节）中分别测量：
+ * 1. 基准：不带任何日志
+ * 2. 编译期移除：SD_TRACE所在模块未启用
+ * 3. 运行时过滤：日志已编译进代码，但运行时级别为INFO，DEBUG输出被过滤
+ * 4. 启用（空输出）：运行时级别为DEBUG，输出重定向到空函数，只计算格式化开销
+ * 5. 启用（UART）：运行时级别为DEBUG，实际通过控制台输出
+ *
+ * 每种情况的单块开销 = (该情况耗时 - 基准耗时) / 块数。
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sd_trace.h"
+
+// 本文件固定使用的两个模块开关，不受menuconfig影响，保证对比条件一致
+#define SD_TRACE_TRACEBENCH_OFF 0
+#define SD_TRACE_TRACEBENCH_ON 1
+
+#define BLOCK_SIZE 512         // 模拟的数据块大小
+#define FAST_ITERATIONS 20000  // 基准、编译期移除和运行时过滤的循环次数
+#define FORMAT_ITERATIONS 2000 // 空输出情况的循环次数
+#define UART_ITERATIONS 32     // UART输出情况的循环次数（避免刷屏）
+
+static const char *TAG = "sd_trace";
+
+typedef enum
+{
+    VARIANT_BASELINE = 0,
+    VARIANT_COMPILED_OUT,
+    VARIANT_RUNTIME_FILTERED,
+    VARIANT_ENABLED,
+} variant_t;
+
+static uint8_t s_src[BLOCK_SIZE];
+static uint8_t s_dst[BLOCK_SIZE];
+
+/**
+ * @brief 把日志格式化到暂存缓冲区后丢弃，用于只测量格式化开销（不含UART输出）
+ */
+static int null_vprintf(const char *format, va_list args)
+{
+    static char scratch[160];
+    return vsnprintf(scratch, sizeof(scratch), format, args);
+}
+
+/**
+ * @brief 运行一次模拟读循环，返回耗时（微秒）
+ *
+ * 使用switch把四种情况写成各自独立的循环，
+ * 避免在循环内判断情况类型影响测量结果。
+ */
+static int64_t run_loop(variant_t variant, int iterations)
+{
+    size_t total = 0;
+    int64_t start = esp_timer_get_time();
+    switch (variant)
+    {
+    case VARIANT_BASELINE:
+        for (int i = 0; i < iterations; i++)
+        {
+            memcpy(s_dst, s_src, BLOCK_SIZE);
+            total += BLOCK_SIZE;
+        }
+        break;
+    case VARIANT_COMPILED_OUT:
+        for (int i = 0; i < iterations; i++)
+        {
+            memcpy(s_dst, s_src, BLOCK_SIZE);
+            SD_TRACE(TRACEBENCH_OFF, TAG, "Read %d bytes, total %d/%d", BLOCK_SIZE, (int)(total + BLOCK_SIZE), iterations * BLOCK_SIZE);
+            total += BLOCK_SIZE;
+        }
+        break;
+    case VARIANT_RUNTIME_FILTERED:
+    case VARIANT_ENABLED:
+        for (int i = 0; i < iterations; i++)
+        {
+            memcpy(s_dst, s_src, BLOCK_SIZE);
+            SD_TRACE(TRACEBENCH_ON, TAG, "Read %d bytes, total %d/%d", BLOCK_SIZE, (int)(total + BLOCK_SIZE), iterations * BLOCK_SIZE);
+            total += BLOCK_SIZE;
+        }
+        break;
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    // 防止编译器把拷贝优化掉
+    if (s_dst[total % BLOCK_SIZE] != s_src[total % BLOCK_SIZE])
+    {
+        printf("unexpected data mismatch\n");
+    }
+    return elapsed;
+}
+
+/**
+ * @brief 打印一行结果：总耗时和相对基准的单块开销
+ */
+static void print_row(const char *name, int iterations, int64_t elapsed_us, float baseline_per_block_us)
+{
+    float per_block = (float)elapsed_us / iterations;
+    printf("%-26s %8d %12lld %14.3f %14.3f\n", name, iterations, (long long)elapsed_us,
+           per_block, per_block - baseline_per_block_us);
+}
+
+void sd_trace_bench_run(void)
+{
+    esp_log_level_t saved_level = esp_log_level_get(TAG);
+    memset(s_src, 0x5A, sizeof(s_src));
+
+    // 预热一次，使缓存和计时器状态稳定
+    run_loop(VARIANT_BASELINE, FAST_ITERATIONS / 10);
+
+    int64_t baseline = run_loop(VARIANT_BASELINE, FAST_ITERATIONS);
+    float baseline_per_block = (float)baseline / FAST_ITERATIONS;
+
+    int64_t compiled_out = run_loop(VARIANT_COMPILED_OUT, FAST_ITERATIONS);
+
+    esp_log_level_set(TAG, ESP_LOG_INFO);
+    int64_t filtered = run_loop(VARIANT_RUNTIME_FILTERED, FAST_ITERATIONS);
+
+    esp_log_level_set(TAG, ESP_LOG_DEBUG);
+    vprintf_like_t saved_vprintf = esp_log_set_vprintf(null_vprintf);
+    int64_t enabled_null = run_loop(VARIANT_ENABLED, FORMAT_ITERATIONS);
+    esp_log_set_vprintf(saved_vprintf);
+
+    int64_t enabled_uart = run_loop(VARIANT_ENABLED, UART_ITERATIONS);
+    esp_log_level_set(TAG, saved_level);
+
+    printf("\nPer-block logging overhead (%d-byte blocks):\n", BLOCK_SIZE);
+    printf("%-26s %8s %12s %14s %14s\n", "variant", "blocks", "total us", "us/block", "overhead us");
+    print_row("baseline (no log)", FAST_ITERATIONS, baseline, baseline_per_block);
+    print_row("SD_TRACE compiled out", FAST_ITERATIONS, compiled_out, baseline_per_block);
+    print_row("runtime filtered", FAST_ITERATIONS, filtered, baseline_per_block);
+    print_row("enabled, null sink", FORMAT_ITERATIONS, enabled_null, baseline_per_block);
+    print_row("enabled, console", UART_ITERATIONS, enabled_uart, baseline_per_block);
+    printf("\n");
+}
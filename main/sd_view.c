@@ -0,0 +1,381 @@
+/*
+ * 分页文件视图实现
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <sys/unistd.h>
+#include <sys/stat.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "sd_view.h"
+#include "sd_bench.h"
+
+#define VIEW_BENCH_PAGE_SIZE 4096        // 测试页大小
+#define VIEW_BENCH_OPS 2000              // 每种访问模式的访问次数
+#define VIEW_BENCH_HOT_BYTES (64 * 1024) // 热点区域大小（文件开头）
+#define VIEW_BENCH_HOT_PCT 90            // 落在热点区域的访问比例
+
+static const char *TAG = "sd_view";
+
+uint32_t sd_view_page_count(const sd_view_t *v)
+{
+    return (v->length + v->page_size - 1) / v->page_size;
+}
+
+/**
+ * @brief 页在视图中的有效字节数（最后一页可能不满）
+ */
+static size_t page_bytes(const sd_view_t *v, uint32_t page_no)
+{
+    uint32_t start = page_no * v->page_size;
+    return v->length - start < v->page_size ? v->length - start : v->page_size;
+}
+
+static esp_err_t write_back(sd_view_t *v, sd_view_page_t *p)
+{
+    size_t n = page_bytes(v, p->page_no);
+    if (fseek(v->f, v->offset + p->page_no * v->page_size, SEEK_SET) != 0 ||
+        fwrite(p->data, 1, n, v->f) != n)
+    {
+        ESP_LOGE(TAG, "Failed to write back page %u (errno: %d)", (unsigned)p->page_no, errno);
+        return ESP_FAIL;
+    }
+    p->dirty = false;
+    v->writebacks++;
+    return ESP_OK;
+}
+
+static esp_err_t load(sd_view_t *v, sd_view_page_t *p, uint32_t page_no)
+{
+    size_t n = page_bytes(v, page_no);
+    if (fseek(v->f, v->offset + page_no * v->page_size, SEEK_SET) != 0 ||
+        fread(p->data, 1, n, v->f) != n)
+    {
+        ESP_LOGE(TAG, "Failed to read page %u (errno: %d)", (unsigned)page_no, errno);
+        return ESP_FAIL;
+    }
+    memset(p->data + n, 0, v->page_size - n);
+    p->page_no = page_no;
+    p->valid = true;
+    p->dirty = false;
+    return ESP_OK;
+}
+
+esp_err_t sd_view_open(sd_view_t *v, const char *path, uint32_t offset, uint32_t length,
+                       size_t page_size, int npages, bool writable, uint32_t caps)
+{
+    memset(v, 0, sizeof(*v));
+    if (page_size == 0 || npages <= 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct stat st;
+    if (stat(path, &st) != 0)
+    {
+        ESP_LOGE(TAG, "Failed to stat %s (errno: %d)", path, errno);
+        return ESP_FAIL;
+    }
+    uint32_t file_size = st.st_size;
+    if (offset > file_size || (length > 0 && length > file_size - offset))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    v->offset = offset;
+    v->length = length > 0 ? length : file_size - offset;
+    v->page_size = page_size;
+    v->npages = npages;
+    v->writable = writable;
+    v->io_err = ESP_OK;
+
+    v->pool = heap_caps_malloc((size_t)npages * page_size, caps);
+    v->pages = calloc(npages, sizeof(sd_view_page_t));
+    if (v->pool == NULL || v->pages == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate %d pages of %u bytes", npages, (unsigned)page_size);
+        free(v->pool);
+        free(v->pages);
+        return ESP_ERR_NO_MEM;
+    }
+    for (int i = 0; i < npages; i++)
+    {
+        v->pages[i].data = v->pool + (size_t)i * page_size;
+    }
+
+    v->f = fopen(path, writable ? "r+" : "r");
+    if (v->f == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to open %s (errno: %d)", path, errno);
+        free(v->pool);
+        free(v->pages);
+        return ESP_FAIL;
+    }
+    // 页缓存已经是缓冲，整页读写直接交给FATFS
+    setvbuf(v->f, NULL, _IONBF, 0);
+    return ESP_OK;
+}
+
+void *sd_view_pin(sd_view_t *v, uint32_t page_no)
+{
+    if (page_no >= sd_view_page_count(v))
+    {
+        return NULL;
+    }
+    v->clock++;
+
+    // 查找缓存，同时记下最久未使用的未钉住页作为淘汰候选（空页优先）
+    sd_view_page_t *victim = NULL;
+    for (int i = 0; i < v->npages; i++)
+    {
+        sd_view_page_t *p = &v->pages[i];
+        if (p->valid && p->page_no == page_no)
+        {
+            p->pins++;
+            p->last_use = v->clock;
+            v->hits++;
+            return p->data;
+        }
+        if (p->pins == 0 && (victim == NULL || !p->valid ||
+                             (victim->valid && p->last_use < victim->last_use)))
+        {
+            victim = p;
+        }
+    }
+    if (victim == NULL)
+    {
+        ESP_LOGE(TAG, "All %d pages are pinned", v->npages);
+        return NULL;
+    }
+
+    v->misses++;
+    if (victim->valid && victim->dirty)
+    {
+        esp_err_t ret = write_back(v, victim);
+        if (ret != ESP_OK)
+        {
+            v->io_err = v->io_err == ESP_OK ? ret : v->io_err;
+            return NULL;
+        }
+    }
+    victim->valid = false;
+    esp_err_t ret = load(v, victim, page_no);
+    if (ret != ESP_OK)
+    {
+        v->io_err = v->io_err == ESP_OK ? ret : v->io_err;
+        return NULL;
+    }
+    victim->pins = 1;
+    victim->last_use = v->clock;
+    return victim->data;
+}
+
+void sd_view_unpin(sd_view_t *v, void *data, bool dirty)
+{
+    for (int i = 0; i < v->npages; i++)
+    {
+        sd_view_page_t *p = &v->pages[i];
+        if (p->data == data && p->pins > 0)
+        {
+            p->pins--;
+            // 只读视图中的修改不会写回
+            p->dirty |= dirty && v->writable;
+            return;
+        }
+    }
+    ESP_LOGW(TAG, "Unpin of a page that is not pinned");
+}
+
+esp_err_t sd_view_flush(sd_view_t *v)
+{
+    esp_err_t ret = ESP_OK;
+    for (int i = 0; i < v->npages; i++)
+    {
+        sd_view_page_t *p = &v->pages[i];
+        if (p->valid && p->dirty && write_back(v, p) != ESP_OK && ret == ESP_OK)
+        {
+            ret = ESP_FAIL;
+        }
+    }
+    if (v->writable && (fflush(v->f) != 0 || fsync(fileno(v->f)) != 0) && ret == ESP_OK)
+    {
+        ret = ESP_FAIL;
+    }
+    if (ret != ESP_OK && v->io_err == ESP_OK)
+    {
+        v->io_err = ret;
+    }
+    return ret;
+}
+
+esp_err_t sd_view_close(sd_view_t *v)
+{
+    sd_view_flush(v);
+    if (fclose(v->f) != 0 && v->io_err == ESP_OK)
+    {
+        v->io_err = ESP_FAIL;
+    }
+    v->f = NULL;
+    free(v->pool);
+    free(v->pages);
+    v->pool = NULL;
+    v->pages = NULL;
+    return v->io_err;
+}
+
+static uint32_t xorshift32(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+ * @brief 生成下一个访问的32位元素下标
+ */
+static uint32_t next_index(uint32_t *rng, uint32_t elems, bool hot)
+{
+    if (hot && xorshift32(rng) % 100 < VIEW_BENCH_HOT_PCT)
+    {
+        return xorshift32(rng) % (VIEW_BENCH_HOT_BYTES / sizeof(uint32_t));
+    }
+    return xorshift32(rng) % elems;
+}
+
+/**
+ * @brief 通过分页视图访问，返回每次访问的平均微秒数，失败返回负数
+ */
+static float run_view(const char *path, uint32_t elems, bool hot, bool update, int npages, uint32_t caps,
+                      sd_view_t *v)
+{
+    if (sd_view_open(v, path, 0, 0, VIEW_BENCH_PAGE_SIZE, npages, update, caps) != ESP_OK)
+    {
+        return -1;
+    }
+    uint32_t rng = 0x12345678;
+    int64_t start = esp_timer_get_time();
+    int done = 0;
+    for (; done < VIEW_BENCH_OPS; done++)
+    {
+        uint32_t offset = next_index(&rng, elems, hot) * sizeof(uint32_t);
+        uint8_t *page = sd_view_pin(v, offset / VIEW_BENCH_PAGE_SIZE);
+        if (page == NULL)
+        {
+            break;
+        }
+        uint32_t value;
+        memcpy(&value, page + offset % VIEW_BENCH_PAGE_SIZE, sizeof(value));
+        if (update)
+        {
+            value++;
+            memcpy(page + offset % VIEW_BENCH_PAGE_SIZE, &value, sizeof(value));
+        }
+        sd_view_unpin(v, page, update);
+    }
+    if (update)
+    {
+        sd_view_flush(v);
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    esp_err_t ret = sd_view_close(v);
+    return done == VIEW_BENCH_OPS && ret == ESP_OK ? (float)elapsed / done : -1;
+}
+
+/**
+ * @brief 用fseek+fread（更新时再fseek+fwrite）访问同样的下标序列
+ */
+static float run_raw(const char *path, uint32_t elems, bool hot, bool update)
+{
+    FILE *f = fopen(path, update ? "r+" : "r");
+    if (f == NULL)
+    {
+        return -1;
+    }
+    setvbuf(f, NULL, _IONBF, 0);
+    uint32_t rng = 0x12345678;
+    int64_t start = esp_timer_get_time();
+    int done = 0;
+    for (; done < VIEW_BENCH_OPS; done++)
+    {
+        long offset = next_index(&rng, elems, hot) * sizeof(uint32_t);
+        uint32_t value;
+        if (fseek(f, offset, SEEK_SET) != 0 || fread(&value, sizeof(value), 1, f) != 1)
+        {
+            break;
+        }
+        if (update)
+        {
+            value++;
+            if (fseek(f, offset, SEEK_SET) != 0 || fwrite(&value, sizeof(value), 1, f) != 1)
+            {
+                break;
+            }
+        }
+    }
+    if (update)
+    {
+        fsync(fileno(f));
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    fclose(f);
+    return done == VIEW_BENCH_OPS ? (float)elapsed / done : -1;
+}
+
+void sd_view_bench_run(void)
+{
+    sd_bench_params_t params = SD_BENCH_PARAMS_DEFAULT();
+    params.cold_read = false;
+    sd_bench_result_t result;
+    if (sd_bench_write(&params, &result) != ESP_OK)
+    {
+        return;
+    }
+    uint32_t elems = params.file_size / sizeof(uint32_t);
+
+    // 有PSRAM时页缓存放在PSRAM中，否则使用较少的内部DMA内存
+    int npages = 32;
+    uint32_t caps = MALLOC_CAP_SPIRAM;
+    const char *mem = "PSRAM";
+    if (heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM) < (size_t)npages * VIEW_BENCH_PAGE_SIZE)
+    {
+        npages = 16;
+        caps = MALLOC_CAP_DMA;
+        mem = "internal DMA RAM";
+    }
+
+    printf("\nPaged view (%u x %u KB pages in %s, %d ops, hot set %u KB at %d%%):\n", npages,
+           VIEW_BENCH_PAGE_SIZE / 1024, mem, VIEW_BENCH_OPS, VIEW_BENCH_HOT_BYTES / 1024, VIEW_BENCH_HOT_PCT);
+    printf("  %-13s %10s %10s %7s %10s\n", "workload", "view us/op", "raw us/op", "hit%", "writebacks");
+    static const struct
+    {
+        const char *label;
+        bool hot;
+        bool update;
+    } workloads[] = {
+        {"uniform read", false, false},
+        {"hot read", true, false},
+        {"hot update", true, true},
+    };
+    for (size_t w = 0; w < sizeof(workloads) / sizeof(workloads[0]); w++)
+    {
+        sd_view_t v;
+        float view_us = run_view(params.path, elems, workloads[w].hot, workloads[w].update, npages, caps, &v);
+        float raw_us = run_raw(params.path, elems, workloads[w].hot, workloads[w].update);
+        uint32_t lookups = v.hits + v.misses;
+        if (view_us < 0 || raw_us < 0)
+        {
+            printf("  %-13s failed\n", workloads[w].label);
+            continue;
+        }
+        printf("  %-13s %10.1f %10.1f %6.1f%% %10u\n", workloads[w].label, view_us, raw_us,
+               lookups ? v.hits * 100.0f / lookups : 0.0f, (unsigned)v.writebacks);
+    }
+    printf("\n");
+    unlink(params.path);
+}
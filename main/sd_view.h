@@ -0,0 +1,122 @@
+/*
+ * 分页文件视图
+ *
+ * 把卡上文件的一段区域按固定大小的页访问，适合把大文件当作数组处理的分析代码：
+ * sd_view_pin取得某一页在内存中的指针，使用完后sd_view_unpin归还。
+ * 页缓存按LRU淘汰未被钉住的页，被修改过的页在淘汰、sd_view_flush或关闭时写回文件。
+ *
+ * 注意：
+ * - 视图不是线程安全的，只能在一个任务中使用
+ * - 页被钉住期间不会被淘汰，同时钉住的页数不能超过缓存页数
+ * - 最后一页可能不满，超出区域的部分读出为0，写回时忽略
+ *
+ * 本示例代码属于公共领域（或根据您的选择使用CC0许可）。
+ */
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 缓存页
+ */
+typedef struct
+{
+    uint8_t *data;     // 页数据
+    uint32_t page_no;  // 页号（相对视图起点）
+    uint32_t last_use; // 最近一次钉住时的访问计数，用于LRU
+    uint16_t pins;     // 钉住次数
+    bool valid;        // 是否已装入数据
+    bool dirty;        // 是否被修改过
+} sd_view_page_t;
+
+/**
+ * @brief 分页视图
+ */
+typedef struct
+{
+    FILE *f;                // 底层文件
+    bool writable;          // 是否允许写回
+    uint32_t offset;        // 视图在文件中的起始偏移
+    uint32_t length;        // 视图长度
+    size_t page_size;       // 页大小
+    int npages;             // 缓存页数
+    uint8_t *pool;          // 所有页数据的连续内存
+    sd_view_page_t *pages;  // 缓存页
+    uint32_t clock;         // 访问计数
+
+    // 统计信息
+    uint32_t hits;       // 命中次数
+    uint32_t misses;     // 未命中次数（从文件读入）
+    uint32_t writebacks; // 写回次数
+    esp_err_t io_err;    // 第一个读写错误
+} sd_view_t;
+
+/**
+ * @brief 打开文件并映射其中一段区域
+ *
+ * @param v         视图
+ * @param path      文件路径
+ * @param offset    区域起始偏移
+ * @param length    区域长度，0表示到文件末尾
+ * @param page_size 页大小（建议为扇区大小的整数倍）
+ * @param npages    缓存页数
+ * @param writable  是否以读写方式打开并写回脏页
+ * @param caps      页缓存的内存类型，例如MALLOC_CAP_DMA或MALLOC_CAP_SPIRAM
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_INVALID_ARG 参数错误或区域超出文件
+ *  - ESP_ERR_NO_MEM 内存不足
+ *  - ESP_FAIL 文件操作失败
+ */
+esp_err_t sd_view_open(sd_view_t *v, const char *path, uint32_t offset, uint32_t length,
+                       size_t page_size, int npages, bool writable, uint32_t caps);
+
+/**
+ * @brief 视图的总页数
+ */
+uint32_t sd_view_page_count(const sd_view_t *v);
+
+/**
+ * @brief 钉住一页并返回其数据指针
+ *
+ * 页不在缓存中时淘汰最久未使用的未钉住页（必要时先写回）并从文件读入。
+ *
+ * @return 页数据，页号超出范围、所有缓存页都被钉住或读取失败时返回NULL
+ */
+void *sd_view_pin(sd_view_t *v, uint32_t page_no);
+
+/**
+ * @brief 归还sd_view_pin返回的页
+ *
+ * @param data  sd_view_pin返回的指针
+ * @param dirty 调用者是否修改了页内容
+ */
+void sd_view_unpin(sd_view_t *v, void *data, bool dirty);
+
+/**
+ * @brief 写回所有脏页并同步到卡上
+ */
+esp_err_t sd_view_flush(sd_view_t *v);
+
+/**
+ * @brief 写回脏页，关闭文件并释放页缓存
+ *
+ * @return 视图使用期间第一个读写错误，或ESP_OK
+ */
+esp_err_t sd_view_close(sd_view_t *v);
+
+/**
+ * @brief 随机访问测试：对比分页视图与直接fseek+fread的命中率和每次访问的平均延迟
+ */
+void sd_view_bench_run(void);
+
+#ifdef __cplusplus
+}
+#endif